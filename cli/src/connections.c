@@ -327,32 +327,19 @@ show_connection (NMConnection *data, gpointer user_data)
 }
 
 static NMConnection *
-find_connection (GSList *list, const char *filter_type, const char *filter_val)
+find_connection (NMRemoteSettings *settings, const char *filter_type, const char *filter_val)
 {
-	NMSettingConnection *s_con;
-	NMConnection *connection;
-	GSList *iterator;
-	const char *id;
-	const char *uuid;
+	NMRemoteConnection *connection = NULL;
 
-	iterator = list;
-	while (iterator) {
-		connection = NM_CONNECTION (iterator->data);
-		s_con = nm_connection_get_setting_connection (connection);
-		if (s_con) {
-			id = nm_setting_connection_get_id (s_con);
-			uuid = nm_setting_connection_get_uuid (s_con);
-			if (filter_type) {
-				if ((strcmp (filter_type, "id") == 0 && strcmp (filter_val, id) == 0) ||
-				    (strcmp (filter_type, "uuid") == 0 && strcmp (filter_val, uuid) == 0)) {
-					return connection;
-				}
-			}
-		}
-		iterator = g_slist_next (iterator);
-	}
+	if (!settings || !filter_type)
+		return NULL;
 
-	return NULL;
+	if (strcmp (filter_type, "id") == 0)
+		connection = nm_remote_settings_get_connection_by_id (settings, filter_val);
+	else if (strcmp (filter_type, "uuid") == 0)
+		connection = nm_remote_settings_get_connection_by_uuid (settings, filter_val);
+
+	return (NMConnection *) connection;
 }
 
 static NMCResultCode
@@ -411,7 +398,7 @@ do_connections_list (NmCli *nmc, int argc, char **argv)
 				if (!nmc->mode_specified)
 					nmc->multiline_output = TRUE;  /* multiline mode is default for 'con list id|uuid' */
 
-				con = find_connection (nmc->system_connections, selector, *argv);
+				con = find_connection (nmc->system_settings, selector, *argv);
 				if (con) {
 					nmc_connection_detail (con, nmc);
 				}
@@ -1488,7 +1475,7 @@ do_connection_up (NmCli *nmc, int argc, char **argv)
 				goto error;
 			}
 
-			connection = find_connection (nmc->system_connections, selector, *argv);
+			connection = find_connection (nmc->system_settings, selector, *argv);
 
 			if (!connection) {
 				g_string_printf (nmc->return_text, _("Error: Unknown connection: %s."), *argv);
@@ -1643,7 +1630,7 @@ do_connection_down (NmCli *nmc, int argc, char **argv)
 				goto error;
 			}
 
-			connection = find_connection (nmc->system_connections, selector, *argv);
+			connection = find_connection (nmc->system_settings, selector, *argv);
 
 			if (!connection) {
 				g_string_printf (nmc->return_text, _("Error: Unknown connection: %s."), *argv);
@@ -1771,7 +1758,7 @@ do_connection_delete (NmCli *nmc, int argc, char **argv)
 		goto error;
 	}
 
-	connection = find_connection (nmc->system_connections, selector, id);
+	connection = find_connection (nmc->system_settings, selector, id);
 
 	if (!connection) {
 		g_string_printf (nmc->return_text, _("Error: Unknown connection: %s."), id);
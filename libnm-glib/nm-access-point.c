@@ -698,4 +698,7 @@ nm_access_point_class_init (NMAccessPointClass *ap_class)
 						"Strength",
 						0, G_MAXUINT8, 0,
 						G_PARAM_READABLE));
+
+	/* Strength changes with every scan; don't flood listeners */
+	_nm_object_class_throttle_notify (object_class, NM_ACCESS_POINT_STRENGTH);
 }
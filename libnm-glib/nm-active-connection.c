@@ -34,9 +34,11 @@
 #include "nm-glib-compat.h"
 
 static GType _nm_active_connection_type_for_path (DBusGConnection *connection,
-                                                  const char *path);
+                                                  const char *path,
+                                                  GHashTable *snapshot_props);
 static void  _nm_active_connection_type_for_path_async (DBusGConnection *connection,
                                                         const char *path,
+                                                        GHashTable *snapshot_props,
                                                         NMObjectTypeCallbackFunc callback,
                                                         gpointer user_data);
 
@@ -107,13 +109,19 @@ nm_active_connection_new (DBusGConnection *connection, const char *path)
 
 static GType
 _nm_active_connection_type_for_path (DBusGConnection *connection,
-                                     const char *path)
+                                     const char *path,
+                                     GHashTable *snapshot_props)
 {
 	DBusGProxy *proxy;
 	GError *error = NULL;
 	GValue value = {0,};
+	const GValue *cached;
 	GType type;
 
+	cached = snapshot_props ? g_hash_table_lookup (snapshot_props, "Vpn") : NULL;
+	if (cached && G_VALUE_HOLDS_BOOLEAN (cached))
+		return g_value_get_boolean (cached) ? NM_TYPE_VPN_CONNECTION : NM_TYPE_ACTIVE_CONNECTION;
+
 	proxy = dbus_g_proxy_new_for_name (connection,
 	                                   NM_DBUS_SERVICE,
 	                                   path,
@@ -183,11 +191,20 @@ async_got_type (DBusGProxy *proxy, DBusGProxyCall *call, gpointer user_data)
 static void
 _nm_active_connection_type_for_path_async (DBusGConnection *connection,
                                            const char *path,
+                                           GHashTable *snapshot_props,
                                            NMObjectTypeCallbackFunc callback,
                                            gpointer user_data)
 {
 	NMActiveConnectionAsyncData *async_data;
 	DBusGProxy *proxy;
+	const GValue *cached;
+
+	cached = snapshot_props ? g_hash_table_lookup (snapshot_props, "Vpn") : NULL;
+	if (cached && G_VALUE_HOLDS_BOOLEAN (cached)) {
+		callback (g_value_get_boolean (cached) ? NM_TYPE_VPN_CONNECTION : NM_TYPE_ACTIVE_CONNECTION,
+		          user_data);
+		return;
+	}
 
 	async_data = g_slice_new (NMActiveConnectionAsyncData);
 	async_data->connection = connection;
@@ -22,6 +22,7 @@
  */
 
 #include <dbus/dbus-glib.h>
+#include <dbus/dbus-glib-lowlevel.h>
 #include <string.h>
 #include <nm-utils.h>
 
@@ -1521,13 +1522,58 @@ constructed (GObject *object)
 	                  G_CALLBACK (object_creation_failed_cb), NULL);
 }
 
+/* Objects read from the GetObjectTree() reply only get a proxy, and thus a
+ * match rule for their signals, once they are created.  Until then, listen
+ * to all of NetworkManager's signals so that the bus sends the ones emitted
+ * after the reply.  init_sync() creates every object before it returns to
+ * the main loop, so those signals wait in the connection's queue until the
+ * proxies exist.  Async init returns to the main loop in between and
+ * dbus-glib drops signals for objects that have no proxy yet; a filter notes
+ * which objects got any, and they re-read their properties once init is done.
+ */
+#define OBJECT_TREE_MATCH "type='signal',sender='" NM_DBUS_SERVICE "'"
+
+static void
+watch_object_tree_signals (NMClient *client, gboolean watch)
+{
+	DBusConnection *connection;
+
+	connection = dbus_g_connection_get_connection (nm_object_get_connection (NM_OBJECT (client)));
+	if (watch)
+		dbus_bus_add_match (connection, OBJECT_TREE_MATCH, NULL);
+	else
+		dbus_bus_remove_match (connection, OBJECT_TREE_MATCH, NULL);
+}
+
+static void
+set_object_tree (NMClient *client, GHashTable *objects)
+{
+	_nm_object_set_snapshot (NM_OBJECT (client), objects);
+	g_hash_table_unref (objects);
+}
+
 static gboolean
 init_sync (GInitable *initable, GCancellable *cancellable, GError **error)
 {
 	NMClient *client = NM_CLIENT (initable);
 	NMClientPrivate *priv = NM_CLIENT_GET_PRIVATE (client);
+	GHashTable *objects = NULL;
+	gboolean success;
 
-	if (!nm_client_parent_initable_iface->init (initable, cancellable, error))
+	/* Fetch the whole object tree in one call if NM supports it; otherwise
+	 * (or if NM isn't running) each object falls back to GetAll.
+	 */
+	watch_object_tree_signals (client, TRUE);
+	if (dbus_g_proxy_call (priv->client_proxy, "GetObjectTree", NULL,
+	                       G_TYPE_INVALID,
+	                       DBUS_TYPE_G_MAP_OF_MAP_OF_VARIANT, &objects,
+	                       G_TYPE_INVALID))
+		set_object_tree (client, objects);
+
+	success = nm_client_parent_initable_iface->init (initable, cancellable, error);
+	_nm_object_set_snapshot (NM_OBJECT (client), NULL);
+	watch_object_tree_signals (client, FALSE);
+	if (!success)
 		return FALSE;
 
 	if (!dbus_g_proxy_call (priv->bus_proxy,
@@ -1549,8 +1595,67 @@ typedef struct {
 	GSimpleAsyncResult *result;
 	gboolean properties_pending;
 	gboolean permissions_pending;
+
+	/* Paths of the objects NetworkManager sent signals for while the
+	 * object tree was being read.
+	 */
+	GHashTable *signaled_paths;
 } NMClientInitData;
 
+static DBusHandlerResult
+init_async_signal_filter (DBusConnection *connection,
+                          DBusMessage *message,
+                          void *user_data)
+{
+	NMClientInitData *init_data = user_data;
+	const char *path;
+
+	if (dbus_message_get_type (message) == DBUS_MESSAGE_TYPE_SIGNAL) {
+		path = dbus_message_get_path (message);
+		if (path && g_str_has_prefix (path, NM_DBUS_PATH))
+			g_hash_table_insert (init_data->signaled_paths, g_strdup (path), NULL);
+	}
+	return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+}
+
+static void
+init_async_watch_signals (NMClientInitData *init_data, gboolean watch)
+{
+	DBusConnection *connection;
+
+	connection = dbus_g_connection_get_connection (nm_object_get_connection (NM_OBJECT (init_data->client)));
+	if (watch) {
+		init_data->signaled_paths = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+		dbus_connection_add_filter (connection, init_async_signal_filter, init_data, NULL);
+	} else
+		dbus_connection_remove_filter (connection, init_async_signal_filter, init_data);
+	watch_object_tree_signals (init_data->client, watch);
+}
+
+/* Objects created after NetworkManager sent them a signal may have missed
+ * it; have them re-read their properties.
+ */
+static void
+init_async_reload_signaled (NMClientInitData *init_data)
+{
+	GHashTableIter iter;
+	gpointer path;
+	NMObject *object;
+
+	g_hash_table_iter_init (&iter, init_data->signaled_paths);
+	while (g_hash_table_iter_next (&iter, &path, NULL)) {
+		object = _nm_object_cache_get (path);
+		if (!object)
+			continue;
+		if (object != NM_OBJECT (init_data->client))
+			_nm_object_reload_properties_async (object, NULL, NULL);
+		g_object_unref (object);
+	}
+
+	g_hash_table_destroy (init_data->signaled_paths);
+	init_data->signaled_paths = NULL;
+}
+
 static void
 init_async_complete (NMClientInitData *init_data)
 {
@@ -1585,13 +1690,37 @@ init_async_got_properties (GObject *source, GAsyncResult *result, gpointer user_
 	NMClientInitData *init_data = user_data;
 	GError *error = NULL;
 
+	_nm_object_set_snapshot (NM_OBJECT (init_data->client), NULL);
+	init_async_watch_signals (init_data, FALSE);
+
 	if (!nm_client_parent_async_initable_iface->init_finish (G_ASYNC_INITABLE (source), result, &error))
 		g_simple_async_result_take_error (init_data->result, error);
+	init_async_reload_signaled (init_data);
 
 	init_data->properties_pending = FALSE;
 	init_async_complete (init_data);
 }
 
+static void
+init_async_got_object_tree (DBusGProxy *proxy, DBusGProxyCall *call,
+                            gpointer user_data)
+{
+	NMClientInitData *init_data = user_data;
+	GHashTable *objects = NULL;
+
+	/* On error (eg, an older NM without GetObjectTree) every object just
+	 * reads its own properties.
+	 */
+	if (dbus_g_proxy_end_call (proxy, call, NULL,
+	                           DBUS_TYPE_G_MAP_OF_MAP_OF_VARIANT, &objects,
+	                           G_TYPE_INVALID))
+		set_object_tree (init_data->client, objects);
+
+	nm_client_parent_async_initable_iface->init_async (G_ASYNC_INITABLE (init_data->client),
+	                                                   G_PRIORITY_DEFAULT, NULL, /* FIXME cancellable */
+	                                                   init_async_got_properties, init_data);
+}
+
 static void
 init_async_got_manager_running (DBusGProxy *proxy, DBusGProxyCall *call,
                                 gpointer user_data)
@@ -1613,9 +1742,10 @@ init_async_got_manager_running (DBusGProxy *proxy, DBusGProxyCall *call,
 		return;
 	}
 
-	nm_client_parent_async_initable_iface->init_async (G_ASYNC_INITABLE (init_data->client),
-	                                                   G_PRIORITY_DEFAULT, NULL, /* FIXME cancellable */
-	                                                   init_async_got_properties, init_data);
+	init_async_watch_signals (init_data, TRUE);
+	dbus_g_proxy_begin_call (priv->client_proxy, "GetObjectTree",
+	                         init_async_got_object_tree, init_data, NULL,
+	                         G_TYPE_INVALID);
 	init_data->properties_pending = TRUE;
 
 	dbus_g_proxy_begin_call (priv->client_proxy, "GetPermissions",
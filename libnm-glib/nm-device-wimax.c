@@ -762,4 +762,9 @@ nm_device_wimax_class_init (NMDeviceWimaxClass *wimax_class)
 				    g_cclosure_marshal_VOID__OBJECT,
 				    G_TYPE_NONE, 1,
 				    G_TYPE_OBJECT);
+
+	/* Link quality is polled and changes constantly */
+	_nm_object_class_throttle_notify (object_class, NM_DEVICE_WIMAX_RSSI);
+	_nm_object_class_throttle_notify (object_class, NM_DEVICE_WIMAX_CINR);
+	_nm_object_class_throttle_notify (object_class, NM_DEVICE_WIMAX_TX_POWER);
 }
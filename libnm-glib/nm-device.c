@@ -46,9 +46,11 @@
 #include "nm-glib-compat.h"
 
 static GType _nm_device_type_for_path (DBusGConnection *connection,
-                                       const char *path);
+                                       const char *path,
+                                       GHashTable *snapshot_props);
 static void _nm_device_type_for_path_async (DBusGConnection *connection,
                                             const char *path,
+                                            GHashTable *snapshot_props,
                                             NMObjectTypeCallbackFunc callback,
                                             gpointer user_data);
 
@@ -790,13 +792,19 @@ _nm_device_set_device_type (NMDevice *device, NMDeviceType dtype)
 
 static GType
 _nm_device_type_for_path (DBusGConnection *connection,
-                          const char *path)
+                          const char *path,
+                          GHashTable *snapshot_props)
 {
 	DBusGProxy *proxy;
 	GError *err = NULL;
 	GValue value = {0,};
+	const GValue *cached;
 	NMDeviceType nm_dtype;
 
+	cached = snapshot_props ? g_hash_table_lookup (snapshot_props, "DeviceType") : NULL;
+	if (cached && G_VALUE_HOLDS_UINT (cached))
+		return _nm_device_gtype_from_dtype (g_value_get_uint (cached));
+
 	proxy = dbus_g_proxy_new_for_name (connection,
 									   NM_DBUS_SERVICE,
 									   path,
@@ -840,7 +848,7 @@ nm_device_new (DBusGConnection *connection, const char *path)
 	g_return_val_if_fail (connection != NULL, NULL);
 	g_return_val_if_fail (path != NULL, NULL);
 
-	dtype = _nm_device_type_for_path (connection, path);
+	dtype = _nm_device_type_for_path (connection, path, NULL);
 	if (dtype == G_TYPE_INVALID)
 		return NULL;
 
@@ -888,11 +896,19 @@ async_got_type (DBusGProxy *proxy, DBusGProxyCall *call, gpointer user_data)
 static void
 _nm_device_type_for_path_async (DBusGConnection *connection,
                                 const char *path,
+                                GHashTable *snapshot_props,
                                 NMObjectTypeCallbackFunc callback,
                                 gpointer user_data)
 {
 	NMDeviceAsyncData *async_data;
 	DBusGProxy *proxy;
+	const GValue *cached;
+
+	cached = snapshot_props ? g_hash_table_lookup (snapshot_props, "DeviceType") : NULL;
+	if (cached && G_VALUE_HOLDS_UINT (cached)) {
+		callback (_nm_device_gtype_from_dtype (g_value_get_uint (cached)), user_data);
+		return;
+	}
 
 	async_data = g_slice_new (NMDeviceAsyncData);
 	async_data->connection = connection;
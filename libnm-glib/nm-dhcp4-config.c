@@ -81,7 +81,7 @@ register_properties (NMDHCP4Config *config)
 {
 	NMDHCP4ConfigPrivate *priv = NM_DHCP4_CONFIG_GET_PRIVATE (config);
 	const NMPropertiesInfo property_info[] = {
-		{ NM_DHCP4_CONFIG_OPTIONS,   &priv->options, demarshal_dhcp4_options },
+		{ NM_DHCP4_CONFIG_OPTIONS,   &priv->options, demarshal_dhcp4_options, G_TYPE_INVALID, TRUE },
 		{ NULL },
 	};
 
@@ -205,10 +205,14 @@ nm_dhcp4_config_new (DBusGConnection *connection, const char *object_path)
 GHashTable *
 nm_dhcp4_config_get_options (NMDHCP4Config *config)
 {
+	NMDHCP4ConfigPrivate *priv;
+
 	g_return_val_if_fail (NM_IS_DHCP4_CONFIG (config), NULL);
 
 	_nm_object_ensure_inited (NM_OBJECT (config));
-	return NM_DHCP4_CONFIG_GET_PRIVATE (config)->options;
+	priv = NM_DHCP4_CONFIG_GET_PRIVATE (config);
+	_nm_object_ensure_property (NM_OBJECT (config), &priv->options);
+	return priv->options;
 }
 
 /**
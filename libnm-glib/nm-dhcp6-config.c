@@ -81,7 +81,7 @@ register_properties (NMDHCP6Config *config)
 {
 	NMDHCP6ConfigPrivate *priv = NM_DHCP6_CONFIG_GET_PRIVATE (config);
 	const NMPropertiesInfo property_info[] = {
-		{ NM_DHCP6_CONFIG_OPTIONS,   &priv->options, demarshal_dhcp6_options },
+		{ NM_DHCP6_CONFIG_OPTIONS,   &priv->options, demarshal_dhcp6_options, G_TYPE_INVALID, TRUE },
 		{ NULL },
 	};
 
@@ -205,10 +205,14 @@ nm_dhcp6_config_new (DBusGConnection *connection, const char *object_path)
 GHashTable *
 nm_dhcp6_config_get_options (NMDHCP6Config *config)
 {
+	NMDHCP6ConfigPrivate *priv;
+
 	g_return_val_if_fail (NM_IS_DHCP6_CONFIG (config), NULL);
 
 	_nm_object_ensure_inited (NM_OBJECT (config));
-	return NM_DHCP6_CONFIG_GET_PRIVATE (config)->options;
+	priv = NM_DHCP6_CONFIG_GET_PRIVATE (config);
+	_nm_object_ensure_property (NM_OBJECT (config), &priv->options);
+	return priv->options;
 }
 
 /**
@@ -119,11 +119,11 @@ register_properties (NMIP4Config *config)
 {
 	NMIP4ConfigPrivate *priv = NM_IP4_CONFIG_GET_PRIVATE (config);
 	const NMPropertiesInfo property_info[] = {
-		{ NM_IP4_CONFIG_ADDRESSES,    &priv->addresses, demarshal_ip4_address_array },
-		{ NM_IP4_CONFIG_NAMESERVERS,  &priv->nameservers, demarshal_ip4_array },
-		{ NM_IP4_CONFIG_DOMAINS,      &priv->domains, demarshal_domains },
-		{ NM_IP4_CONFIG_ROUTES,       &priv->routes, demarshal_ip4_routes_array },
-		{ NM_IP4_CONFIG_WINS_SERVERS, &priv->wins, demarshal_ip4_array },
+		{ NM_IP4_CONFIG_ADDRESSES,    &priv->addresses, demarshal_ip4_address_array, G_TYPE_INVALID, TRUE },
+		{ NM_IP4_CONFIG_NAMESERVERS,  &priv->nameservers, demarshal_ip4_array, G_TYPE_INVALID, TRUE },
+		{ NM_IP4_CONFIG_DOMAINS,      &priv->domains, demarshal_domains, G_TYPE_INVALID, TRUE },
+		{ NM_IP4_CONFIG_ROUTES,       &priv->routes, demarshal_ip4_routes_array, G_TYPE_INVALID, TRUE },
+		{ NM_IP4_CONFIG_WINS_SERVERS, &priv->wins, demarshal_ip4_array, G_TYPE_INVALID, TRUE },
 		{ NULL },
 	};
 
@@ -191,6 +191,7 @@ get_property (GObject *object,
 
 	switch (prop_id) {
 	case PROP_ADDRESSES:
+		_nm_object_ensure_property (NM_OBJECT (object), &priv->addresses);
 		nm_utils_ip4_addresses_to_gvalue (priv->addresses, value);
 		break;
 	case PROP_NAMESERVERS:
@@ -200,6 +201,7 @@ get_property (GObject *object,
 		g_value_set_boxed (value, nm_ip4_config_get_domains (self));
 		break;
 	case PROP_ROUTES:
+		_nm_object_ensure_property (NM_OBJECT (object), &priv->routes);
 		nm_utils_ip4_routes_to_gvalue (priv->routes, value);
 		break;
 	case PROP_WINS_SERVERS:
@@ -319,10 +321,14 @@ nm_ip4_config_new (DBusGConnection *connection, const char *object_path)
 const GSList *
 nm_ip4_config_get_addresses (NMIP4Config *config)
 {
+	NMIP4ConfigPrivate *priv;
+
 	g_return_val_if_fail (NM_IS_IP4_CONFIG (config), NULL);
 
 	_nm_object_ensure_inited (NM_OBJECT (config));
-	return NM_IP4_CONFIG_GET_PRIVATE (config)->addresses;
+	priv = NM_IP4_CONFIG_GET_PRIVATE (config);
+	_nm_object_ensure_property (NM_OBJECT (config), &priv->addresses);
+	return priv->addresses;
 }
 
 /**
@@ -337,10 +343,14 @@ nm_ip4_config_get_addresses (NMIP4Config *config)
 const GArray *
 nm_ip4_config_get_nameservers (NMIP4Config *config)
 {
+	NMIP4ConfigPrivate *priv;
+
 	g_return_val_if_fail (NM_IS_IP4_CONFIG (config), NULL);
 
 	_nm_object_ensure_inited (NM_OBJECT (config));
-	return NM_IP4_CONFIG_GET_PRIVATE (config)->nameservers;
+	priv = NM_IP4_CONFIG_GET_PRIVATE (config);
+	_nm_object_ensure_property (NM_OBJECT (config), &priv->nameservers);
+	return priv->nameservers;
 }
 
 /**
@@ -355,10 +365,14 @@ nm_ip4_config_get_nameservers (NMIP4Config *config)
 const GPtrArray *
 nm_ip4_config_get_domains (NMIP4Config *config)
 {
+	NMIP4ConfigPrivate *priv;
+
 	g_return_val_if_fail (NM_IS_IP4_CONFIG (config), NULL);
 
 	_nm_object_ensure_inited (NM_OBJECT (config));
-	return handle_ptr_array_return (NM_IP4_CONFIG_GET_PRIVATE (config)->domains);
+	priv = NM_IP4_CONFIG_GET_PRIVATE (config);
+	_nm_object_ensure_property (NM_OBJECT (config), &priv->domains);
+	return handle_ptr_array_return (priv->domains);
 }
 
 /**
@@ -373,10 +387,14 @@ nm_ip4_config_get_domains (NMIP4Config *config)
 const GArray *
 nm_ip4_config_get_wins_servers (NMIP4Config *config)
 {
+	NMIP4ConfigPrivate *priv;
+
 	g_return_val_if_fail (NM_IS_IP4_CONFIG (config), NULL);
 
 	_nm_object_ensure_inited (NM_OBJECT (config));
-	return NM_IP4_CONFIG_GET_PRIVATE (config)->wins;
+	priv = NM_IP4_CONFIG_GET_PRIVATE (config);
+	_nm_object_ensure_property (NM_OBJECT (config), &priv->wins);
+	return priv->wins;
 }
 
 /**
@@ -392,9 +410,13 @@ nm_ip4_config_get_wins_servers (NMIP4Config *config)
 const GSList *
 nm_ip4_config_get_routes (NMIP4Config *config)
 {
+	NMIP4ConfigPrivate *priv;
+
 	g_return_val_if_fail (NM_IS_IP4_CONFIG (config), NULL);
 
 	_nm_object_ensure_inited (NM_OBJECT (config));
-	return NM_IP4_CONFIG_GET_PRIVATE (config)->routes;
+	priv = NM_IP4_CONFIG_GET_PRIVATE (config);
+	_nm_object_ensure_property (NM_OBJECT (config), &priv->routes);
+	return priv->routes;
 }
 
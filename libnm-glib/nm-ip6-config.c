@@ -128,10 +128,10 @@ register_properties (NMIP6Config *config)
 {
 	NMIP6ConfigPrivate *priv = NM_IP6_CONFIG_GET_PRIVATE (config);
 	const NMPropertiesInfo property_info[] = {
-		{ NM_IP6_CONFIG_ADDRESSES,    &priv->addresses, demarshal_ip6_address_array },
-		{ NM_IP6_CONFIG_NAMESERVERS,  &priv->nameservers, demarshal_ip6_nameserver_array },
-		{ NM_IP6_CONFIG_DOMAINS,      &priv->domains, demarshal_domains },
-		{ NM_IP6_CONFIG_ROUTES,       &priv->routes, demarshal_ip6_routes_array },
+		{ NM_IP6_CONFIG_ADDRESSES,    &priv->addresses, demarshal_ip6_address_array, G_TYPE_INVALID, TRUE },
+		{ NM_IP6_CONFIG_NAMESERVERS,  &priv->nameservers, demarshal_ip6_nameserver_array, G_TYPE_INVALID, TRUE },
+		{ NM_IP6_CONFIG_DOMAINS,      &priv->domains, demarshal_domains, G_TYPE_INVALID, TRUE },
+		{ NM_IP6_CONFIG_ROUTES,       &priv->routes, demarshal_ip6_routes_array, G_TYPE_INVALID, TRUE },
 		{ NULL },
 	};
 
@@ -153,10 +153,14 @@ register_properties (NMIP6Config *config)
 const GSList *
 nm_ip6_config_get_addresses (NMIP6Config *config)
 {
+	NMIP6ConfigPrivate *priv;
+
 	g_return_val_if_fail (NM_IS_IP6_CONFIG (config), NULL);
 
 	_nm_object_ensure_inited (NM_OBJECT (config));
-	return NM_IP6_CONFIG_GET_PRIVATE (config)->addresses;
+	priv = NM_IP6_CONFIG_GET_PRIVATE (config);
+	_nm_object_ensure_property (NM_OBJECT (config), &priv->addresses);
+	return priv->addresses;
 }
 
 /* FIXME: like in libnm_util, in6_addr is not introspectable, so skipping here */
@@ -173,10 +177,14 @@ nm_ip6_config_get_addresses (NMIP6Config *config)
 const GSList *
 nm_ip6_config_get_nameservers (NMIP6Config *config)
 {
+	NMIP6ConfigPrivate *priv;
+
 	g_return_val_if_fail (NM_IS_IP6_CONFIG (config), NULL);
 
 	_nm_object_ensure_inited (NM_OBJECT (config));
-	return NM_IP6_CONFIG_GET_PRIVATE (config)->nameservers;
+	priv = NM_IP6_CONFIG_GET_PRIVATE (config);
+	_nm_object_ensure_property (NM_OBJECT (config), &priv->nameservers);
+	return priv->nameservers;
 }
 
 /**
@@ -191,10 +199,14 @@ nm_ip6_config_get_nameservers (NMIP6Config *config)
 const GPtrArray *
 nm_ip6_config_get_domains (NMIP6Config *config)
 {
+	NMIP6ConfigPrivate *priv;
+
 	g_return_val_if_fail (NM_IS_IP6_CONFIG (config), NULL);
 
 	_nm_object_ensure_inited (NM_OBJECT (config));
-	return handle_ptr_array_return (NM_IP6_CONFIG_GET_PRIVATE (config)->domains);
+	priv = NM_IP6_CONFIG_GET_PRIVATE (config);
+	_nm_object_ensure_property (NM_OBJECT (config), &priv->domains);
+	return handle_ptr_array_return (priv->domains);
 }
 
 /**
@@ -210,10 +222,14 @@ nm_ip6_config_get_domains (NMIP6Config *config)
 const GSList *
 nm_ip6_config_get_routes (NMIP6Config *config)
 {
+	NMIP6ConfigPrivate *priv;
+
 	g_return_val_if_fail (NM_IS_IP6_CONFIG (config), NULL);
 
 	_nm_object_ensure_inited (NM_OBJECT (config));
-	return NM_IP6_CONFIG_GET_PRIVATE (config)->routes;
+	priv = NM_IP6_CONFIG_GET_PRIVATE (config);
+	_nm_object_ensure_property (NM_OBJECT (config), &priv->routes);
+	return priv->routes;
 }
 
 static void
@@ -272,6 +288,7 @@ get_property (GObject *object,
 
 	switch (prop_id) {
 	case PROP_ADDRESSES:
+		_nm_object_ensure_property (NM_OBJECT (object), &priv->addresses);
 		nm_utils_ip6_addresses_to_gvalue (priv->addresses, value);
 		break;
 	case PROP_NAMESERVERS:
@@ -281,6 +298,7 @@ get_property (GObject *object,
 		g_value_set_boxed (value, nm_ip6_config_get_domains (self));
 		break;
 	case PROP_ROUTES:
+		_nm_object_ensure_property (NM_OBJECT (object), &priv->routes);
 		nm_utils_ip6_routes_to_gvalue (priv->routes, value);
 		break;
 	default:
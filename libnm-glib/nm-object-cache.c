@@ -25,67 +25,148 @@
 #include "nm-object-cache.h"
 #include "nm-object.h"
 
+/* Objects are keyed by a copy of their path that the cache owns and frees
+ * with the entry.  Each entry records the generation of its bus connection
+ * at the time it was added; _nm_object_cache_clear() just bumps the
+ * generation, and entries from older generations are treated as misses and
+ * dropped when they are next seen.
+ */
+typedef struct {
+	NMObject *object;
+	DBusGConnection *connection;
+	guint generation;
+} CacheEntry;
+
+/* Attached to each cached object; removes its entry when the object dies */
+typedef struct {
+	char *path;
+	NMObject *object;
+} CacheTag;
+
 static GHashTable *cache = NULL;
+static GHashTable *generations = NULL;
+static NMObjectCacheStats stats;
+
+static void
+cache_entry_free (CacheEntry *entry)
+{
+	g_slice_free (CacheEntry, entry);
+}
 
 static void
 _init_cache (void)
 {
-	if (G_UNLIKELY (cache == NULL))
-		cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	if (G_UNLIKELY (cache == NULL)) {
+		cache = g_hash_table_new_full (g_str_hash, g_str_equal,
+		                               g_free, (GDestroyNotify) cache_entry_free);
+		generations = g_hash_table_new (g_direct_hash, g_direct_equal);
+	}
+}
+
+static guint
+get_generation (DBusGConnection *connection)
+{
+	return GPOINTER_TO_UINT (g_hash_table_lookup (generations, connection));
 }
 
 static void
-_nm_object_cache_remove_by_path (char *path)
+_nm_object_cache_remove_by_tag (CacheTag *tag)
 {
+	CacheEntry *entry;
+
 	_init_cache ();
-	g_hash_table_remove (cache, path);
-	g_free (path);
+
+	/* A newer object may have taken over the path since this one was cached */
+	entry = g_hash_table_lookup (cache, tag->path);
+	if (entry && entry->object == tag->object) {
+		g_hash_table_remove (cache, tag->path);
+		stats.evictions++;
+	}
+	g_free (tag->path);
+	g_slice_free (CacheTag, tag);
 }
 
 void
 _nm_object_cache_add (NMObject *object)
 {
-	char *path;
+	CacheEntry *entry;
+	CacheTag *tag;
+	const char *path;
 
 	_init_cache ();
-	path = g_strdup (nm_object_get_path (object));
-	g_hash_table_insert (cache, path, object);
+	path = nm_object_get_path (object);
+
+	entry = g_slice_new (CacheEntry);
+	entry->object = object;
+	entry->connection = nm_object_get_connection (object);
+	entry->generation = get_generation (entry->connection);
+	g_hash_table_replace (cache, g_strdup (path), entry);
+
+	tag = g_slice_new (CacheTag);
+	tag->path = g_strdup (path);
+	tag->object = object;
 	g_object_set_data_full (G_OBJECT (object), "nm-object-cache-tag",
-	                        g_strdup (path), (GDestroyNotify) _nm_object_cache_remove_by_path);
+	                        tag, (GDestroyNotify) _nm_object_cache_remove_by_tag);
 }
 
 NMObject *
 _nm_object_cache_get (const char *path)
 {
-	NMObject *object;
+	CacheEntry *entry = NULL;
 
 	_init_cache ();
-	object = g_hash_table_lookup (cache, path);
-	return object ? g_object_ref (object) : NULL;
+
+	if (path)
+		entry = g_hash_table_lookup (cache, path);
+
+	if (entry && entry->generation != get_generation (entry->connection)) {
+		/* Left over from before the last _nm_object_cache_clear() */
+		g_hash_table_remove (cache, path);
+		stats.stale++;
+		entry = NULL;
+	}
+
+	if (!entry) {
+		stats.misses++;
+		return NULL;
+	}
+
+	stats.hits++;
+	return g_object_ref (entry->object);
 }
 
 void
 _nm_object_cache_clear (NMObject *except)
 {
-	GHashTableIter iter;
-	NMObject *obj;
-	const char *path;
-	char *foo;
+	DBusGConnection *connection;
+	CacheEntry *entry;
+	guint generation;
+
+	g_return_if_fail (NM_IS_OBJECT (except));
 
 	_init_cache ();
-	g_hash_table_iter_init (&iter, cache);
-	while (g_hash_table_iter_next (&iter, (gpointer) &path, (gpointer) &obj)) {
-		if (obj != except) {
-			/* Remove the callback so that if the object isn't yet released
-			 * by a client, when it does finally get unrefed, it won't trigger
-			 * the cache removal for a new object with the same path as the
-			 * one being released.
-			 */
-			foo = g_object_steal_data (G_OBJECT (obj), "nm-object-cache-tag");
-			g_free (foo);
-
-			g_hash_table_iter_remove (&iter);
-		}
-	}
+
+	connection = nm_object_get_connection (except);
+	generation = get_generation (connection) + 1;
+	g_hash_table_insert (generations, connection, GUINT_TO_POINTER (generation));
+
+	entry = g_hash_table_lookup (cache, nm_object_get_path (except));
+	if (entry && entry->object == except)
+		entry->generation = generation;
+}
+
+void
+_nm_object_cache_get_stats (NMObjectCacheStats *out_stats)
+{
+	g_return_if_fail (out_stats != NULL);
+
+	_init_cache ();
+	*out_stats = stats;
+	out_stats->size = g_hash_table_size (cache);
 }
 
+void
+_nm_object_cache_reset_stats (void)
+{
+	memset (&stats, 0, sizeof (stats));
+}
@@ -34,6 +34,20 @@ NMObject *_nm_object_cache_get (const char *path);
 void _nm_object_cache_add (NMObject *object);
 void _nm_object_cache_clear (NMObject *except);
 
+/* Lookup counters, for profiling how clients use the cache; used by the
+ * tests and bench-nm-client.
+ */
+typedef struct {
+	guint hits;
+	guint misses;
+	guint stale;   /* lookups that found an object invalidated by a clear */
+	guint evictions; /* entries removed because their object was destroyed */
+	guint size;    /* entries currently in the cache, including stale ones */
+} NMObjectCacheStats;
+
+void _nm_object_cache_get_stats (NMObjectCacheStats *stats);
+void _nm_object_cache_reset_stats (void);
+
 G_END_DECLS
 
 #endif /* NM_OBJECT_CACHE_H */
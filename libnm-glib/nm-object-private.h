@@ -37,6 +37,11 @@ typedef struct {
 	gpointer field;
 	PropertyMarshalFunc func;
 	GType object_type;
+
+	/* Keep the raw D-Bus value and demarshal it on first access; getters
+	 * of lazy properties must call _nm_object_ensure_property().
+	 */
+	gboolean lazy;
 } NMPropertiesInfo;
 
 
@@ -44,6 +49,8 @@ void _nm_object_register_properties (NMObject *object,
 									 DBusGProxy *proxy,
 									 const NMPropertiesInfo *info);
 
+void _nm_object_ensure_property (NMObject *object, gpointer field);
+
 gboolean _nm_object_reload_properties (NMObject *object, GError **error);
 
 void     _nm_object_reload_properties_async  (NMObject *object,
@@ -64,10 +71,21 @@ void _nm_object_register_pseudo_property (NMObject *object,
 void _nm_object_reload_pseudo_property   (NMObject *object,
                                           const char *name);
 
-void _nm_object_queue_notify (NMObject *object, const char *property);
+void _nm_object_queue_notify       (NMObject *object, const char *property);
+void _nm_object_queue_notify_pspec (NMObject *object, GParamSpec *pspec);
+
+/* Coalesces notifications for a frequently changing property of the class */
+void _nm_object_class_throttle_notify (GObjectClass *object_class, const char *property);
+
+void _nm_object_set_snapshot (NMObject *object, GHashTable *objects);
 
 void _nm_object_suppress_property_updates (NMObject *object, gboolean suppress);
 
+/* For tests; the properties' values may be moved out of @properties */
+void  _nm_object_process_properties_changed  (NMObject *object, GHashTable *properties);
+void  _nm_object_set_lazy_properties_enabled (gboolean enabled);
+guint _nm_object_get_lazy_demarshal_count    (void);
+
 /* DBus property accessors */
 
 void _nm_object_reload_property (NMObject *object,
@@ -88,10 +106,12 @@ handle_ptr_array_return (GPtrArray *array)
 	return array;
 }
 
-/* object demarshalling support */
-typedef GType (*NMObjectTypeFunc) (DBusGConnection *, const char *);
+/* object demarshalling support; type functions are passed the object's
+ * properties from the GetObjectTree() snapshot, or NULL if there are none.
+ */
+typedef GType (*NMObjectTypeFunc) (DBusGConnection *, const char *, GHashTable *);
 typedef void (*NMObjectTypeCallbackFunc) (GType, gpointer);
-typedef void (*NMObjectTypeAsyncFunc) (DBusGConnection *, const char *, NMObjectTypeCallbackFunc, gpointer);
+typedef void (*NMObjectTypeAsyncFunc) (DBusGConnection *, const char *, GHashTable *, NMObjectTypeCallbackFunc, gpointer);
 
 void _nm_object_register_type_func (GType base_type, NMObjectTypeFunc type_func,
                                     NMObjectTypeAsyncFunc type_async_func);
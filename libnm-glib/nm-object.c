@@ -47,15 +47,37 @@ G_DEFINE_ABSTRACT_TYPE_WITH_CODE (NMObject, nm_object, G_TYPE_OBJECT,
 
 static GHashTable *type_funcs, *type_async_funcs;
 
+/* Property metadata is shared by all instances of a type; the field that
+ * stores the value is located by its offset from the instance pointer, which
+ * is constant for a given instance type.  An offset of 0 (the GTypeInstance
+ * header) means the property is known but its changes aren't tracked.
+ */
 typedef struct {
 	PropertyMarshalFunc func;
 	GType object_type;
+	gboolean lazy;
 
-	gpointer field;
+	gssize field_offset;
 } PropertyInfo;
 
+#define PROPERTY_FIELD(object, pi) ((gpointer) (((char *) (object)) + (pi)->field_offset))
+
+static GQuark property_tables_quark;
+
 static void reload_complete (NMObject *object);
 
+/* Undemarshalled value of a lazy property */
+typedef struct {
+	GParamSpec *pspec;
+	GValue value;
+} LazyValue;
+
+/* Test hooks: lazy properties can be turned off to compare against the
+ * eager path, and demarshals done on first access are counted.
+ */
+static gboolean lazy_disabled;
+static guint lazy_demarshals;
+
 typedef struct {
 	PropertyInfo pi;
 
@@ -77,8 +99,30 @@ typedef struct {
 	NMObject *parent;
 	gboolean suppress_property_updates;
 
-	GSList *notify_props;
+	/* Object path -> a{sv} properties, from NetworkManager's GetObjectTree().
+	 * Shared with the objects created while this one reads its properties,
+	 * and dropped once it has.
+	 */
+	GHashTable *snapshot;
+
+	/* PropertyInfo -> LazyValue, for lazy properties changed since they
+	 * were last read.  While demarshalling one of them the notification it
+	 * would queue is suppressed, since it was queued when the value arrived.
+	 */
+	GHashTable *lazy_values;
+	gboolean demarshalling_lazy;
+
+	/* Queued notifications, as GParamSpecs in queue order; notify_spare is
+	 * swapped in while a batch is being emitted.  notify_pending holds every
+	 * queued or throttled GParamSpec so queueing can be deduplicated in O(1).
+	 */
+	GPtrArray *notify_props;
+	GPtrArray *notify_spare;
+	GHashTable *notify_pending;
 	guint32 notify_id;
+
+	GPtrArray *throttled_props;
+	guint throttle_id;
 	gboolean inited;
 
 	GSList *reload_results;
@@ -220,17 +264,29 @@ dispose (GObject *object)
 		g_source_remove (priv->notify_id);
 		priv->notify_id = 0;
 	}
+	if (priv->throttle_id) {
+		g_source_remove (priv->throttle_id);
+		priv->throttle_id = 0;
+	}
 
-	g_slist_foreach (priv->notify_props, (GFunc) g_free, NULL);
-	g_slist_free (priv->notify_props);
-	priv->notify_props = NULL;
+	if (priv->notify_props) {
+		g_ptr_array_free (priv->notify_props, TRUE);
+		g_ptr_array_free (priv->notify_spare, TRUE);
+		g_ptr_array_free (priv->throttled_props, TRUE);
+		g_hash_table_destroy (priv->notify_pending);
+		priv->notify_props = NULL;
+	}
 
-	g_slist_foreach (priv->property_interfaces, (GFunc) g_free, NULL);
 	g_slist_free (priv->property_interfaces);
 	priv->property_interfaces = NULL;
 
 	g_clear_object (&priv->properties_proxy);
 
+	if (priv->snapshot) {
+		g_hash_table_unref (priv->snapshot);
+		priv->snapshot = NULL;
+	}
+
 	if (priv->connection) {
 		dbus_g_connection_unref (priv->connection);
 		priv->connection = NULL;
@@ -244,12 +300,13 @@ finalize (GObject *object)
 {
 	NMObjectPrivate *priv = NM_OBJECT_GET_PRIVATE (object);
 
-	g_slist_foreach (priv->property_tables, (GFunc) g_hash_table_destroy, NULL);
 	g_slist_free (priv->property_tables);
 	g_free (priv->path);
 
 	if (priv->pseudo_properties)
 		g_hash_table_destroy (priv->pseudo_properties);
+	if (priv->lazy_values)
+		g_hash_table_destroy (priv->lazy_values);
 
 	G_OBJECT_CLASS (nm_object_parent_class)->finalize (object);
 }
@@ -416,54 +473,145 @@ nm_object_get_path (NMObject *object)
 	return NM_OBJECT_GET_PRIVATE (object)->path;
 }
 
+/* Notifications for throttled properties are emitted at most once per
+ * NOTIFY_THROTTLE_MS for each object; changes in between are coalesced.
+ */
+#define NOTIFY_THROTTLE_MS 500
+
+static GQuark notify_throttle_quark;
+
+static void
+emit_notifies (NMObject *object, GPtrArray *props)
+{
+	NMObjectPrivate *priv = NM_OBJECT_GET_PRIVATE (object);
+	guint i;
+
+	for (i = 0; i < props->len; i++)
+		g_hash_table_remove (priv->notify_pending, props->pdata[i]);
+
+	for (i = 0; i < props->len; i++)
+		g_object_notify_by_pspec (G_OBJECT (object), props->pdata[i]);
+
+	g_ptr_array_set_size (props, 0);
+}
+
 static gboolean
 deferred_notify_cb (gpointer data)
 {
 	NMObject *object = NM_OBJECT (data);
 	NMObjectPrivate *priv = NM_OBJECT_GET_PRIVATE (object);
-	GSList *props, *iter;
+	GPtrArray *props;
 
 	priv->notify_id = 0;
 
-	/* Clear priv->notify_props early so that an NMObject subclass that
+	/* Swap out priv->notify_props early so that an NMObject subclass that
 	 * listens to property changes can queue up other property changes
 	 * during the g_object_notify() call separately from the property
 	 * list we're iterating.
 	 */
-	props = g_slist_reverse (priv->notify_props);
-	priv->notify_props = NULL;
+	props = priv->notify_props;
+	priv->notify_props = priv->notify_spare;
+	priv->notify_spare = props;
 
-	for (iter = props; iter; iter = g_slist_next (iter)) {
-		g_object_notify (G_OBJECT (object), (const char *) iter->data);
-		g_free (iter->data);
-	}
-	g_slist_free (props);
+	g_object_ref (object);
+	emit_notifies (object, props);
+	g_object_unref (object);
 	return FALSE;
 }
 
+static void
+add_to_notify_props (gpointer pspec, gpointer notify_props)
+{
+	g_ptr_array_add (notify_props, pspec);
+}
+
+static gboolean
+throttle_cb (gpointer data)
+{
+	NMObject *object = NM_OBJECT (data);
+	NMObjectPrivate *priv = NM_OBJECT_GET_PRIVATE (object);
+
+	/* Nothing changed during the last interval; the next change can be
+	 * emitted right away.
+	 */
+	if (!priv->throttled_props->len) {
+		priv->throttle_id = 0;
+		return FALSE;
+	}
+
+	g_ptr_array_foreach (priv->throttled_props, add_to_notify_props, priv->notify_props);
+	g_ptr_array_set_size (priv->throttled_props, 0);
+	if (!priv->notify_id)
+		priv->notify_id = g_idle_add_full (G_PRIORITY_LOW, deferred_notify_cb, object, NULL);
+	return TRUE;
+}
+
 void
-_nm_object_queue_notify (NMObject *object, const char *property)
+_nm_object_queue_notify_pspec (NMObject *object, GParamSpec *pspec)
 {
 	NMObjectPrivate *priv;
-	gboolean found = FALSE;
-	GSList *iter;
 
 	g_return_if_fail (NM_IS_OBJECT (object));
-	g_return_if_fail (property != NULL);
+	g_return_if_fail (pspec != NULL);
 
 	priv = NM_OBJECT_GET_PRIVATE (object);
+	if (priv->demarshalling_lazy)
+		return;
+	if (G_UNLIKELY (!priv->notify_props)) {
+		priv->notify_props = g_ptr_array_new ();
+		priv->notify_spare = g_ptr_array_new ();
+		priv->throttled_props = g_ptr_array_new ();
+		priv->notify_pending = g_hash_table_new (g_direct_hash, g_direct_equal);
+	}
+
+	if (g_hash_table_lookup (priv->notify_pending, pspec))
+		return;
+	g_hash_table_insert (priv->notify_pending, pspec, pspec);
+
+	if (notify_throttle_quark && g_param_spec_get_qdata (pspec, notify_throttle_quark)) {
+		if (priv->throttle_id) {
+			g_ptr_array_add (priv->throttled_props, pspec);
+			return;
+		}
+		/* Emit this one now, and hold back further changes for a while */
+		priv->throttle_id = g_timeout_add (NOTIFY_THROTTLE_MS, throttle_cb, object);
+	}
+
+	g_ptr_array_add (priv->notify_props, pspec);
 	if (!priv->notify_id)
 		priv->notify_id = g_idle_add_full (G_PRIORITY_LOW, deferred_notify_cb, object, NULL);
+}
 
-	for (iter = priv->notify_props; iter; iter = g_slist_next (iter)) {
-		if (!strcmp ((char *) iter->data, property)) {
-			found = TRUE;
-			break;
-		}
+void
+_nm_object_queue_notify (NMObject *object, const char *property)
+{
+	GParamSpec *pspec;
+
+	g_return_if_fail (NM_IS_OBJECT (object));
+	g_return_if_fail (property != NULL);
+
+	pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (object), property);
+	if (!pspec) {
+		g_warning ("%s: type %s has no property '%s'",
+		           __func__, G_OBJECT_TYPE_NAME (object), property);
+		return;
 	}
 
-	if (!found)
-		priv->notify_props = g_slist_prepend (priv->notify_props, g_strdup (property));
+	_nm_object_queue_notify_pspec (object, pspec);
+}
+
+void
+_nm_object_class_throttle_notify (GObjectClass *object_class, const char *property)
+{
+	GParamSpec *pspec;
+
+	if (G_UNLIKELY (!notify_throttle_quark))
+		notify_throttle_quark = g_quark_from_static_string ("nm-object-notify-throttle");
+
+	pspec = g_object_class_find_property (object_class, property);
+	g_return_if_fail (pspec != NULL);
+
+	g_param_spec_set_qdata (pspec, notify_throttle_quark, GUINT_TO_POINTER (TRUE));
 }
 
 void
@@ -479,7 +627,8 @@ _nm_object_register_type_func (GType base_type, NMObjectTypeFunc type_func,
 }
 
 static GObject *
-_nm_object_create (GType type, DBusGConnection *connection, const char *path)
+_nm_object_create (GType type, DBusGConnection *connection, const char *path,
+                   GHashTable *snapshot)
 {
 	NMObjectTypeFunc type_func;
 	GObject *object;
@@ -487,7 +636,7 @@ _nm_object_create (GType type, DBusGConnection *connection, const char *path)
 
 	type_func = g_hash_table_lookup (type_funcs, GSIZE_TO_POINTER (type));
 	if (type_func)
-		type = type_func (connection, path);
+		type = type_func (connection, path, snapshot ? g_hash_table_lookup (snapshot, path) : NULL);
 
 	if (type == G_TYPE_INVALID) {
 		g_warning ("Could not create object for %s: unknown object type", path);
@@ -498,6 +647,7 @@ _nm_object_create (GType type, DBusGConnection *connection, const char *path)
 	                       NM_OBJECT_DBUS_CONNECTION, connection,
 	                       NM_OBJECT_DBUS_PATH, path,
 	                       NULL);
+	_nm_object_set_snapshot (NM_OBJECT (object), snapshot);
 	if (!g_initable_init (G_INITABLE (object), NULL, &error)) {
 		g_object_unref (object);
 		object = NULL;
@@ -512,6 +662,7 @@ typedef void (*NMObjectCreateCallbackFunc) (GObject *, const char *, gpointer);
 typedef struct {
 	DBusGConnection *connection;
 	char *path;
+	GHashTable *snapshot;
 	NMObjectCreateCallbackFunc callback;
 	gpointer user_data;
 } NMObjectTypeAsyncData;
@@ -521,6 +672,8 @@ create_async_complete (GObject *object, NMObjectTypeAsyncData *async_data)
 {
 	async_data->callback (object, async_data->path, async_data->user_data);
 
+	if (async_data->snapshot)
+		g_hash_table_unref (async_data->snapshot);
 	g_free (async_data->path);
 	g_slice_free (NMObjectTypeAsyncData, async_data);
 }
@@ -571,33 +724,39 @@ async_got_type (GType type, gpointer user_data)
 	                       NM_OBJECT_DBUS_PATH, async_data->path,
 	                       NULL);
 	g_warn_if_fail (object != NULL);
+	_nm_object_set_snapshot (NM_OBJECT (object), async_data->snapshot);
 	g_async_initable_init_async (G_ASYNC_INITABLE (object), G_PRIORITY_DEFAULT,
 	                             NULL, async_inited, async_data);
 }
 
 static void
 _nm_object_create_async (GType type, DBusGConnection *connection, const char *path,
+                         GHashTable *snapshot,
                          NMObjectCreateCallbackFunc callback, gpointer user_data)
 {
 	NMObjectTypeAsyncFunc type_async_func;
 	NMObjectTypeFunc type_func;
 	NMObjectTypeAsyncData *async_data;
+	GHashTable *props;
 
 	async_data = g_slice_new (NMObjectTypeAsyncData);
 	async_data->connection = connection;
 	async_data->path = g_strdup (path);
+	async_data->snapshot = snapshot ? g_hash_table_ref (snapshot) : NULL;
 	async_data->callback = callback;
 	async_data->user_data = user_data;
 
+	props = snapshot ? g_hash_table_lookup (snapshot, path) : NULL;
+
 	type_async_func = g_hash_table_lookup (type_async_funcs, GSIZE_TO_POINTER (type));
 	if (type_async_func) {
-		type_async_func (connection, path, async_got_type, async_data);
+		type_async_func (connection, path, props, async_got_type, async_data);
 		return;
 	}
 
 	type_func = g_hash_table_lookup (type_funcs, GSIZE_TO_POINTER (type));
 	if (type_func)
-		type = type_func (connection, path);
+		type = type_func (connection, path, props);
 
 	async_got_type (type, async_data);
 }
@@ -660,7 +819,7 @@ object_property_complete (ObjectCreatedData *odata)
 	PropertyInfo *pi = odata->pi;
 
 	if (odata->array) {
-		GPtrArray **array = pi->field;
+		GPtrArray **array = PROPERTY_FIELD (self, pi);
 		int i;
 
 		if (*array)
@@ -669,7 +828,7 @@ object_property_complete (ObjectCreatedData *odata)
 		for (i = 0; i < odata->length; i++)
 			add_to_object_array_unique (*array, odata->objects[i]);
 	} else {
-		GObject **obj_p = pi->field;
+		GObject **obj_p = PROPERTY_FIELD (self, pi);
 
 		if (*obj_p)
 			g_object_unref (*obj_p);
@@ -742,11 +901,11 @@ handle_object_property (NMObject *self, const char *property_name, GValue *value
 		object_created (obj, path, odata);
 		return TRUE;
 	} else if (synchronously) {
-		obj = _nm_object_create (pi->object_type, priv->connection, path);
+		obj = _nm_object_create (pi->object_type, priv->connection, path, priv->snapshot);
 		object_created (obj, path, odata);
 		return obj != NULL;
 	} else {
-		_nm_object_create_async (pi->object_type, priv->connection, path,
+		_nm_object_create_async (pi->object_type, priv->connection, path, priv->snapshot,
 		                         object_created, odata);
 		/* Assume success */
 		return TRUE;
@@ -760,7 +919,7 @@ handle_object_array_property (NMObject *self, const char *property_name, GValue
 	NMObjectPrivate *priv = NM_OBJECT_GET_PRIVATE (self);
 	GObject *obj;
 	GPtrArray *paths;
-	GPtrArray **array = pi->field;
+	GPtrArray **array = PROPERTY_FIELD (self, pi);
 	const char *path;
 	ObjectCreatedData *odata;
 	int i;
@@ -794,10 +953,10 @@ handle_object_array_property (NMObject *self, const char *property_name, GValue
 		if (obj) {
 			object_created (obj, path, odata);
 		} else if (synchronously) {
-			obj = _nm_object_create (pi->object_type, priv->connection, path);
+			obj = _nm_object_create (pi->object_type, priv->connection, path, priv->snapshot);
 			object_created (obj, path, odata);
 		} else {
-			_nm_object_create_async (pi->object_type, priv->connection, path,
+			_nm_object_create_async (pi->object_type, priv->connection, path, priv->snapshot,
 			                         object_created, odata);
 		}
 	}
@@ -810,6 +969,61 @@ handle_object_array_property (NMObject *self, const char *property_name, GValue
 	return *array && ((*array)->len == paths->len);
 }
 
+static void
+lazy_value_free (LazyValue *lazy)
+{
+	g_value_unset (&lazy->value);
+	g_slice_free (LazyValue, lazy);
+}
+
+void
+_nm_object_ensure_property (NMObject *object, gpointer field)
+{
+	NMObjectPrivate *priv;
+	GHashTableIter iter;
+	PropertyInfo *pi;
+	LazyValue *lazy;
+
+	g_return_if_fail (NM_IS_OBJECT (object));
+
+	priv = NM_OBJECT_GET_PRIVATE (object);
+	if (!priv->lazy_values || !g_hash_table_size (priv->lazy_values))
+		return;
+
+	g_hash_table_iter_init (&iter, priv->lazy_values);
+	while (g_hash_table_iter_next (&iter, (gpointer) &pi, (gpointer) &lazy)) {
+		if (PROPERTY_FIELD (object, pi) != field)
+			continue;
+
+		g_hash_table_iter_steal (&iter);
+		lazy_demarshals++;
+
+		priv->demarshalling_lazy = TRUE;
+		if (!(*(pi->func)) (object, lazy->pspec, &lazy->value, field)) {
+			g_warning ("%s: failed to update property '%s' of object type %s.",
+			           __func__,
+			           lazy->pspec->name,
+			           G_OBJECT_TYPE_NAME (object));
+		}
+		priv->demarshalling_lazy = FALSE;
+
+		lazy_value_free (lazy);
+		break;
+	}
+}
+
+/* Moves the contents of @src into the unset @dest without copying them.
+ * @src is left holding an empty value of a trivial type, so that its owner
+ * (the signal's or GetAll's properties hash) can still unset it.
+ */
+static void
+value_move (GValue *dest, GValue *src)
+{
+	*dest = *src;
+	memset (src, 0, sizeof (*src));
+	g_value_init (src, G_TYPE_INT);
+}
+
 static void
 handle_property_changed (NMObject *self, const char *dbus_name, GValue *value, gboolean synchronously)
 {
@@ -826,7 +1040,7 @@ handle_property_changed (NMObject *self, const char *dbus_name, GValue *value, g
 	for (iter = priv->property_tables; iter; iter = g_slist_next (iter)) {
 		pi = g_hash_table_lookup ((GHashTable *) iter->data, prop_name);
 		if (pi) {
-			if (!pi->field) {
+			if (!pi->field_offset) {
 				/* We know about this property but aren't tracking changes on it. */
 				goto out;
 			}
@@ -875,8 +1089,22 @@ handle_property_changed (NMObject *self, const char *dbus_name, GValue *value, g
 			g_warn_if_reached ();
 			goto out;
 		}
+	} else if (pi->lazy && !lazy_disabled) {
+		LazyValue *lazy;
+
+		if (!priv->lazy_values) {
+			priv->lazy_values = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+			                                           NULL, (GDestroyNotify) lazy_value_free);
+		}
+		lazy = g_slice_new0 (LazyValue);
+		lazy->pspec = pspec;
+		value_move (&lazy->value, value);
+		g_hash_table_replace (priv->lazy_values, pi, lazy);
+
+		_nm_object_queue_notify_pspec (self, pspec);
+		success = TRUE;
 	} else
-		success = (*(pi->func)) (self, pspec, value, pi->field);
+		success = (*(pi->func)) (self, pspec, value, PROPERTY_FIELD (self, pi));
 
 	if (!success) {
 		g_warning ("%s: failed to update property '%s' of object type %s.",
@@ -910,6 +1138,27 @@ process_properties_changed (NMObject *self, GHashTable *properties, gboolean syn
 	}
 }
 
+void
+_nm_object_process_properties_changed (NMObject *object, GHashTable *properties)
+{
+	g_return_if_fail (NM_IS_OBJECT (object));
+	g_return_if_fail (properties != NULL);
+
+	process_properties_changed (object, properties, TRUE);
+}
+
+void
+_nm_object_set_lazy_properties_enabled (gboolean enabled)
+{
+	lazy_disabled = !enabled;
+}
+
+guint
+_nm_object_get_lazy_demarshal_count (void)
+{
+	return lazy_demarshals;
+}
+
 static void
 properties_changed_proxy (DBusGProxy *proxy,
                           GHashTable *properties,
@@ -973,7 +1222,7 @@ demarshal_generic (NMObject *object,
 
 done:
 	if (success) {
-		_nm_object_queue_notify (object, pspec->name);
+		_nm_object_queue_notify_pspec (object, pspec);
 	} else {
 		g_warning ("%s: %s/%s (type %s) couldn't be set with type %s.",
 		           __func__, G_OBJECT_TYPE_NAME (object), pspec->name,
@@ -982,21 +1231,63 @@ done:
 	return success;
 }
 
+static GHashTable *
+get_property_table (NMObject *object, const char *interface, const NMPropertiesInfo *info)
+{
+	GType type = G_OBJECT_TYPE (object);
+	GHashTable *by_interface, *table;
+	NMPropertiesInfo *tmp;
+
+	if (G_UNLIKELY (!property_tables_quark))
+		property_tables_quark = g_quark_from_static_string ("nm-object-property-tables");
+
+	/* Interface name -> property table, attached to the instance type */
+	by_interface = g_type_get_qdata (type, property_tables_quark);
+	if (!by_interface) {
+		by_interface = g_hash_table_new (g_str_hash, g_str_equal);
+		g_type_set_qdata (type, property_tables_quark, by_interface);
+	}
+
+	table = g_hash_table_lookup (by_interface, interface);
+	if (table)
+		return table;
+
+	table = g_hash_table_new (g_str_hash, g_str_equal);
+	g_hash_table_insert (by_interface, (char *) interface, table);
+
+	for (tmp = (NMPropertiesInfo *) info; tmp->name; tmp++) {
+		PropertyInfo *pi;
+
+		if (!tmp->name || (tmp->func && !tmp->field)) {
+			g_warning ("%s: missing field in NMPropertiesInfo", __func__);
+			continue;
+		}
+
+		pi = g_malloc0 (sizeof (PropertyInfo));
+		pi->func = tmp->func ? tmp->func : demarshal_generic;
+		pi->object_type = tmp->object_type;
+		pi->lazy = tmp->lazy && !tmp->object_type;
+		pi->field_offset = tmp->field ? (char *) tmp->field - (char *) object : 0;
+		g_hash_table_insert (table, (char *) g_intern_string (tmp->name), pi);
+	}
+
+	return table;
+}
+
 void
 _nm_object_register_properties (NMObject *object,
                                 DBusGProxy *proxy,
                                 const NMPropertiesInfo *info)
 {
 	NMObjectPrivate *priv = NM_OBJECT_GET_PRIVATE (object);
-	NMPropertiesInfo *tmp;
-	GHashTable *instance;
+	const char *interface;
 
 	g_return_if_fail (NM_IS_OBJECT (object));
 	g_return_if_fail (proxy != NULL);
 	g_return_if_fail (info != NULL);
 
-	priv->property_interfaces = g_slist_prepend (priv->property_interfaces,
-	                                             g_strdup (dbus_g_proxy_get_interface (proxy)));
+	interface = g_intern_string (dbus_g_proxy_get_interface (proxy));
+	priv->property_interfaces = g_slist_prepend (priv->property_interfaces, (char *) interface);
 
 	dbus_g_proxy_add_signal (proxy, "PropertiesChanged", DBUS_TYPE_G_MAP_OF_VARIANT, G_TYPE_INVALID);
 	dbus_g_proxy_connect_signal (proxy,
@@ -1005,23 +1296,52 @@ _nm_object_register_properties (NMObject *object,
 						    object,
 						    NULL);
 
-	instance = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
-	priv->property_tables = g_slist_prepend (priv->property_tables, instance);
+	priv->property_tables = g_slist_prepend (priv->property_tables,
+	                                         get_property_table (object, interface, info));
+}
 
-	for (tmp = (NMPropertiesInfo *) info; tmp->name; tmp++) {
-		PropertyInfo *pi;
+/* Lets @object, and the objects it creates while reading its properties,
+ * initialize from @objects (the result of NetworkManager's GetObjectTree()
+ * method) instead of calling GetAll.  Each object's entry is only used once,
+ * and every object drops its reference to @objects as soon as it has read its
+ * own properties.  Must be called before @object is initialized.
+ */
+void
+_nm_object_set_snapshot (NMObject *object, GHashTable *objects)
+{
+	NMObjectPrivate *priv;
 
-		if (!tmp->name || (tmp->func && !tmp->field)) {
-			g_warning ("%s: missing field in NMPropertiesInfo", __func__);
-			continue;
-		}
+	g_return_if_fail (NM_IS_OBJECT (object));
 
-		pi = g_malloc0 (sizeof (PropertyInfo));
-		pi->func = tmp->func ? tmp->func : demarshal_generic;
-		pi->object_type = tmp->object_type;
-		pi->field = tmp->field;
-		g_hash_table_insert (instance, g_strdup (tmp->name), pi);
+	priv = NM_OBJECT_GET_PRIVATE (object);
+	if (objects)
+		g_hash_table_ref (objects);
+	if (priv->snapshot)
+		g_hash_table_unref (priv->snapshot);
+	priv->snapshot = objects;
+}
+
+/* Returns the object's own entry of the snapshot, if any.  Without one the
+ * snapshot is dropped right away; otherwise the caller drops it once it has
+ * created the objects the entry refers to.
+ */
+static GHashTable *
+snapshot_take (NMObject *object)
+{
+	NMObjectPrivate *priv = NM_OBJECT_GET_PRIVATE (object);
+	gpointer key, props;
+
+	if (!priv->snapshot)
+		return NULL;
+
+	if (!g_hash_table_lookup_extended (priv->snapshot, priv->path, &key, &props)) {
+		_nm_object_set_snapshot (object, NULL);
+		return NULL;
 	}
+
+	g_hash_table_steal (priv->snapshot, priv->path);
+	g_free (key);
+	return props;
 }
 
 gboolean
@@ -1032,10 +1352,31 @@ _nm_object_reload_properties (NMObject *object, GError **error)
 	GSList *p;
 	GHashTableIter pp;
 	gpointer name, info;
+	GValue *value;
 
 	if (!priv->property_interfaces)
 		return TRUE;
 
+	props = snapshot_take (object);
+	if (props) {
+		process_properties_changed (object, props, TRUE);
+
+		if (priv->pseudo_properties) {
+			g_hash_table_iter_init (&pp, priv->pseudo_properties);
+			while (g_hash_table_iter_next (&pp, &name, &info)) {
+				value = g_hash_table_lookup (props, name);
+				if (value && G_VALUE_HOLDS (value, DBUS_TYPE_G_ARRAY_OF_OBJECT_PATH))
+					handle_object_array_property (object, NULL, value, &((PseudoPropertyInfo *) info)->pi, TRUE);
+				else
+					_nm_object_reload_pseudo_property (object, name);
+			}
+		}
+
+		g_hash_table_destroy (props);
+		_nm_object_set_snapshot (object, NULL);
+		return TRUE;
+	}
+
 	for (p = priv->property_interfaces; p; p = p->next) {
 		if (!dbus_g_proxy_call (priv->properties_proxy, "GetAll", error,
 		                        G_TYPE_STRING, p->data,
@@ -1153,7 +1494,7 @@ pseudo_property_object_created (GObject *obj, const char *path, gpointer user_da
 	PseudoPropertyInfo *ppi = user_data;
 
 	if (obj) {
-		GPtrArray **list_p = (GPtrArray **)ppi->pi.field;
+		GPtrArray **list_p = PROPERTY_FIELD (ppi->self, &ppi->pi);
 
 		if (!*list_p)
 			*list_p = g_ptr_array_new ();
@@ -1176,7 +1517,7 @@ pseudo_property_added (DBusGProxy *proxy, const char *path, gpointer user_data)
 	if (obj)
 		pseudo_property_object_created (G_OBJECT (obj), path, ppi);
 	else {
-		_nm_object_create_async (ppi->pi.object_type, priv->connection, path,
+		_nm_object_create_async (ppi->pi.object_type, priv->connection, path, NULL,
 		                         pseudo_property_object_created, ppi);
 	}
 }
@@ -1186,7 +1527,7 @@ pseudo_property_removed (DBusGProxy *proxy, const char *path, gpointer user_data
 {
 	PseudoPropertyInfo *ppi = user_data;
 	NMObjectPrivate *priv = NM_OBJECT_GET_PRIVATE (ppi->self);
-	GPtrArray *list = *(GPtrArray **)ppi->pi.field;
+	GPtrArray *list = *(GPtrArray **) PROPERTY_FIELD (ppi->self, &ppi->pi);
 	NMObject *obj = NULL;
 	int i;
 
@@ -1230,7 +1571,7 @@ _nm_object_register_pseudo_property (NMObject *object,
 	g_return_if_fail (proxy != NULL);
 
 	ppi = g_slice_new0 (PseudoPropertyInfo);
-	ppi->pi.field = field;
+	ppi->pi.field_offset = (char *) field - (char *) object;
 	ppi->pi.object_type = object_type;
 	ppi->self = object;
 	ppi->proxy = g_object_ref (proxy);
@@ -1387,11 +1728,25 @@ reload_got_pseudo_property (DBusGProxy *proxy, DBusGProxyCall *call,
 		reload_complete (object);
 }
 
+static gboolean
+reload_snapshot_done (gpointer user_data)
+{
+	NMObject *object = user_data;
+	NMObjectPrivate *priv = NM_OBJECT_GET_PRIVATE (object);
+
+	if (--priv->reload_remaining == 0)
+		reload_complete (object);
+
+	g_object_unref (object);
+	return FALSE;
+}
+
 void
 _nm_object_reload_properties_async (NMObject *object, GAsyncReadyCallback callback, gpointer user_data)
 {
 	NMObjectPrivate *priv = NM_OBJECT_GET_PRIVATE (object);
 	GSimpleAsyncResult *simple;
+	GHashTable *props;
 	GSList *p;
 
 	simple = g_simple_async_result_new (G_OBJECT (object), callback,
@@ -1411,28 +1766,53 @@ _nm_object_reload_properties_async (NMObject *object, GAsyncReadyCallback callba
 	if (priv->reload_results->next)
 		return;
 
-	for (p = priv->property_interfaces; p; p = p->next) {
+	props = snapshot_take (object);
+	if (props) {
+		/* Everything below may finish right away; complete from an idle
+		 * so the caller's callback is never run before we return.
+		 */
 		priv->reload_remaining++;
-		dbus_g_proxy_begin_call (priv->properties_proxy, "GetAll",
-		                         reload_got_properties, object, NULL,
-		                         G_TYPE_STRING, p->data,
-		                         G_TYPE_INVALID);
+		g_idle_add (reload_snapshot_done, g_object_ref (object));
+
+		process_properties_changed (object, props, FALSE);
+	} else {
+		for (p = priv->property_interfaces; p; p = p->next) {
+			priv->reload_remaining++;
+			dbus_g_proxy_begin_call (priv->properties_proxy, "GetAll",
+			                         reload_got_properties, object, NULL,
+			                         G_TYPE_STRING, p->data,
+			                         G_TYPE_INVALID);
+		}
 	}
 
 	if (priv->pseudo_properties) {
 		GHashTableIter iter;
 		gpointer key, value;
 		PseudoPropertyInfo *ppi;
+		GValue *list;
 
 		g_hash_table_iter_init (&iter, priv->pseudo_properties);
 		while (g_hash_table_iter_next (&iter, &key, &value)) {
 			ppi = value;
+
+			list = props ? g_hash_table_lookup (props, key) : NULL;
+			if (list && G_VALUE_HOLDS (list, DBUS_TYPE_G_ARRAY_OF_OBJECT_PATH)) {
+				if (!priv->suppress_property_updates)
+					handle_object_array_property (object, NULL, list, &ppi->pi, FALSE);
+				continue;
+			}
+
 			priv->reload_remaining++;
 			dbus_g_proxy_begin_call (ppi->proxy, ppi->get_method,
 			                         reload_got_pseudo_property, ppi, NULL,
 			                         G_TYPE_INVALID);
 		}
 	}
+
+	if (props) {
+		g_hash_table_destroy (props);
+		_nm_object_set_snapshot (object, NULL);
+	}
 }
 
 gboolean
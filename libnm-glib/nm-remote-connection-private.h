@@ -23,6 +23,9 @@
 #ifndef __NM_REMOTE_CONNECTION_PRIVATE_H__
 #define __NM_REMOTE_CONNECTION_PRIVATE_H__
 
+#include <dbus/dbus-glib.h>
+#include "nm-remote-connection.h"
+
 #define NM_REMOTE_CONNECTION_INIT_RESULT "init-result"
 
 typedef enum {
@@ -32,5 +35,11 @@ typedef enum {
 	NM_REMOTE_CONNECTION_INIT_RESULT_INVISIBLE,
 } NMRemoteConnectionInitResult;
 
+NMRemoteConnection *_nm_remote_connection_new_with_settings (DBusGConnection *bus,
+                                                             const char *path,
+                                                             GHashTable *settings);
+
+gboolean _nm_remote_connection_get_visible (NMRemoteConnection *self);
+
 #endif  /* __NM_REMOTE_CONNECTION_PRIVATE__ */
 
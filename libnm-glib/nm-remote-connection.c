@@ -355,6 +355,52 @@ nm_remote_connection_new (DBusGConnection *bus,
 	                                            NULL);
 }
 
+/* Creates a connection whose settings were already fetched from the settings
+ * service, so it doesn't need to be initialized.  Empty @settings mean the
+ * connection is not visible to this user; such connections will request
+ * their settings again once they are updated.
+ */
+NMRemoteConnection *
+_nm_remote_connection_new_with_settings (DBusGConnection *bus,
+                                         const char *path,
+                                         GHashTable *settings)
+{
+	NMRemoteConnection *self;
+	NMRemoteConnectionPrivate *priv;
+	GError *error = NULL;
+
+	g_return_val_if_fail (settings != NULL, NULL);
+
+	self = nm_remote_connection_new (bus, path);
+	if (!self)
+		return NULL;
+
+	priv = NM_REMOTE_CONNECTION_GET_PRIVATE (self);
+	if (g_hash_table_size (settings) == 0)
+		priv->visible = FALSE;
+	else if (nm_connection_replace_settings (NM_CONNECTION (self), settings, &error))
+		priv->visible = TRUE;
+	else {
+		g_warning ("%s: error reading connection %s settings: (%d) %s",
+		           __func__, path,
+		           error ? error->code : -1,
+		           (error && error->message) ? error->message : "(unknown)");
+		g_clear_error (&error);
+		g_object_unref (self);
+		return NULL;
+	}
+
+	return self;
+}
+
+gboolean
+_nm_remote_connection_get_visible (NMRemoteConnection *self)
+{
+	g_return_val_if_fail (NM_IS_REMOTE_CONNECTION (self), FALSE);
+
+	return NM_REMOTE_CONNECTION_GET_PRIVATE (self)->visible;
+}
+
 static void
 constructed (GObject *object)
 {
@@ -48,6 +48,15 @@ typedef struct {
 	DBusGProxy *proxy;
 	GHashTable *connections;
 	GHashTable *pending;  /* Connections we don't have settings for yet */
+	/* Pending connections still fetching their settings; TRUE for the ones
+	 * the initial fetch waits for (counted in init_left).
+	 */
+	GHashTable *initializing;
+
+	/* Indexes of the visible connections ('connections' hash) */
+	GHashTable *index;    /* NMRemoteConnection -> IndexEntry */
+	GHashTable *by_uuid;  /* UUID -> NMRemoteConnection */
+	GHashTable *by_id;    /* ID -> GSList of NMRemoteConnection */
 	gboolean service_running;
 	guint32 init_left;
 
@@ -62,6 +71,8 @@ typedef struct {
 
 	guint fetch_id;
 	gboolean fetching;
+	char *fetch_cursor;
+	gboolean no_get_all_settings;
 } NMRemoteSettingsPrivate;
 
 enum {
@@ -171,6 +182,18 @@ add_connection_info_complete (NMRemoteSettings *self,
 	add_connection_info_dispose (self, info);
 }
 
+static void
+add_connection_info_fail_unavailable (NMRemoteSettings *self, AddConnectionInfo *info)
+{
+	GError *error;
+
+	error = g_error_new_literal (NM_REMOTE_SETTINGS_ERROR,
+	                             NM_REMOTE_SETTINGS_ERROR_CONNECTION_UNAVAILABLE,
+	                             "Connection not visible or not available");
+	add_connection_info_complete (self, info, error);
+	g_error_free (error);
+}
+
 /**
  * nm_remote_settings_get_connection_by_path:
  * @settings: the %NMRemoteSettings
@@ -197,6 +220,107 @@ nm_remote_settings_get_connection_by_path (NMRemoteSettings *settings, const cha
 	return priv->service_running ? g_hash_table_lookup (priv->connections, path) : NULL;
 }
 
+typedef struct {
+	char *uuid;
+	char *id;
+} IndexEntry;
+
+static void
+index_entry_free (gpointer data)
+{
+	IndexEntry *entry = data;
+
+	g_free (entry->uuid);
+	g_free (entry->id);
+	g_slice_free (IndexEntry, entry);
+}
+
+static void
+index_remove (NMRemoteSettings *self, NMRemoteConnection *remote)
+{
+	NMRemoteSettingsPrivate *priv = NM_REMOTE_SETTINGS_GET_PRIVATE (self);
+	IndexEntry *entry;
+	gpointer key, list;
+
+	entry = g_hash_table_lookup (priv->index, remote);
+	if (!entry)
+		return;
+
+	if (entry->uuid && g_hash_table_lookup (priv->by_uuid, entry->uuid) == remote)
+		g_hash_table_remove (priv->by_uuid, entry->uuid);
+
+	if (entry->id && g_hash_table_lookup_extended (priv->by_id, entry->id, &key, &list)) {
+		g_hash_table_steal (priv->by_id, entry->id);
+		list = g_slist_remove (list, remote);
+		if (list)
+			g_hash_table_insert (priv->by_id, key, list);
+		else
+			g_free (key);
+	}
+
+	g_hash_table_remove (priv->index, remote);
+}
+
+static void
+index_add (NMRemoteSettings *self, NMRemoteConnection *remote)
+{
+	NMRemoteSettingsPrivate *priv = NM_REMOTE_SETTINGS_GET_PRIVATE (self);
+	IndexEntry *entry;
+	gpointer key, list;
+
+	index_remove (self, remote);
+
+	entry = g_slice_new0 (IndexEntry);
+	entry->uuid = g_strdup (nm_connection_get_uuid (NM_CONNECTION (remote)));
+	entry->id = g_strdup (nm_connection_get_id (NM_CONNECTION (remote)));
+	g_hash_table_insert (priv->index, remote, entry);
+
+	if (entry->uuid)
+		g_hash_table_insert (priv->by_uuid, g_strdup (entry->uuid), remote);
+	if (entry->id) {
+		if (g_hash_table_lookup_extended (priv->by_id, entry->id, &key, &list))
+			g_hash_table_steal (priv->by_id, entry->id);
+		else {
+			key = g_strdup (entry->id);
+			list = NULL;
+		}
+		g_hash_table_insert (priv->by_id, key, g_slist_append (list, remote));
+	}
+}
+
+static void
+index_clear (NMRemoteSettings *self)
+{
+	NMRemoteSettingsPrivate *priv = NM_REMOTE_SETTINGS_GET_PRIVATE (self);
+
+	g_hash_table_remove_all (priv->index);
+	g_hash_table_remove_all (priv->by_uuid);
+	g_hash_table_remove_all (priv->by_id);
+}
+
+/* The indexes are refreshed when a connection's settings change on the
+ * server, but a client may also modify a connection locally; so verify
+ * what the index returns and fall back to a scan if it's out of date.
+ */
+static NMRemoteConnection *
+find_connection_slow (NMRemoteSettings *self, const char *uuid, const char *id)
+{
+	NMRemoteSettingsPrivate *priv = NM_REMOTE_SETTINGS_GET_PRIVATE (self);
+	GHashTableIter iter;
+	NMRemoteConnection *candidate;
+
+	g_hash_table_iter_init (&iter, priv->connections);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &candidate)) {
+		if (   (uuid && !g_strcmp0 (uuid, nm_connection_get_uuid (NM_CONNECTION (candidate))))
+		    || (id && !g_strcmp0 (id, nm_connection_get_id (NM_CONNECTION (candidate))))) {
+			index_add (self, candidate);
+			return candidate;
+		}
+	}
+
+	return NULL;
+}
+
 /**
  * nm_remote_settings_get_connection_by_uuid:
  * @settings: the %NMRemoteSettings
@@ -211,7 +335,6 @@ NMRemoteConnection *
 nm_remote_settings_get_connection_by_uuid (NMRemoteSettings *settings, const char *uuid)
 {
 	NMRemoteSettingsPrivate *priv;
-	GHashTableIter iter;
 	NMRemoteConnection *candidate;
 
 	g_return_val_if_fail (settings != NULL, NULL);
@@ -222,15 +345,61 @@ nm_remote_settings_get_connection_by_uuid (NMRemoteSettings *settings, const cha
 
 	_nm_remote_settings_ensure_inited (settings);
 
-	if (priv->service_running) {
-		g_hash_table_iter_init (&iter, priv->connections);
-		while (g_hash_table_iter_next (&iter, NULL, (gpointer) &candidate)) {
-			if (g_strcmp0 (uuid, nm_connection_get_uuid (NM_CONNECTION (candidate))) == 0)
-				return candidate;
-		}
+	if (!priv->service_running)
+		return NULL;
+
+	candidate = g_hash_table_lookup (priv->by_uuid, uuid);
+	if (candidate && !g_strcmp0 (uuid, nm_connection_get_uuid (NM_CONNECTION (candidate))))
+		return candidate;
+
+	return find_connection_slow (settings, uuid, NULL);
+}
+
+/**
+ * nm_remote_settings_get_connection_by_id:
+ * @settings: the %NMRemoteSettings
+ * @id: the ID of the remote connection
+ *
+ * Returns the %NMRemoteConnection identified by @id.  Connection IDs are not
+ * necessarily unique; if several connections share @id, one of them is
+ * returned.
+ *
+ * Returns: (transfer none): the remote connection object on success, or NULL if the object was
+ *  not known
+ **/
+NMRemoteConnection *
+nm_remote_settings_get_connection_by_id (NMRemoteSettings *settings, const char *id)
+{
+	NMRemoteSettingsPrivate *priv;
+	GSList *iter;
+
+	g_return_val_if_fail (settings != NULL, NULL);
+	g_return_val_if_fail (NM_IS_REMOTE_SETTINGS (settings), NULL);
+	g_return_val_if_fail (id != NULL, NULL);
+
+	priv = NM_REMOTE_SETTINGS_GET_PRIVATE (settings);
+
+	_nm_remote_settings_ensure_inited (settings);
+
+	if (!priv->service_running)
+		return NULL;
+
+	for (iter = g_hash_table_lookup (priv->by_id, id); iter; iter = iter->next) {
+		if (!g_strcmp0 (id, nm_connection_get_id (NM_CONNECTION (iter->data))))
+			return iter->data;
 	}
 
-	return NULL;
+	return find_connection_slow (settings, NULL, id);
+}
+
+static void
+connection_updated_cb (NMRemoteConnection *remote, GHashTable *new_settings, gpointer user_data)
+{
+	NMRemoteSettings *self = NM_REMOTE_SETTINGS (user_data);
+	NMRemoteSettingsPrivate *priv = NM_REMOTE_SETTINGS_GET_PRIVATE (self);
+
+	if (g_hash_table_lookup (priv->index, remote))
+		index_add (self, remote);
 }
 
 static void
@@ -253,6 +422,7 @@ connection_removed_cb (NMRemoteConnection *remote, gpointer user_data)
 	}
 
 	path = nm_connection_get_path (NM_CONNECTION (remote));
+	index_remove (self, remote);
 	g_hash_table_remove (priv->connections, path);
 	g_hash_table_remove (priv->pending, path);
 }
@@ -268,12 +438,18 @@ move_connection (NMRemoteSettings *self,
                  GHashTable *from,
                  GHashTable *to)
 {
+	NMRemoteSettingsPrivate *priv = NM_REMOTE_SETTINGS_GET_PRIVATE (self);
 	const char *path = nm_connection_get_path (NM_CONNECTION (remote));
 
 	g_hash_table_insert (to, g_strdup (path), g_object_ref (remote));
 	if (from)
 		g_hash_table_remove (from, path);
 
+	if (to == priv->connections)
+		index_add (self, remote);
+	else if (from == priv->connections)
+		index_remove (self, remote);
+
 	/* Setup connection signals since removing from 'from' clears them, but
 	 * also the first time the connection is added to a hash if 'from' is NULL.
 	 */
@@ -292,6 +468,14 @@ move_connection (NMRemoteSettings *self,
 		                  G_CALLBACK (connection_visible_cb),
 		                  self);
 	}
+
+	if (!g_signal_handler_find (remote, G_SIGNAL_MATCH_FUNC,
+	                            0, 0, NULL, connection_updated_cb, NULL)) {
+		g_signal_connect (remote,
+		                  NM_REMOTE_CONNECTION_UPDATED,
+		                  G_CALLBACK (connection_updated_cb),
+		                  self);
+	}
 }
 
 static void
@@ -342,10 +526,13 @@ connection_inited (GObject *source, GAsyncResult *result, gpointer user_data)
 	NMRemoteSettingsPrivate *priv = NM_REMOTE_SETTINGS_GET_PRIVATE (self);
 	AddConnectionInfo *addinfo;
 	const char *path;
-	GError *error = NULL, *local;
+	gboolean fetched;
+	GError *error = NULL;
 
 	path = nm_connection_get_path (NM_CONNECTION (remote));
 	addinfo = add_connection_info_find (self, remote);
+	fetched = GPOINTER_TO_UINT (g_hash_table_lookup (priv->initializing, remote));
+	g_hash_table_remove (priv->initializing, remote);
 
 	if (g_async_initable_init_finish (G_ASYNC_INITABLE (remote), result, &error)) {
 		/* Connection is initialized and visible; expose it to clients */
@@ -362,13 +549,8 @@ connection_inited (GObject *source, GAsyncResult *result, gpointer user_data)
 		 */
 		g_signal_emit (self, signals[NEW_CONNECTION], 0, remote);
 	} else {
-		if (addinfo) {
-			local = g_error_new_literal (NM_REMOTE_SETTINGS_ERROR,
-			                             NM_REMOTE_SETTINGS_ERROR_CONNECTION_UNAVAILABLE,
-			                             "Connection not visible or not available");
-			add_connection_info_complete (self, addinfo, local);
-			g_error_free (local);
-		}
+		if (addinfo)
+			add_connection_info_fail_unavailable (self, addinfo);
 
 		/* PermissionDenied means the connection isn't visible to this user, so
 		 * keep it in priv->pending to be notified later of visibility changes.
@@ -381,8 +563,7 @@ connection_inited (GObject *source, GAsyncResult *result, gpointer user_data)
 	}
 
 	/* Let listeners know that all connections have been found */
-	priv->init_left--;
-	if (priv->init_left == 0) {
+	if (fetched && --priv->init_left == 0) {
 		priv->fetching = FALSE;
 		g_signal_emit (self, signals[CONNECTIONS_READ], 0);
 	}
@@ -406,6 +587,7 @@ new_connection_cb (DBusGProxy *proxy, const char *path, gpointer user_data)
 	/* Create a new connection object for it */
 	connection = nm_remote_connection_new (priv->bus, path);
 	if (connection) {
+		g_hash_table_insert (priv->initializing, connection, GUINT_TO_POINTER (FALSE));
 		g_async_initable_init_async (G_ASYNC_INITABLE (connection),
 		                             G_PRIORITY_DEFAULT, NULL,
 		                             connection_inited, self);
@@ -450,21 +632,120 @@ fetch_connections_done (DBusGProxy *proxy,
 		return;
 	}
 
+	/* Only wait for the connections created here; ones from earlier
+	 * GetAllSettings pages or NewConnection signals are known already.
+	 */
+	priv->init_left = 0;
+	for (i = 0; i < connections->len; i++) {
+		char *path = g_ptr_array_index (connections, i);
+
+		if (   !g_hash_table_lookup (priv->pending, path)
+		    && !g_hash_table_lookup (priv->connections, path)) {
+			NMRemoteConnection *connection;
+
+			connection = new_connection_cb (proxy, path, user_data);
+			if (connection) {
+				g_hash_table_insert (priv->initializing, connection, GUINT_TO_POINTER (TRUE));
+				priv->init_left++;
+			}
+		}
+		g_free (path);
+	}
+	g_ptr_array_free (connections, TRUE);
+
 	/* Let listeners know we are done getting connections */
-	if (connections->len == 0) {
+	if (priv->init_left == 0) {
 		priv->fetching = FALSE;
 		g_signal_emit (self, signals[CONNECTIONS_READ], 0);
-	} else {
-		priv->init_left = connections->len;
-		for (i = 0; i < connections->len; i++) {
-			char *path = g_ptr_array_index (connections, i);
+	}
+}
 
-			new_connection_cb (proxy, path, user_data);
-			g_free (path);
-		}
+/* Number of connections requested per GetAllSettings call */
+#define FETCH_PAGE_SIZE 500
+
+static void fetch_all_settings_page (NMRemoteSettings *self);
+
+static void
+fetch_all_settings_done (DBusGProxy *proxy,
+                         DBusGProxyCall *call,
+                         gpointer user_data)
+{
+	NMRemoteSettings *self = NM_REMOTE_SETTINGS (user_data);
+	NMRemoteSettingsPrivate *priv = NM_REMOTE_SETTINGS_GET_PRIVATE (self);
+	GHashTable *all_settings;
+	GHashTableIter iter;
+	gpointer key, value;
+	char *cursor = NULL;
+	GError *error = NULL;
+
+	g_free (priv->fetch_cursor);
+	priv->fetch_cursor = NULL;
+
+	if (!dbus_g_proxy_end_call (proxy, call, &error,
+	                            DBUS_TYPE_G_MAP_OF_MAP_OF_MAP_OF_VARIANT, &all_settings,
+	                            G_TYPE_STRING, &cursor,
+	                            G_TYPE_INVALID)) {
+		/* Older settings services don't have the method; don't try it again */
+		if (g_error_matches (error, DBUS_GERROR, DBUS_GERROR_UNKNOWN_METHOD))
+			priv->no_get_all_settings = TRUE;
+		g_clear_error (&error);
+
+		/* Whatever went wrong, fetch each connection separately instead;
+		 * connections from earlier pages are skipped there.
+		 */
+		dbus_g_proxy_begin_call (priv->proxy, "ListConnections",
+		                         fetch_connections_done, self, NULL,
+		                         G_TYPE_INVALID);
+		return;
 	}
 
-	g_ptr_array_free (connections, TRUE);
+	g_hash_table_iter_init (&iter, all_settings);
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		const char *path = key;
+		NMRemoteConnection *connection;
+
+		/* May already have been added by a NewConnection signal */
+		if (   g_hash_table_lookup (priv->pending, path)
+		    || g_hash_table_lookup (priv->connections, path))
+			continue;
+
+		connection = _nm_remote_connection_new_with_settings (priv->bus, path, value);
+		if (!connection)
+			continue;
+
+		/* Invisible connections wait in the pending table until they
+		 * become visible, just like connections that failed to initialize
+		 * with a permission error.
+		 */
+		if (_nm_remote_connection_get_visible (connection)) {
+			move_connection (self, connection, NULL, priv->connections);
+			g_signal_emit (self, signals[NEW_CONNECTION], 0, connection);
+		} else
+			move_connection (self, connection, NULL, priv->pending);
+		g_object_unref (connection); /* move_connection() takes a ref */
+	}
+	g_hash_table_destroy (all_settings);
+
+	if (cursor && *cursor) {
+		priv->fetch_cursor = cursor;
+		fetch_all_settings_page (self);
+	} else {
+		g_free (cursor);
+		priv->fetching = FALSE;
+		g_signal_emit (self, signals[CONNECTIONS_READ], 0);
+	}
+}
+
+static void
+fetch_all_settings_page (NMRemoteSettings *self)
+{
+	NMRemoteSettingsPrivate *priv = NM_REMOTE_SETTINGS_GET_PRIVATE (self);
+
+	dbus_g_proxy_begin_call (priv->proxy, "GetAllSettings",
+	                         fetch_all_settings_done, self, NULL,
+	                         G_TYPE_STRING, priv->fetch_cursor ? priv->fetch_cursor : "",
+	                         G_TYPE_UINT, FETCH_PAGE_SIZE,
+	                         G_TYPE_INVALID);
 }
 
 static gboolean
@@ -475,9 +756,18 @@ fetch_connections (gpointer user_data)
 
 	priv->fetch_id = 0;
 
-	dbus_g_proxy_begin_call (priv->proxy, "ListConnections",
-	                         fetch_connections_done, self, NULL,
-	                         G_TYPE_INVALID);
+	/* Prefer fetching all settings in a few large calls over one GetSettings
+	 * call per connection.
+	 */
+	if (priv->no_get_all_settings) {
+		dbus_g_proxy_begin_call (priv->proxy, "ListConnections",
+		                         fetch_connections_done, self, NULL,
+		                         G_TYPE_INVALID);
+	} else {
+		g_free (priv->fetch_cursor);
+		priv->fetch_cursor = NULL;
+		fetch_all_settings_page (self);
+	}
 	return FALSE;
 }
 
@@ -524,10 +814,20 @@ add_connection_done (DBusGProxy *proxy, DBusGProxyCall *call, gpointer user_data
 	char *path = NULL;
 
 	if (dbus_g_proxy_end_call (proxy, call, &error, DBUS_TYPE_G_OBJECT_PATH, &path, G_TYPE_INVALID)) {
+		NMRemoteSettingsPrivate *priv = NM_REMOTE_SETTINGS_GET_PRIVATE (info->self);
+
 		info->connection = new_connection_cb (proxy, path, info->self);
 		g_assert (info->connection);
-		/* Wait until this connection is fully initialized before calling the callback */
 		g_free (path);
+
+		/* A bulk fetch may already have created the connection, visible or
+		 * not; otherwise wait until it is fully initialized before calling
+		 * the callback.
+		 */
+		if (g_hash_table_lookup (priv->connections, nm_connection_get_path (NM_CONNECTION (info->connection))))
+			add_connection_info_complete (info->self, info, NULL);
+		else if (!g_hash_table_lookup_extended (priv->initializing, info->connection, NULL, NULL))
+			add_connection_info_fail_unavailable (info->self, info);
 	} else
 		add_connection_info_complete (info->self, info, error);
 
@@ -617,6 +917,7 @@ remove_connections (gpointer user_data)
 
 	clear_one_hash (priv->pending);
 	clear_one_hash (priv->connections);
+	index_clear (self);
 	return FALSE;
 }
 
@@ -744,6 +1045,8 @@ name_owner_changed (DBusGProxy *proxy,
 			g_source_remove (priv->fetch_id);
 
 		if (new_owner && strlen (new_owner) > 0) {
+			/* The new service may support GetAllSettings even if the old didn't */
+			priv->no_get_all_settings = FALSE;
 			priv->fetch_id = g_idle_add (fetch_connections, self);
 			priv->service_running = TRUE;
 
@@ -861,6 +1164,8 @@ forget_connection (gpointer user_data)
 	                                      0, 0, NULL, connection_removed_cb, NULL);
 	g_signal_handlers_disconnect_matched (remote, G_SIGNAL_MATCH_FUNC,
 	                                      0, 0, NULL, connection_visible_cb, NULL);
+	g_signal_handlers_disconnect_matched (remote, G_SIGNAL_MATCH_FUNC,
+	                                      0, 0, NULL, connection_updated_cb, NULL);
 	g_object_unref (remote);
 }
 
@@ -871,6 +1176,11 @@ nm_remote_settings_init (NMRemoteSettings *self)
 
 	priv->connections = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, forget_connection);
 	priv->pending = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, forget_connection);
+	priv->initializing = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+	priv->index = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, index_entry_free);
+	priv->by_uuid = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	priv->by_id = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_slist_free);
 }
 
 static void
@@ -1103,6 +1413,13 @@ dispose (GObject *object)
 	while (g_slist_length (priv->add_list))
 		add_connection_info_dispose (self, (AddConnectionInfo *) priv->add_list->data);
 
+	if (priv->index) {
+		g_hash_table_destroy (priv->index);
+		g_hash_table_destroy (priv->by_uuid);
+		g_hash_table_destroy (priv->by_id);
+		priv->index = NULL;
+	}
+
 	if (priv->connections) {
 		g_hash_table_destroy (priv->connections);
 		priv->connections = NULL;
@@ -1113,9 +1430,17 @@ dispose (GObject *object)
 		priv->pending = NULL;
 	}
 
+	if (priv->initializing) {
+		g_hash_table_destroy (priv->initializing);
+		priv->initializing = NULL;
+	}
+
 	g_free (priv->hostname);
 	priv->hostname = NULL;
 
+	g_free (priv->fetch_cursor);
+	priv->fetch_cursor = NULL;
+
 	g_clear_object (&priv->dbus_proxy);
 	g_clear_object (&priv->proxy);
 	g_clear_object (&priv->props_proxy);
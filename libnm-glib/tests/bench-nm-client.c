@@ -0,0 +1,359 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2012 Red Hat, Inc.
+ *
+ */
+
+/* Client-side benchmarks against mock-nm-service.py.  Not run by 'make
+ * check'; 'make bench' in this directory starts a private session bus and
+ * runs them there.  Measures NMClient and NMRemoteSettings initialization
+ * time, the memory held by a fully loaded NMClient, and how many access
+ * point property changes per second are turned into notifications.
+ *
+ * Usage: bench-nm-client SRCDIR SERVICE [DEVICES APS CONNECTIONS]
+ */
+
+#include <dbus/dbus.h>
+#include <dbus/dbus-glib.h>
+#include <dbus/dbus-glib-lowlevel.h>
+#include <glib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/types.h>
+#include <signal.h>
+
+#include <NetworkManager.h>
+
+#include "nm-client.h"
+#include "nm-device-wifi.h"
+#include "nm-access-point.h"
+#include "nm-remote-settings.h"
+#include "nm-object-cache.h"
+
+#define INIT_ITERATIONS 10
+#define CHANGE_RATE     2000
+#define CHANGE_SECONDS  5
+
+static GPid spid = 0;
+static DBusGConnection *bus = NULL;
+
+/*******************************************************************/
+
+static void
+cleanup (void)
+{
+	if (spid)
+		kill (spid, SIGTERM);
+}
+
+#define bench_assert(condition) \
+do { \
+	if (!G_LIKELY (condition)) \
+		cleanup (); \
+	g_assert (condition); \
+} while (0)
+
+/* Resident set size of this process, in KiB */
+static glong
+get_rss_kb (void)
+{
+	char *contents = NULL;
+	long pages = 0, resident = 0;
+
+	if (!g_file_get_contents ("/proc/self/statm", &contents, NULL, NULL))
+		return 0;
+	if (sscanf (contents, "%ld %ld", &pages, &resident) != 2)
+		resident = 0;
+	g_free (contents);
+	return resident * (sysconf (_SC_PAGESIZE) / 1024);
+}
+
+static void
+run_loop_for (guint ms)
+{
+	GMainLoop *loop;
+
+	loop = g_main_loop_new (NULL, FALSE);
+	g_timeout_add (ms, (GSourceFunc) g_main_loop_quit, loop);
+	g_main_loop_run (loop);
+	g_main_loop_unref (loop);
+}
+
+/* Touch everything a typical applet reads, so all objects get loaded */
+static guint
+walk_client (NMClient *client)
+{
+	const GPtrArray *devices, *aps;
+	guint i, j, n_aps = 0;
+
+	devices = nm_client_get_devices (client);
+	for (i = 0; devices && i < devices->len; i++) {
+		NMDevice *device = g_ptr_array_index (devices, i);
+
+		nm_device_get_state (device);
+		if (!NM_IS_DEVICE_WIFI (device))
+			continue;
+
+		aps = nm_device_wifi_get_access_points (NM_DEVICE_WIFI (device));
+		for (j = 0; aps && j < aps->len; j++) {
+			NMAccessPoint *ap = g_ptr_array_index (aps, j);
+
+			nm_access_point_get_ssid (ap);
+			nm_access_point_get_strength (ap);
+			n_aps++;
+		}
+	}
+	return n_aps;
+}
+
+static gboolean
+mock_call (const char *method, GType out_type, gpointer out_value, guint32 in_rate)
+{
+	DBusGProxy *proxy;
+	GError *error = NULL;
+	gboolean success;
+
+	proxy = dbus_g_proxy_new_for_name (bus,
+	                                   NM_DBUS_SERVICE,
+	                                   NM_DBUS_PATH,
+	                                   "org.freedesktop.NetworkManager.Mock");
+	if (out_type == G_TYPE_INVALID) {
+		success = dbus_g_proxy_call (proxy, method, &error,
+		                             G_TYPE_UINT, in_rate,
+		                             G_TYPE_INVALID,
+		                             G_TYPE_INVALID);
+	} else {
+		success = dbus_g_proxy_call (proxy, method, &error,
+		                             G_TYPE_INVALID,
+		                             out_type, out_value,
+		                             G_TYPE_INVALID);
+	}
+	if (!success) {
+		g_warning ("Mock call %s failed: %s", method, error->message);
+		g_error_free (error);
+	}
+	g_object_unref (proxy);
+	return success;
+}
+
+/*******************************************************************/
+
+static NMClient *
+new_client (void)
+{
+	NMClient *client;
+	GError *error = NULL;
+
+	/* nm_client_new() only talks to the system bus */
+	client = g_object_new (NM_TYPE_CLIENT,
+	                       NM_OBJECT_DBUS_CONNECTION, bus,
+	                       NM_OBJECT_DBUS_PATH, NM_DBUS_PATH,
+	                       NULL);
+	if (!g_initable_init (G_INITABLE (client), NULL, &error)) {
+		g_warning ("Error initializing NMClient: %s", error->message);
+		g_error_free (error);
+		g_object_unref (client);
+		return NULL;
+	}
+	return client;
+}
+
+static void
+bench_client_init (void)
+{
+	NMClient *client;
+	GTimer *timer;
+	double total = 0;
+	glong rss_before, rss_after;
+	NMObjectCacheStats stats;
+	guint i, n_aps = 0;
+
+	_nm_object_cache_reset_stats ();
+	for (i = 0; i < INIT_ITERATIONS; i++) {
+		timer = g_timer_new ();
+		client = new_client ();
+		bench_assert (client != NULL);
+		n_aps = walk_client (client);
+		total += g_timer_elapsed (timer, NULL);
+		g_timer_destroy (timer);
+		g_object_unref (client);
+	}
+
+	printf ("NMClient init + walk (%u APs): %.2f ms\n",
+	        n_aps, total * 1000 / INIT_ITERATIONS);
+
+	_nm_object_cache_get_stats (&stats);
+	printf ("Object cache: %u hits, %u misses, %u stale, %u evictions, %u entries left\n",
+	        stats.hits, stats.misses, stats.stale, stats.evictions, stats.size);
+
+	rss_before = get_rss_kb ();
+	client = new_client ();
+	bench_assert (client != NULL);
+	walk_client (client);
+	rss_after = get_rss_kb ();
+	printf ("NMClient resident memory: %ld KiB\n", rss_after - rss_before);
+	g_object_unref (client);
+}
+
+static void
+connections_read (NMRemoteSettings *settings, gpointer user_data)
+{
+	*((gboolean *) user_data) = TRUE;
+}
+
+static void
+bench_settings_init (void)
+{
+	NMRemoteSettings *settings;
+	GSList *list;
+	GTimer *timer;
+	double total = 0;
+	gboolean done;
+	guint i, n_connections = 0;
+
+	for (i = 0; i < INIT_ITERATIONS; i++) {
+		timer = g_timer_new ();
+		settings = nm_remote_settings_new (bus);
+		bench_assert (settings != NULL);
+
+		done = FALSE;
+		g_signal_connect (settings, NM_REMOTE_SETTINGS_CONNECTIONS_READ,
+		                  G_CALLBACK (connections_read), &done);
+		while (!done && g_timer_elapsed (timer, NULL) < 30)
+			g_main_context_iteration (NULL, TRUE);
+		bench_assert (done == TRUE);
+
+		total += g_timer_elapsed (timer, NULL);
+		g_timer_destroy (timer);
+
+		list = nm_remote_settings_list_connections (settings);
+		n_connections = g_slist_length (list);
+		g_slist_free (list);
+		g_object_unref (settings);
+	}
+
+	printf ("NMRemoteSettings init (%u connections): %.2f ms\n",
+	        n_connections, total * 1000 / INIT_ITERATIONS);
+}
+
+static void
+strength_changed (GObject *object, GParamSpec *pspec, gpointer user_data)
+{
+	(*((guint *) user_data))++;
+}
+
+static void
+bench_change_throughput (void)
+{
+	NMClient *client;
+	const GPtrArray *devices, *aps;
+	guint i, j, notified = 0, emitted = 0;
+	GTimer *timer;
+	clock_t cpu_start;
+	double elapsed, cpu;
+
+	client = new_client ();
+	bench_assert (client != NULL);
+
+	devices = nm_client_get_devices (client);
+	for (i = 0; devices && i < devices->len; i++) {
+		NMDevice *device = g_ptr_array_index (devices, i);
+
+		if (!NM_IS_DEVICE_WIFI (device))
+			continue;
+		aps = nm_device_wifi_get_access_points (NM_DEVICE_WIFI (device));
+		for (j = 0; aps && j < aps->len; j++) {
+			g_signal_connect (g_ptr_array_index (aps, j), "notify::" NM_ACCESS_POINT_STRENGTH,
+			                  G_CALLBACK (strength_changed), &notified);
+		}
+	}
+
+	timer = g_timer_new ();
+	cpu_start = clock ();
+	bench_assert (mock_call ("SetChangeRate", G_TYPE_INVALID, NULL, CHANGE_RATE));
+	run_loop_for (CHANGE_SECONDS * 1000);
+	bench_assert (mock_call ("SetChangeRate", G_TYPE_INVALID, NULL, 0));
+	/* Let queued changes and throttled notifications drain */
+	run_loop_for (1000);
+	elapsed = g_timer_elapsed (timer, NULL);
+	cpu = (double) (clock () - cpu_start) / CLOCKS_PER_SEC;
+	g_timer_destroy (timer);
+
+	bench_assert (mock_call ("GetEmittedChanges", G_TYPE_UINT, &emitted, 0));
+
+	printf ("AP strength changes: %u emitted (%.0f/s), %u notifications, client CPU %.2f s\n",
+	        emitted, emitted / elapsed, notified, cpu);
+
+	g_object_unref (client);
+}
+
+/*******************************************************************/
+
+int main (int argc, char **argv)
+{
+	char *service_argv[9] = { NULL };
+	GError *error = NULL;
+	int i = 500;
+
+	if (argc != 3 && argc != 6) {
+		fprintf (stderr, "Usage: %s SRCDIR SERVICE [DEVICES APS CONNECTIONS]\n", argv[0]);
+		return 1;
+	}
+
+	g_type_init ();
+
+	bus = dbus_g_bus_get (DBUS_BUS_SESSION, &error);
+	if (!bus) {
+		g_warning ("Error connecting to D-Bus: %s", error->message);
+		g_assert (error == NULL);
+	}
+
+	service_argv[0] = g_strdup_printf ("%s/%s", argv[1], argv[2]);
+	if (argc == 6) {
+		service_argv[1] = g_strdup_printf ("--devices=%s", argv[3]);
+		service_argv[2] = g_strdup_printf ("--aps=%s", argv[4]);
+		service_argv[3] = g_strdup_printf ("--connections=%s", argv[5]);
+	}
+	if (!g_spawn_async (argv[1], service_argv, NULL, 0, NULL, NULL, &spid, &error)) {
+		g_warning ("Error spawning %s: %s", argv[2], error->message);
+		g_assert (error == NULL);
+	}
+
+	/* Wait until the service is registered on the bus; building a large
+	 * object graph in python takes a while.
+	 */
+	while (i > 0) {
+		g_usleep (G_USEC_PER_SEC / 50);
+		if (dbus_bus_name_has_owner (dbus_g_connection_get_connection (bus),
+		                             NM_DBUS_SERVICE,
+		                             NULL))
+			break;
+		i--;
+	}
+	bench_assert (i > 0);
+
+	bench_client_init ();
+	bench_settings_init ();
+	bench_change_throughput ();
+
+	cleanup ();
+	return 0;
+}
+
@@ -0,0 +1,386 @@
+#!/usr/bin/env python
+# -*- Mode: python; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+#
+# Stand-in NetworkManager daemon for client performance tests.  It claims
+# org.freedesktop.NetworkManager on the session bus (run it under a private
+# dbus-launch session) and exposes a configurable number of WiFi devices,
+# access points and saved connections, with just enough of the D-Bus API for
+# NMClient and NMRemoteSettings to initialize against it.
+#
+# Access point signal strength changes are generated at a rate that can be
+# set on the command line or at runtime through the
+# org.freedesktop.NetworkManager.Mock interface on the manager object.
+
+import glib
+import gobject
+import sys
+import random
+import optparse
+import dbus
+import dbus.service
+import dbus.mainloop.glib
+
+NM_PATH = '/org/freedesktop/NetworkManager'
+IFACE_NM = 'org.freedesktop.NetworkManager'
+IFACE_DEVICE = 'org.freedesktop.NetworkManager.Device'
+IFACE_WIFI = 'org.freedesktop.NetworkManager.Device.Wireless'
+IFACE_AP = 'org.freedesktop.NetworkManager.AccessPoint'
+IFACE_SETTINGS = 'org.freedesktop.NetworkManager.Settings'
+IFACE_CONNECTION = 'org.freedesktop.NetworkManager.Settings.Connection'
+IFACE_MOCK = 'org.freedesktop.NetworkManager.Mock'
+IFACE_DBUS = 'org.freedesktop.DBus'
+
+NM_STATE_CONNECTED_GLOBAL = 70
+NM_DEVICE_TYPE_WIFI = 2
+NM_DEVICE_STATE_DISCONNECTED = 30
+NM_802_11_MODE_INFRA = 2
+NM_802_11_AP_FLAGS_PRIVACY = 0x1
+NM_802_11_AP_SEC_KEY_MGMT_PSK = 0x100
+
+class UnknownInterfaceException(dbus.DBusException):
+    _dbus_error_name = IFACE_DBUS + '.UnknownInterface'
+
+class UnknownPropertyException(dbus.DBusException):
+    _dbus_error_name = IFACE_DBUS + '.UnknownProperty'
+
+mainloop = gobject.MainLoop()
+
+# Properties calls received, so tests can check what a client asked for
+call_counts = { 'Get': 0, 'GetAll': 0 }
+
+class ExportedObject(dbus.service.Object):
+    """An object whose properties are kept per interface, served through
+    org.freedesktop.DBus.Properties and flattened for GetObjectTree()."""
+
+    def __init__(self, bus, object_path):
+        dbus.service.Object.__init__(self, bus, object_path)
+        self.path = object_path
+        self.props = {}
+
+    def flat_props(self):
+        props = dbus.Dictionary({}, signature='sv')
+        for iface_props in self.props.values():
+            props.update(iface_props)
+        return props
+
+    @dbus.service.method(dbus_interface=dbus.PROPERTIES_IFACE, in_signature='s', out_signature='a{sv}')
+    def GetAll(self, iface):
+        call_counts['GetAll'] += 1
+        if not iface in self.props:
+            raise UnknownInterfaceException()
+        return dbus.Dictionary(self.props[iface], signature='sv')
+
+    @dbus.service.method(dbus_interface=dbus.PROPERTIES_IFACE, in_signature='ss', out_signature='v')
+    def Get(self, iface, name):
+        call_counts['Get'] += 1
+        if not iface in self.props:
+            raise UnknownInterfaceException()
+        if not name in self.props[iface]:
+            raise UnknownPropertyException()
+        return self.props[iface][name]
+
+class AccessPoint(ExportedObject):
+    def __init__(self, bus, object_path, index):
+        ExportedObject.__init__(self, bus, object_path)
+        ssid = "mock-ap-%d" % index
+        self.props[IFACE_AP] = {
+            'Flags': dbus.UInt32(NM_802_11_AP_FLAGS_PRIVACY),
+            'WpaFlags': dbus.UInt32(0),
+            'RsnFlags': dbus.UInt32(NM_802_11_AP_SEC_KEY_MGMT_PSK),
+            'Ssid': dbus.Array([dbus.Byte(ord(c)) for c in ssid], signature='y'),
+            'Frequency': dbus.UInt32(random.choice([2412, 2437, 2462, 5180, 5240])),
+            'HwAddress': "02:00:%02X:%02X:%02X:%02X" % ((index >> 24) & 0xFF, (index >> 16) & 0xFF,
+                                                         (index >> 8) & 0xFF, index & 0xFF),
+            'Mode': dbus.UInt32(NM_802_11_MODE_INFRA),
+            'MaxBitrate': dbus.UInt32(54000),
+            'Strength': dbus.Byte(random.randint(10, 100)),
+        }
+
+    def change_strength(self, strength=None):
+        if strength is None:
+            strength = random.randint(10, 100)
+        strength = dbus.Byte(strength)
+        self.props[IFACE_AP]['Strength'] = strength
+        self.PropertiesChanged({'Strength': strength})
+
+    @dbus.service.signal(IFACE_AP, signature='a{sv}')
+    def PropertiesChanged(self, changed):
+        pass
+
+class WifiDevice(ExportedObject):
+    def __init__(self, bus, object_path, index, aps):
+        ExportedObject.__init__(self, bus, object_path)
+        self.aps = aps
+        self.props[IFACE_DEVICE] = {
+            'Udi': "/sys/devices/mock/net/wlan%d" % index,
+            'Interface': "wlan%d" % index,
+            'IpInterface': "",
+            'Driver': "mock",
+            'DriverVersion': "1.0",
+            'FirmwareVersion': "1.0",
+            'Capabilities': dbus.UInt32(1),
+            'Ip4Address': dbus.UInt32(0),
+            'State': dbus.UInt32(NM_DEVICE_STATE_DISCONNECTED),
+            'StateReason': dbus.Struct((dbus.UInt32(NM_DEVICE_STATE_DISCONNECTED), dbus.UInt32(0)), signature='uu'),
+            'ActiveConnection': dbus.ObjectPath("/"),
+            'Ip4Config': dbus.ObjectPath("/"),
+            'Dhcp4Config': dbus.ObjectPath("/"),
+            'Ip6Config': dbus.ObjectPath("/"),
+            'Dhcp6Config': dbus.ObjectPath("/"),
+            'Managed': True,
+            'Autoconnect': True,
+            'FirmwareMissing': False,
+            'DeviceType': dbus.UInt32(NM_DEVICE_TYPE_WIFI),
+        }
+        self.props[IFACE_WIFI] = {
+            'HwAddress': "02:01:00:00:00:%02X" % (index & 0xFF),
+            'PermHwAddress': "02:01:00:00:00:%02X" % (index & 0xFF),
+            'Mode': dbus.UInt32(NM_802_11_MODE_INFRA),
+            'Bitrate': dbus.UInt32(0),
+            'ActiveAccessPoint': dbus.ObjectPath("/"),
+            'WirelessCapabilities': dbus.UInt32(0),
+        }
+
+    def ap_paths(self):
+        return dbus.Array([dbus.ObjectPath(ap.path) for ap in self.aps], signature='o')
+
+    def flat_props(self):
+        props = ExportedObject.flat_props(self)
+        props['AccessPoints'] = self.ap_paths()
+        return props
+
+    @dbus.service.method(dbus_interface=IFACE_WIFI, in_signature='', out_signature='ao')
+    def GetAccessPoints(self):
+        return self.ap_paths()
+
+    @dbus.service.signal(IFACE_WIFI, signature='o')
+    def AccessPointAdded(self, path):
+        pass
+
+    @dbus.service.signal(IFACE_WIFI, signature='o')
+    def AccessPointRemoved(self, path):
+        pass
+
+    @dbus.service.signal(IFACE_WIFI, signature='a{sv}')
+    def PropertiesChanged(self, changed):
+        pass
+
+class Connection(dbus.service.Object):
+    def __init__(self, bus, object_path, index):
+        dbus.service.Object.__init__(self, bus, object_path)
+        self.path = object_path
+        ssid = "mock-ap-%d" % index
+        self.settings = dbus.Dictionary({
+            'connection': dbus.Dictionary({
+                'id': "mock-connection-%d" % index,
+                'uuid': "a8b1e1f4-0000-4000-8000-%012x" % index,
+                'type': "802-11-wireless",
+            }, signature='sv'),
+            '802-11-wireless': dbus.Dictionary({
+                'ssid': dbus.Array([dbus.Byte(ord(c)) for c in ssid], signature='y'),
+                'mode': "infrastructure",
+            }, signature='sv'),
+            'ipv4': dbus.Dictionary({ 'method': "auto" }, signature='sv'),
+        }, signature='sa{sv}')
+
+    @dbus.service.method(dbus_interface=IFACE_CONNECTION, in_signature='', out_signature='a{sa{sv}}')
+    def GetSettings(self):
+        return self.settings
+
+    @dbus.service.signal(IFACE_CONNECTION, signature='')
+    def Removed(self):
+        pass
+
+    @dbus.service.signal(IFACE_CONNECTION, signature='')
+    def Updated(self):
+        pass
+
+class Settings(ExportedObject):
+    def __init__(self, bus, object_path, n_connections):
+        ExportedObject.__init__(self, bus, object_path)
+        self.props[IFACE_SETTINGS] = {
+            'Hostname': "mock.example.com",
+            'CanModify': True,
+        }
+        self.connections = {}
+        for i in range(n_connections):
+            path = "%s/Settings/%d" % (NM_PATH, i)
+            self.connections[path] = Connection(bus, path, i)
+
+    @dbus.service.method(dbus_interface=IFACE_SETTINGS, in_signature='', out_signature='ao')
+    def ListConnections(self):
+        return dbus.Array(self.connections.keys(), signature='o')
+
+    @dbus.service.method(dbus_interface=IFACE_SETTINGS, in_signature='su', out_signature='a{sa{sa{sv}}}s')
+    def GetAllSettings(self, after, limit):
+        key = lambda p: (len(p), p)
+        paths = sorted(self.connections.keys(), key=key)
+        if after:
+            paths = [p for p in paths if key(p) > key(after)]
+        cursor = ""
+        if limit > 0 and limit < len(paths):
+            paths = paths[:limit]
+            cursor = paths[-1]
+        page = dbus.Dictionary({}, signature='sa{sa{sv}}')
+        for path in paths:
+            page[path] = self.connections[path].settings
+        return (page, cursor)
+
+    @dbus.service.signal(IFACE_SETTINGS, signature='o')
+    def NewConnection(self, path):
+        pass
+
+class Manager(ExportedObject):
+    def __init__(self, bus, options):
+        ExportedObject.__init__(self, bus, NM_PATH)
+        self.object_tree = options.object_tree
+        self.props[IFACE_NM] = {
+            'Version': "0.9.mock",
+            'State': dbus.UInt32(NM_STATE_CONNECTED_GLOBAL),
+            'NetworkingEnabled': True,
+            'WirelessEnabled': True,
+            'WirelessHardwareEnabled': True,
+            'WwanEnabled': False,
+            'WwanHardwareEnabled': False,
+            'WimaxEnabled': False,
+            'WimaxHardwareEnabled': False,
+            'ActiveConnections': dbus.Array([], signature='o'),
+        }
+
+        self.devices = []
+        self.aps = []
+        for d in range(options.devices):
+            aps = []
+            for a in range(options.aps):
+                index = d * options.aps + a
+                aps.append(AccessPoint(bus, "%s/AccessPoint/%d" % (NM_PATH, index), index))
+            self.aps.extend(aps)
+            self.devices.append(WifiDevice(bus, "%s/Devices/%d" % (NM_PATH, d), d, aps))
+
+        self.settings = Settings(bus, NM_PATH + "/Settings", options.connections)
+
+        self.emitted = 0
+        self.tree_strength = None
+        self.next_ap = 0
+        self.change_id = 0
+        self.set_change_rate(options.rate)
+
+    def set_change_rate(self, rate):
+        if self.change_id:
+            gobject.source_remove(self.change_id)
+            self.change_id = 0
+        self.batch = 0
+        if rate > 0 and len(self.aps) > 0:
+            # Fire at most every 10ms and change several APs per tick if needed
+            interval = max(10, 1000 / rate)
+            self.batch = max(1, rate * interval / 1000)
+            self.change_id = gobject.timeout_add(interval, self.change_cb)
+
+    def change_cb(self):
+        for i in range(self.batch):
+            self.aps[self.next_ap].change_strength()
+            self.next_ap = (self.next_ap + 1) % len(self.aps)
+            self.emitted += 1
+        return True
+
+    def device_paths(self):
+        return dbus.Array([dbus.ObjectPath(dev.path) for dev in self.devices], signature='o')
+
+    @dbus.service.method(dbus_interface=IFACE_NM, in_signature='', out_signature='ao')
+    def GetDevices(self):
+        return self.device_paths()
+
+    @dbus.service.method(dbus_interface=IFACE_NM, in_signature='', out_signature='a{sa{sv}}')
+    def GetObjectTree(self):
+        if not self.object_tree:
+            raise dbus.DBusException('GetObjectTree is disabled', name=IFACE_DBUS + '.Error.UnknownMethod')
+        objects = dbus.Dictionary({}, signature='sa{sv}')
+        props = self.flat_props()
+        props['Devices'] = self.device_paths()
+        objects[NM_PATH] = props
+        for dev in self.devices:
+            objects[dev.path] = dev.flat_props()
+        for ap in self.aps:
+            objects[ap.path] = ap.flat_props()
+        if self.tree_strength is not None and len(self.aps) > 0:
+            # Runs once the reply has been sent
+            gobject.idle_add(self.aps[0].change_strength, self.tree_strength)
+            self.tree_strength = None
+        return objects
+
+    @dbus.service.method(dbus_interface=IFACE_NM, in_signature='', out_signature='a{ss}')
+    def GetPermissions(self):
+        return dbus.Dictionary({}, signature='ss')
+
+    @dbus.service.signal(IFACE_NM, signature='o')
+    def DeviceAdded(self, path):
+        pass
+
+    @dbus.service.signal(IFACE_NM, signature='o')
+    def DeviceRemoved(self, path):
+        pass
+
+    @dbus.service.signal(IFACE_NM, signature='a{sv}')
+    def PropertiesChanged(self, changed):
+        pass
+
+    @dbus.service.method(dbus_interface=IFACE_MOCK, in_signature='u', out_signature='')
+    def SetChangeRate(self, rate):
+        self.set_change_rate(rate)
+
+    @dbus.service.method(dbus_interface=IFACE_MOCK, in_signature='', out_signature='u')
+    def GetEmittedChanges(self):
+        return dbus.UInt32(self.emitted)
+
+    @dbus.service.method(dbus_interface=IFACE_MOCK, in_signature='', out_signature='uu')
+    def GetCallCounts(self):
+        counts = (dbus.UInt32(call_counts['Get']), dbus.UInt32(call_counts['GetAll']))
+        call_counts['Get'] = call_counts['GetAll'] = 0
+        return counts
+
+    @dbus.service.method(dbus_interface=IFACE_MOCK, in_signature='y', out_signature='')
+    def ChangeAfterObjectTree(self, strength):
+        # Change the first AP's strength right after the next GetObjectTree()
+        self.tree_strength = strength
+
+    @dbus.service.method(dbus_interface=IFACE_MOCK, in_signature='', out_signature='')
+    def Quit(self):
+        mainloop.quit()
+
+def quit_cb(user_data):
+    mainloop.quit()
+
+def main():
+    parser = optparse.OptionParser()
+    parser.add_option("--devices", type="int", default=4, help="number of WiFi devices")
+    parser.add_option("--aps", type="int", default=50, help="access points per device")
+    parser.add_option("--connections", type="int", default=200, help="saved connections")
+    parser.add_option("--rate", type="int", default=0, help="AP strength changes per second")
+    parser.add_option("--timeout", type="int", default=300, help="seconds before exiting")
+    parser.add_option("--no-object-tree", dest="object_tree", action="store_false", default=True,
+                      help="behave like a NetworkManager without GetObjectTree()")
+    (options, args) = parser.parse_args()
+
+    random.seed(0)
+    dbus.mainloop.glib.DBusGMainLoop(set_as_default=True)
+
+    bus = dbus.SessionBus()
+    manager = Manager(bus, options)
+    if not bus.request_name("org.freedesktop.NetworkManager"):
+        sys.exit(1)
+
+    print "Mock service started: %d devices, %d access points, %d connections" % \
+        (len(manager.devices), len(manager.aps), len(manager.settings.connections))
+
+    gobject.timeout_add_seconds(options.timeout, quit_cb, None)
+
+    try:
+        mainloop.run()
+    except Exception, e:
+        pass
+
+    print "Mock service stopped"
+    sys.exit(0)
+
+if __name__ == '__main__':
+    main()
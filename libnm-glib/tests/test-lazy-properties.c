@@ -0,0 +1,193 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2012 Red Hat, Inc.
+ *
+ */
+
+#include <dbus/dbus-glib.h>
+#include <glib.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+#include <nm-utils.h>
+
+#include "nm-ip4-config.h"
+#include "nm-object-private.h"
+#include "nm-dbus-glib-types.h"
+
+#define IP4_CONFIG_PATH "/org/freedesktop/NetworkManager/IP4Config/1"
+
+static DBusGConnection *bus = NULL;
+
+/* Objects are only constructed, never initialized, so nothing needs to
+ * answer on the bus; their properties are fed in directly.
+ */
+static NMIP4Config *
+new_config (void)
+{
+	return g_object_new (NM_TYPE_IP4_CONFIG,
+	                     NM_OBJECT_DBUS_CONNECTION, bus,
+	                     NM_OBJECT_DBUS_PATH, IP4_CONFIG_PATH,
+	                     NULL);
+}
+
+static void
+value_destroy (gpointer data)
+{
+	GValue *value = data;
+
+	g_value_unset (value);
+	g_slice_free (GValue, value);
+}
+
+/* Returns the a{sv} a PropertiesChanged signal would carry for a config
+ * with two addresses and two nameservers.
+ */
+static GHashTable *
+new_properties (void)
+{
+	GHashTable *props;
+	GValue *value;
+	GSList *addresses = NULL;
+	NMIP4Address *addr;
+	GArray *nameservers;
+	guint32 ns;
+	guint i;
+
+	props = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, value_destroy);
+
+	for (i = 1; i <= 2; i++) {
+		addr = nm_ip4_address_new ();
+		nm_ip4_address_set_address (addr, htonl (0xc0a80000 + i));
+		nm_ip4_address_set_prefix (addr, 24);
+		nm_ip4_address_set_gateway (addr, htonl (0xc0a800fe));
+		addresses = g_slist_append (addresses, addr);
+	}
+	value = g_slice_new0 (GValue);
+	g_value_init (value, DBUS_TYPE_G_ARRAY_OF_ARRAY_OF_UINT);
+	nm_utils_ip4_addresses_to_gvalue (addresses, value);
+	g_hash_table_insert (props, "Addresses", value);
+	g_slist_foreach (addresses, (GFunc) nm_ip4_address_unref, NULL);
+	g_slist_free (addresses);
+
+	nameservers = g_array_new (FALSE, TRUE, sizeof (guint32));
+	for (i = 1; i <= 2; i++) {
+		ns = htonl (0x08080800 + i);
+		g_array_append_val (nameservers, ns);
+	}
+	value = g_slice_new0 (GValue);
+	g_value_init (value, DBUS_TYPE_G_UINT_ARRAY);
+	g_value_take_boxed (value, nameservers);
+	g_hash_table_insert (props, "Nameservers", value);
+
+	return props;
+}
+
+static void
+test_untouched (void)
+{
+	NMIP4Config *config;
+	GHashTable *props;
+	GValue *value;
+	guint base;
+
+	_nm_object_set_lazy_properties_enabled (TRUE);
+	base = _nm_object_get_lazy_demarshal_count ();
+
+	config = new_config ();
+	props = new_properties ();
+	_nm_object_process_properties_changed (NM_OBJECT (config), props);
+
+	/* The raw values were taken over rather than copied... */
+	value = g_hash_table_lookup (props, "Addresses");
+	g_assert (!G_VALUE_HOLDS (value, DBUS_TYPE_G_ARRAY_OF_ARRAY_OF_UINT));
+	value = g_hash_table_lookup (props, "Nameservers");
+	g_assert (!G_VALUE_HOLDS (value, DBUS_TYPE_G_UINT_ARRAY));
+	g_hash_table_destroy (props);
+
+	/* ...and nothing was demarshalled yet */
+	g_assert_cmpuint (_nm_object_get_lazy_demarshal_count (), ==, base);
+
+	/* Reading one property only converts that one */
+	g_assert (nm_ip4_config_get_nameservers (config) != NULL);
+	g_assert_cmpuint (_nm_object_get_lazy_demarshal_count (), ==, base + 1);
+	g_assert (nm_ip4_config_get_nameservers (config) != NULL);
+	g_assert_cmpuint (_nm_object_get_lazy_demarshal_count (), ==, base + 1);
+
+	/* A value that is never read is dropped unconverted */
+	g_object_unref (config);
+	g_assert_cmpuint (_nm_object_get_lazy_demarshal_count (), ==, base + 1);
+}
+
+static void
+test_matches_eager (void)
+{
+	NMIP4Config *lazy, *eager;
+	GHashTable *props;
+	const GSList *a, *b;
+	const GArray *ns_a, *ns_b;
+	guint base;
+
+	_nm_object_set_lazy_properties_enabled (FALSE);
+	base = _nm_object_get_lazy_demarshal_count ();
+	eager = new_config ();
+	props = new_properties ();
+	_nm_object_process_properties_changed (NM_OBJECT (eager), props);
+	g_hash_table_destroy (props);
+
+	_nm_object_set_lazy_properties_enabled (TRUE);
+	lazy = new_config ();
+	props = new_properties ();
+	_nm_object_process_properties_changed (NM_OBJECT (lazy), props);
+	g_hash_table_destroy (props);
+
+	a = nm_ip4_config_get_addresses (lazy);
+	b = nm_ip4_config_get_addresses (eager);
+	g_assert_cmpuint (g_slist_length ((GSList *) a), ==, 2);
+	g_assert_cmpuint (g_slist_length ((GSList *) b), ==, 2);
+	for (; a && b; a = a->next, b = b->next)
+		g_assert (nm_ip4_address_compare (a->data, b->data));
+
+	ns_a = nm_ip4_config_get_nameservers (lazy);
+	ns_b = nm_ip4_config_get_nameservers (eager);
+	g_assert (ns_a && ns_b);
+	g_assert_cmpuint (ns_a->len, ==, ns_b->len);
+	g_assert (memcmp (ns_a->data, ns_b->data, ns_a->len * sizeof (guint32)) == 0);
+
+	/* Only the lazy object converted anything on access */
+	g_assert_cmpuint (_nm_object_get_lazy_demarshal_count (), ==, base + 2);
+
+	g_object_unref (lazy);
+	g_object_unref (eager);
+}
+
+int
+main (int argc, char **argv)
+{
+	GError *error = NULL;
+
+	g_type_init ();
+	g_test_init (&argc, &argv, NULL);
+
+	bus = dbus_g_bus_get (DBUS_BUS_SESSION, &error);
+	g_assert_no_error (error);
+
+	g_test_add_func ("/lazy-properties/untouched", test_untouched);
+	g_test_add_func ("/lazy-properties/matches-eager", test_matches_eager);
+
+	return g_test_run ();
+}
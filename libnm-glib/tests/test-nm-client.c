@@ -0,0 +1,275 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2012 Red Hat, Inc.
+ *
+ */
+
+/* NMClient initialization against mock-nm-service.py, which answers
+ * GetObjectTree() and counts the Properties calls it receives.
+ */
+
+#include <dbus/dbus.h>
+#include <dbus/dbus-glib.h>
+#include <dbus/dbus-glib-lowlevel.h>
+#include <glib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <signal.h>
+
+#include <NetworkManager.h>
+
+#include "nm-client.h"
+#include "nm-device-wifi.h"
+#include "nm-access-point.h"
+
+#define N_DEVICES 2
+#define N_APS     3
+
+#define FIRST_AP_PATH NM_DBUS_PATH "/AccessPoint/0"
+
+static GPid spid = 0;
+static DBusGConnection *bus = NULL;
+
+/*******************************************************************/
+
+static void
+cleanup (void)
+{
+	kill (spid, SIGTERM);
+}
+
+#define test_assert(condition) \
+do { \
+	if (!G_LIKELY (condition)) \
+		cleanup (); \
+	g_assert (condition); \
+} while (0)
+
+static DBusGProxy *
+mock_proxy (void)
+{
+	return dbus_g_proxy_new_for_name (bus,
+	                                  NM_DBUS_SERVICE,
+	                                  NM_DBUS_PATH,
+	                                  "org.freedesktop.NetworkManager.Mock");
+}
+
+/* Returns the Get and GetAll calls since the last time, and resets them */
+static void
+get_call_counts (guint *get, guint *get_all)
+{
+	DBusGProxy *proxy = mock_proxy ();
+	GError *error = NULL;
+
+	dbus_g_proxy_call (proxy, "GetCallCounts", &error,
+	                   G_TYPE_INVALID,
+	                   G_TYPE_UINT, get,
+	                   G_TYPE_UINT, get_all,
+	                   G_TYPE_INVALID);
+	test_assert (error == NULL);
+	g_object_unref (proxy);
+}
+
+static NMClient *
+new_client (void)
+{
+	NMClient *client;
+	GError *error = NULL;
+
+	/* nm_client_new() only talks to the system bus */
+	client = g_object_new (NM_TYPE_CLIENT,
+	                       NM_OBJECT_DBUS_CONNECTION, bus,
+	                       NM_OBJECT_DBUS_PATH, NM_DBUS_PATH,
+	                       NULL);
+	g_initable_init (G_INITABLE (client), NULL, &error);
+	test_assert (error == NULL);
+	return client;
+}
+
+static void
+client_inited (GObject *object, GAsyncResult *result, gpointer user_data)
+{
+	GError *error = NULL;
+
+	g_async_initable_init_finish (G_ASYNC_INITABLE (object), result, &error);
+	test_assert (error == NULL);
+	g_main_loop_quit (user_data);
+}
+
+static NMClient *
+new_client_async (void)
+{
+	NMClient *client;
+	GMainLoop *loop;
+
+	loop = g_main_loop_new (NULL, FALSE);
+	client = g_object_new (NM_TYPE_CLIENT,
+	                       NM_OBJECT_DBUS_CONNECTION, bus,
+	                       NM_OBJECT_DBUS_PATH, NM_DBUS_PATH,
+	                       NULL);
+	g_async_initable_init_async (G_ASYNC_INITABLE (client), G_PRIORITY_DEFAULT,
+	                             NULL, client_inited, loop);
+	g_main_loop_run (loop);
+	g_main_loop_unref (loop);
+	return client;
+}
+
+static void
+run_loop_for (guint ms)
+{
+	GMainLoop *loop;
+
+	loop = g_main_loop_new (NULL, FALSE);
+	g_timeout_add (ms, (GSourceFunc) g_main_loop_quit, loop);
+	g_main_loop_run (loop);
+	g_main_loop_unref (loop);
+}
+
+/* Checks the client sees every device and AP, and returns the first AP */
+static NMAccessPoint *
+check_client (NMClient *client)
+{
+	const GPtrArray *devices, *aps;
+	NMAccessPoint *first = NULL;
+	guint i, j;
+
+	devices = nm_client_get_devices (client);
+	test_assert (devices != NULL);
+	test_assert (devices->len == N_DEVICES);
+
+	for (i = 0; i < devices->len; i++) {
+		NMDevice *device = g_ptr_array_index (devices, i);
+
+		test_assert (NM_IS_DEVICE_WIFI (device));
+		test_assert (nm_device_get_device_type (device) == NM_DEVICE_TYPE_WIFI);
+
+		aps = nm_device_wifi_get_access_points (NM_DEVICE_WIFI (device));
+		test_assert (aps != NULL);
+		test_assert (aps->len == N_APS);
+		for (j = 0; j < aps->len; j++) {
+			NMAccessPoint *ap = g_ptr_array_index (aps, j);
+
+			test_assert (nm_access_point_get_ssid (ap) != NULL);
+			if (!strcmp (nm_object_get_path (NM_OBJECT (ap)), FIRST_AP_PATH))
+				first = ap;
+		}
+	}
+
+	test_assert (first != NULL);
+	return first;
+}
+
+/*******************************************************************/
+
+static void
+test_object_tree (void)
+{
+	NMClient *client;
+	guint get, get_all;
+
+	get_call_counts (&get, &get_all);
+
+	/* Everything, including the device types, comes from the tree */
+	client = new_client ();
+	check_client (client);
+	get_call_counts (&get, &get_all);
+	test_assert (get == 0);
+	test_assert (get_all == 0);
+	g_object_unref (client);
+
+	client = new_client_async ();
+	check_client (client);
+	get_call_counts (&get, &get_all);
+	test_assert (get == 0);
+	test_assert (get_all == 0);
+	g_object_unref (client);
+}
+
+static void
+test_change_after_tree (void)
+{
+	DBusGProxy *proxy;
+	NMClient *client;
+	NMAccessPoint *ap;
+	GError *error = NULL;
+
+	/* A change sent right after the GetObjectTree() reply, before the
+	 * client has a proxy for the AP, must not be lost.
+	 */
+	proxy = mock_proxy ();
+	dbus_g_proxy_call (proxy, "ChangeAfterObjectTree", &error,
+	                   G_TYPE_UCHAR, 1,
+	                   G_TYPE_INVALID,
+	                   G_TYPE_INVALID);
+	test_assert (error == NULL);
+	g_object_unref (proxy);
+
+	client = new_client ();
+	run_loop_for (500);
+	ap = check_client (client);
+	test_assert (nm_access_point_get_strength (ap) == 1);
+	g_object_unref (client);
+}
+
+/*******************************************************************/
+
+int main (int argc, char **argv)
+{
+	char *service_argv[5] = { NULL };
+	GError *error = NULL;
+	int ret, i = 100;
+
+	g_assert (argc == 3);
+
+	g_type_init ();
+	g_test_init (&argc, &argv, NULL);
+
+	bus = dbus_g_bus_get (DBUS_BUS_SESSION, &error);
+	if (!bus) {
+		g_warning ("Error connecting to D-Bus: %s", error->message);
+		g_assert (error == NULL);
+	}
+
+	service_argv[0] = g_strdup_printf ("%s/%s", argv[1], argv[2]);
+	service_argv[1] = g_strdup_printf ("--devices=%d", N_DEVICES);
+	service_argv[2] = g_strdup_printf ("--aps=%d", N_APS);
+	service_argv[3] = g_strdup ("--connections=1");
+	if (!g_spawn_async (argv[1], service_argv, NULL, 0, NULL, NULL, &spid, &error)) {
+		g_warning ("Error spawning %s: %s", argv[2], error->message);
+		g_assert (error == NULL);
+	}
+
+	/* Wait until the service is registered on the bus */
+	while (i > 0) {
+		g_usleep (G_USEC_PER_SEC / 50);
+		if (dbus_bus_name_has_owner (dbus_g_connection_get_connection (bus),
+		                             NM_DBUS_SERVICE,
+		                             NULL))
+			break;
+		i--;
+	}
+	test_assert (i > 0);
+
+	g_test_add_func ("/client/object-tree", test_object_tree);
+	g_test_add_func ("/client/change-after-tree", test_change_after_tree);
+
+	ret = g_test_run ();
+
+	cleanup ();
+
+	return ret;
+}
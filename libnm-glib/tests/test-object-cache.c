@@ -0,0 +1,166 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2012 Red Hat, Inc.
+ *
+ */
+
+#include <dbus/dbus-glib.h>
+#include <glib.h>
+#include <string.h>
+
+#include "nm-access-point.h"
+#include "nm-object-cache.h"
+
+#define AP_PATH(n) "/org/freedesktop/NetworkManager/AccessPoint/" #n
+
+static DBusGConnection *bus = NULL;
+
+/* Objects are only constructed, never initialized, so nothing needs to
+ * answer on the bus.
+ */
+static NMObject *
+new_object (const char *path)
+{
+	return g_object_new (NM_TYPE_ACCESS_POINT,
+	                     NM_OBJECT_DBUS_CONNECTION, bus,
+	                     NM_OBJECT_DBUS_PATH, path,
+	                     NULL);
+}
+
+static void
+get_stats (NMObjectCacheStats *stats)
+{
+	_nm_object_cache_get_stats (stats);
+	_nm_object_cache_reset_stats ();
+}
+
+static void
+test_hit_miss (void)
+{
+	NMObjectCacheStats stats;
+	NMObject *a, *found;
+	char *path;
+
+	_nm_object_cache_reset_stats ();
+
+	/* The cache keeps its own copy of the path */
+	path = g_strdup (AP_PATH (1));
+	a = new_object (path);
+	g_free (path);
+
+	found = _nm_object_cache_get (AP_PATH (1));
+	g_assert (found == a);
+	g_object_unref (found);
+	g_assert (_nm_object_cache_get (AP_PATH (2)) == NULL);
+	g_assert (_nm_object_cache_get (NULL) == NULL);
+
+	get_stats (&stats);
+	g_assert_cmpuint (stats.hits, ==, 1);
+	g_assert_cmpuint (stats.misses, ==, 2);
+	g_assert_cmpuint (stats.size, ==, 1);
+
+	g_object_unref (a);
+}
+
+static void
+test_eviction (void)
+{
+	NMObjectCacheStats stats;
+	NMObject *a, *b, *found;
+
+	_nm_object_cache_reset_stats ();
+
+	/* Destroying an object removes its entry */
+	a = new_object (AP_PATH (1));
+	g_object_unref (a);
+	g_assert (_nm_object_cache_get (AP_PATH (1)) == NULL);
+
+	get_stats (&stats);
+	g_assert_cmpuint (stats.evictions, ==, 1);
+	g_assert_cmpuint (stats.misses, ==, 1);
+	g_assert_cmpuint (stats.size, ==, 0);
+
+	/* An old object released late does not evict its replacement */
+	a = new_object (AP_PATH (1));
+	b = new_object (AP_PATH (1));
+	g_object_unref (a);
+	found = _nm_object_cache_get (AP_PATH (1));
+	g_assert (found == b);
+	g_object_unref (found);
+
+	get_stats (&stats);
+	g_assert_cmpuint (stats.evictions, ==, 0);
+	g_assert_cmpuint (stats.size, ==, 1);
+
+	g_object_unref (b);
+	get_stats (&stats);
+	g_assert_cmpuint (stats.evictions, ==, 1);
+	g_assert_cmpuint (stats.size, ==, 0);
+}
+
+static void
+test_clear (void)
+{
+	NMObjectCacheStats stats;
+	NMObject *a, *b, *found;
+
+	_nm_object_cache_reset_stats ();
+
+	/* Clearing turns every other object into a miss, and drops it lazily */
+	a = new_object (AP_PATH (1));
+	b = new_object (AP_PATH (2));
+	_nm_object_cache_clear (b);
+
+	get_stats (&stats);
+	g_assert_cmpuint (stats.size, ==, 2);
+
+	g_assert (_nm_object_cache_get (AP_PATH (1)) == NULL);
+	found = _nm_object_cache_get (AP_PATH (2));
+	g_assert (found == b);
+	g_object_unref (found);
+
+	get_stats (&stats);
+	g_assert_cmpuint (stats.stale, ==, 1);
+	g_assert_cmpuint (stats.misses, ==, 1);
+	g_assert_cmpuint (stats.hits, ==, 1);
+	g_assert_cmpuint (stats.size, ==, 1);
+
+	/* The stale object no longer owns an entry */
+	g_object_unref (a);
+	get_stats (&stats);
+	g_assert_cmpuint (stats.evictions, ==, 0);
+
+	g_object_unref (b);
+}
+
+int
+main (int argc, char **argv)
+{
+	GError *error = NULL;
+
+	g_type_init ();
+	g_test_init (&argc, &argv, NULL);
+
+	bus = dbus_g_bus_get (DBUS_BUS_SESSION, &error);
+	g_assert_no_error (error);
+
+	g_test_add_func ("/object-cache/hit-miss", test_hit_miss);
+	g_test_add_func ("/object-cache/eviction", test_eviction);
+	g_test_add_func ("/object-cache/clear", test_clear);
+
+	return g_test_run ();
+}
@@ -121,6 +121,26 @@ test_add_connection (void)
 
 /*******************************************************************/
 
+static void
+test_find_connection (void)
+{
+	NMRemoteConnection *found;
+
+	found = nm_remote_settings_get_connection_by_uuid (settings, nm_connection_get_uuid (NM_CONNECTION (remote)));
+	test_assert (found == remote);
+
+	found = nm_remote_settings_get_connection_by_id (settings, TEST_CON_ID);
+	test_assert (found == remote);
+
+	found = nm_remote_settings_get_connection_by_id (settings, "no-such-connection");
+	test_assert (found == NULL);
+
+	found = nm_remote_settings_get_connection_by_uuid (settings, "00000000-0000-0000-0000-000000000000");
+	test_assert (found == NULL);
+}
+
+/*******************************************************************/
+
 static void
 set_visible_cb (DBusGProxy *proxy,
                 DBusGProxyCall *call,
@@ -342,6 +362,70 @@ test_remove_connection (void)
 
 /*******************************************************************/
 
+static void
+bulk_connections_read_cb (NMRemoteSettings *s, gboolean *done)
+{
+	*done = TRUE;
+}
+
+/* Returns the GetSettings calls since the last time, and resets them */
+static guint
+get_settings_call_count (void)
+{
+	DBusGProxy *proxy;
+	GError *error = NULL;
+	guint count = 0;
+
+	proxy = dbus_g_proxy_new_for_name (bus,
+	                                   NM_DBUS_SERVICE,
+	                                   NM_DBUS_PATH_SETTINGS,
+	                                   "org.freedesktop.NetworkManager.Settings.Mock");
+	dbus_g_proxy_call (proxy, "GetCallCounts", &error,
+	                   G_TYPE_INVALID,
+	                   G_TYPE_UINT, &count,
+	                   G_TYPE_INVALID);
+	test_assert (error == NULL);
+	g_object_unref (proxy);
+	return count;
+}
+
+static void
+test_bulk_fetch (void)
+{
+	NMRemoteSettings *settings2;
+	NMRemoteConnection *found;
+	time_t start, now;
+	gboolean done = FALSE;
+
+	/* A fresh client should pick up the existing connection's settings in
+	 * one GetAllSettings call, without falling back to GetSettings.
+	 */
+	get_settings_call_count ();
+	settings2 = nm_remote_settings_new (bus);
+	test_assert (settings2 != NULL);
+	g_signal_connect (settings2, NM_REMOTE_SETTINGS_CONNECTIONS_READ,
+	                  G_CALLBACK (bulk_connections_read_cb), &done);
+
+	start = time (NULL);
+	do {
+		now = time (NULL);
+		g_main_context_iteration (NULL, FALSE);
+	} while ((done == FALSE) && (now - start < 5));
+	test_assert (done == TRUE);
+	test_assert (get_settings_call_count () == 0);
+
+	found = nm_remote_settings_get_connection_by_path (settings2, nm_connection_get_path (NM_CONNECTION (remote)));
+	test_assert (found != NULL);
+	test_assert (found != remote);
+	test_assert (nm_connection_compare (NM_CONNECTION (found),
+	                                    NM_CONNECTION (remote),
+	                                    NM_SETTING_COMPARE_FLAG_EXACT) == TRUE);
+
+	g_object_unref (settings2);
+}
+
+/*******************************************************************/
+
 #if GLIB_CHECK_VERSION(2,25,12)
 typedef GTestFixtureFunc TCFunc;
 #else
@@ -393,8 +477,10 @@ int main (int argc, char **argv)
 	suite = g_test_get_root ();
 
 	g_test_suite_add (suite, TESTCASE (test_add_connection, NULL));
+	g_test_suite_add (suite, TESTCASE (test_find_connection, NULL));
 	g_test_suite_add (suite, TESTCASE (test_make_invisible, NULL));
 	g_test_suite_add (suite, TESTCASE (test_make_visible, NULL));
+	g_test_suite_add (suite, TESTCASE (test_bulk_fetch, NULL));
 	g_test_suite_add (suite, TESTCASE (test_remove_connection, NULL));
 
 	ret = g_test_run ();
@@ -11,6 +11,7 @@ import dbus.mainloop.glib
 IFACE_SETTINGS = 'org.freedesktop.NetworkManager.Settings'
 IFACE_CONNECTION = 'org.freedesktop.NetworkManager.Settings.Connection'
 IFACE_DBUS = 'org.freedesktop.DBus'
+IFACE_MOCK = 'org.freedesktop.NetworkManager.Settings.Mock'
 
 class UnknownInterfaceException(dbus.DBusException):
     _dbus_error_name = IFACE_DBUS + '.UnknownInterface'
@@ -23,6 +24,9 @@ class PermissionDeniedException(dbus.DBusException):
 
 mainloop = gobject.MainLoop()
 
+# GetSettings calls since the last GetCallCounts()
+get_settings_calls = 0
+
 class Connection(dbus.service.Object):
     def __init__(self, bus, object_path, settings, remove_func):
         dbus.service.Object.__init__(self, bus, object_path)
@@ -33,6 +37,8 @@ class Connection(dbus.service.Object):
 
     @dbus.service.method(dbus_interface=IFACE_CONNECTION, in_signature='', out_signature='a{sa{sv}}')
     def GetSettings(self):
+        global get_settings_calls
+        get_settings_calls += 1
         if not self.visible:
             raise PermissionDeniedException()
         return self.settings
@@ -70,6 +76,26 @@ class Settings(dbus.service.Object):
         connections = []
         return self.connections.keys()
 
+    @dbus.service.method(dbus_interface=IFACE_SETTINGS, in_signature='su', out_signature='a{sa{sa{sv}}}s')
+    def GetAllSettings(self, after, limit):
+        # Same order as NetworkManager: numeric on the counter suffix
+        key = lambda p: (len(p), p)
+        paths = sorted(self.connections.keys(), key=key)
+        if after:
+            paths = [p for p in paths if key(p) > key(after)]
+        cursor = ""
+        if limit > 0 and limit < len(paths):
+            paths = paths[:limit]
+            cursor = paths[-1]
+        page = {}
+        for path in paths:
+            connection = self.connections[path]
+            if connection.visible:
+                page[path] = connection.settings
+            else:
+                page[path] = dbus.Dictionary({}, signature='sa{sv}')
+        return (page, cursor)
+
     @dbus.service.method(dbus_interface=IFACE_SETTINGS, in_signature='a{sa{sv}}', out_signature='o')
     def AddConnection(self, settings):
         path = "/org/freedesktop/NetworkManager/Settings/Connection/%d" % self.counter
@@ -99,6 +125,13 @@ class Settings(dbus.service.Object):
     def NewConnection(self, path):
         pass
 
+    @dbus.service.method(IFACE_MOCK, in_signature='', out_signature='u')
+    def GetCallCounts(self):
+        global get_settings_calls
+        count = get_settings_calls
+        get_settings_calls = 0
+        return dbus.UInt32(count)
+
     @dbus.service.method(IFACE_SETTINGS, in_signature='', out_signature='')
     def Quit(self):
         mainloop.quit()
@@ -28,6 +28,8 @@
 #include <strings.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 #include <glib/gi18n.h>
 
 #include "crypto.h"
@@ -103,7 +105,7 @@ parse_old_openssl_key_file (const GByteArray *contents,
 	gsize tmp_len = 0;
 	const char *start_tag;
 	const char *end_tag;
-	guint8 save_end = 0;
+	char *b64;
 
 	switch (key_type) {
 	case NM_CRYPTO_KEY_TYPE_RSA:
@@ -135,10 +137,10 @@ parse_old_openssl_key_file (const GByteArray *contents,
 		goto parse_error;
 	}
 
-	save_end = contents->data[end];
-	contents->data[end] = '\0';
-	lines = g_strsplit ((const char *) (contents->data + start), "\n", 0);
-	contents->data[end] = save_end;
+	/* Split a copy; @contents may be shared with other threads */
+	b64 = g_strndup ((const char *) (contents->data + start), end - start);
+	lines = g_strsplit (b64, "\n", 0);
+	g_free (b64);
 
 	if (!lines || g_strv_length (lines) <= 1) {
 		g_set_error (error, NM_CRYPTO_ERROR,
@@ -264,7 +266,7 @@ parse_pkcs8_key_file (const GByteArray *contents,
 	GByteArray *key = NULL;
 	gsize start = 0, end = 0;
 	unsigned char *der = NULL;
-	guint8 save_end;
+	char *b64;
 	gsize length = 0;
 	const char *start_tag = NULL, *end_tag = NULL;
 	gboolean encrypted = FALSE;
@@ -294,11 +296,12 @@ parse_pkcs8_key_file (const GByteArray *contents,
 		return NULL;
 	}
 
-	/* g_base64_decode() wants a NULL-terminated string */
-	save_end = contents->data[end];
-	contents->data[end] = '\0';
-	der = g_base64_decode ((const char *) (contents->data + start), &length);
-	contents->data[end] = save_end;
+	/* g_base64_decode() wants a NULL-terminated string; decode a copy since
+	 * @contents may be shared with other threads.
+	 */
+	b64 = g_strndup ((const char *) (contents->data + start), end - start);
+	der = g_base64_decode (b64, &length);
+	g_free (b64);
 
 	if (der && length) {
 		key = g_byte_array_sized_new (length);
@@ -343,6 +346,404 @@ file_to_g_byte_array (const char *filename, GError **error)
 	return array;
 }
 
+/* An old-style OpenSSL private key, decoded but still encrypted if it was */
+typedef struct {
+	NMCryptoKeyType type;
+	char *cipher;
+	char *iv;
+	GByteArray *data;
+} OpenSSLKey;
+
+static void
+openssl_key_free (OpenSSLKey *key)
+{
+	if (!key)
+		return;
+
+	/* The key may be unencrypted; don't leave it lying around */
+	memset (key->data->data, 0, key->data->len);
+	g_byte_array_free (key->data, TRUE);
+	g_free (key->cipher);
+	g_free (key->iv);
+	g_slice_free (OpenSSLKey, key);
+}
+
+static OpenSSLKey *
+openssl_key_parse (const GByteArray *contents, GError **error)
+{
+	OpenSSLKey *key;
+	NMCryptoKeyType type = NM_CRYPTO_KEY_TYPE_RSA;
+	GByteArray *data;
+	char *cipher = NULL, *iv = NULL;
+
+	/* Try RSA keys first */
+	data = parse_old_openssl_key_file (contents, type, &cipher, &iv, error);
+	if (!data) {
+		g_clear_error (error);
+
+		/* DSA next */
+		type = NM_CRYPTO_KEY_TYPE_DSA;
+		data = parse_old_openssl_key_file (contents, type, &cipher, &iv, error);
+		if (!data) {
+			g_clear_error (error);
+			g_set_error (error, NM_CRYPTO_ERROR,
+			             NM_CRYPTO_ERR_FILE_FORMAT_INVALID,
+			             _("Unable to determine private key type."));
+			return NULL;
+		}
+	}
+
+	key = g_slice_new (OpenSSLKey);
+	key->type = type;
+	key->cipher = cipher;
+	key->iv = iv;
+	key->data = data;
+	return key;
+}
+
+/* Process-wide cache of certificate and private key files.  Entries are keyed
+ * by path and validated against the file's device, inode, mtime and size on
+ * every lookup, so a replaced or rewritten file is re-read automatically.
+ * Besides the contents, an entry keeps what was decoded from them so that
+ * the PEM, DER and PKCS#12 parsing is done once per file.  Only successful
+ * results are remembered; anything that fails is re-checked the next time
+ * around so callers still get the real error.
+ *
+ * The lock only protects the table and the entries' fields.  Files are read
+ * and parsed without it; callers hold a reference to the entry meanwhile.
+ */
+
+#define FILE_CACHE_MAX_ENTRIES    32
+#define FILE_CACHE_MAX_BYTES      (512 * 1024)
+#define FILE_CACHE_MAX_FILE_BYTES (FILE_CACHE_MAX_BYTES / 4)
+
+#define KEY_PASSWORD_MAC_LEN      32  /* SHA256 */
+#define KEY_PASSWORD_MAC_KEY_LEN  64  /* SHA256 block size */
+
+typedef struct {
+	volatile int refcount;
+
+	char *path;
+	dev_t dev;
+	ino_t ino;
+	time_t mtime;
+	off_t size;
+
+	/* Never changed once the entry is created */
+	GByteArray *contents;
+
+	/* Decoded contents.  Each is set at most once and never changed
+	 * afterwards, so once it has been seen under the lock, it can be used
+	 * without the lock for as long as the entry is referenced.
+	 */
+	/* -1 if not yet checked, otherwise TRUE or FALSE */
+	int is_pkcs12;
+	GByteArray *pkcs8_key;
+	gboolean pkcs8_encrypted;
+	OpenSSLKey *openssl_key;
+
+	/* Certificate format, or UNKNOWN if not yet verified */
+	NMCryptoFileFormat cert_format;
+	/* Private key format without a password, or UNKNOWN if not yet verified */
+	NMCryptoFileFormat key_format;
+	/* Keyed hash of the last password that verified the key */
+	guint8 key_password_mac[KEY_PASSWORD_MAC_LEN];
+	NMCryptoFileFormat key_password_format;
+} FileCacheEntry;
+
+G_LOCK_DEFINE_STATIC (file_cache);
+static GHashTable *file_cache = NULL;
+static GQueue file_cache_lru = G_QUEUE_INIT;
+static gsize file_cache_bytes = 0;
+
+/* Random per-process key for key_password_mac(); protected by the lock */
+static guint8 password_mac_key[KEY_PASSWORD_MAC_KEY_LEN];
+static gboolean have_password_mac_key = FALSE;
+
+static FileCacheEntry *
+file_cache_entry_new (const char *path, GByteArray *contents)
+{
+	FileCacheEntry *entry;
+
+	entry = g_slice_new0 (FileCacheEntry);
+	entry->refcount = 1;
+	entry->path = g_strdup (path);
+	entry->contents = contents;
+	entry->is_pkcs12 = -1;
+	return entry;
+}
+
+static void
+file_cache_entry_unref (FileCacheEntry *entry)
+{
+	if (!g_atomic_int_dec_and_test (&entry->refcount))
+		return;
+
+	/* Private keys may be unencrypted; don't leave them lying around */
+	memset (entry->contents->data, 0, entry->contents->len);
+	g_byte_array_free (entry->contents, TRUE);
+	if (entry->pkcs8_key) {
+		memset (entry->pkcs8_key->data, 0, entry->pkcs8_key->len);
+		g_byte_array_free (entry->pkcs8_key, TRUE);
+	}
+	openssl_key_free (entry->openssl_key);
+	memset (entry->key_password_mac, 0, sizeof (entry->key_password_mac));
+	g_free (entry->path);
+	g_slice_free (FileCacheEntry, entry);
+}
+
+/* Must be called with the file_cache lock held */
+static void
+file_cache_remove (FileCacheEntry *entry)
+{
+	g_queue_remove (&file_cache_lru, entry);
+	file_cache_bytes -= entry->contents->len;
+	g_hash_table_remove (file_cache, entry->path);
+}
+
+static gboolean
+file_cache_entry_matches (FileCacheEntry *entry, struct stat *st)
+{
+	return    entry->dev == st->st_dev
+	       && entry->ino == st->st_ino
+	       && entry->mtime == st->st_mtime
+	       && entry->size == st->st_size;
+}
+
+/* Returns a reference to the entry for @path, which must be dropped with
+ * file_cache_entry_unref().
+ */
+static FileCacheEntry *
+file_cache_get (const char *path, GError **error)
+{
+	FileCacheEntry *entry, *other;
+	struct stat st, st2;
+	gboolean have_st;
+	GByteArray *contents;
+
+	have_st = (stat (path, &st) == 0);
+
+	G_LOCK (file_cache);
+	if (G_UNLIKELY (!file_cache))
+		file_cache = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+		                                    (GDestroyNotify) file_cache_entry_unref);
+
+	entry = g_hash_table_lookup (file_cache, path);
+	if (have_st && entry && file_cache_entry_matches (entry, &st)) {
+		/* Move to the head of the LRU list */
+		g_queue_remove (&file_cache_lru, entry);
+		g_queue_push_head (&file_cache_lru, entry);
+		g_atomic_int_inc (&entry->refcount);
+		G_UNLOCK (file_cache);
+		return entry;
+	}
+	if (entry)
+		file_cache_remove (entry);
+	G_UNLOCK (file_cache);
+
+	contents = file_to_g_byte_array (path, error);
+	if (!contents)
+		return NULL;
+
+	entry = file_cache_entry_new (path, contents);
+
+	/* Only cache the file if it didn't change while it was being read */
+	if (   !have_st
+	    || stat (path, &st2) != 0
+	    || st.st_size != (off_t) contents->len
+	    || contents->len > FILE_CACHE_MAX_FILE_BYTES)
+		return entry;
+
+	entry->dev = st.st_dev;
+	entry->ino = st.st_ino;
+	entry->mtime = st.st_mtime;
+	entry->size = st.st_size;
+	if (!file_cache_entry_matches (entry, &st2))
+		return entry;
+
+	G_LOCK (file_cache);
+	/* Another thread may have read the file in the meantime */
+	other = g_hash_table_lookup (file_cache, path);
+	if (other)
+		file_cache_remove (other);
+
+	while (   g_queue_get_length (&file_cache_lru) >= FILE_CACHE_MAX_ENTRIES
+	       || file_cache_bytes + contents->len > FILE_CACHE_MAX_BYTES)
+		file_cache_remove (g_queue_peek_tail (&file_cache_lru));
+
+	g_atomic_int_inc (&entry->refcount);
+	g_hash_table_insert (file_cache, entry->path, entry);
+	g_queue_push_head (&file_cache_lru, entry);
+	file_cache_bytes += contents->len;
+	G_UNLOCK (file_cache);
+
+	return entry;
+}
+
+static gboolean
+file_cache_entry_is_pkcs12 (FileCacheEntry *entry)
+{
+	int is_pkcs12;
+
+	G_LOCK (file_cache);
+	is_pkcs12 = entry->is_pkcs12;
+	G_UNLOCK (file_cache);
+
+	if (is_pkcs12 < 0) {
+		is_pkcs12 = crypto_is_pkcs12_data (entry->contents);
+
+		G_LOCK (file_cache);
+		entry->is_pkcs12 = is_pkcs12;
+		G_UNLOCK (file_cache);
+	}
+	return is_pkcs12;
+}
+
+/* Returns the entry's PEM-decoded PKCS#8 key, owned by the entry */
+static GByteArray *
+file_cache_entry_get_pkcs8_key (FileCacheEntry *entry,
+                                gboolean *out_encrypted,
+                                GError **error)
+{
+	GByteArray *key;
+	gboolean encrypted = FALSE;
+
+	G_LOCK (file_cache);
+	key = entry->pkcs8_key;
+	G_UNLOCK (file_cache);
+
+	if (!key) {
+		key = parse_pkcs8_key_file (entry->contents, &encrypted, error);
+		if (!key)
+			return NULL;
+
+		G_LOCK (file_cache);
+		if (!entry->pkcs8_key) {
+			entry->pkcs8_key = key;
+			entry->pkcs8_encrypted = encrypted;
+		} else {
+			/* Another thread was quicker */
+			memset (key->data, 0, key->len);
+			g_byte_array_free (key, TRUE);
+			key = entry->pkcs8_key;
+		}
+		G_UNLOCK (file_cache);
+	}
+
+	*out_encrypted = entry->pkcs8_encrypted;
+	return key;
+}
+
+/* Returns the entry's decoded old-style OpenSSL key, owned by the entry */
+static OpenSSLKey *
+file_cache_entry_get_openssl_key (FileCacheEntry *entry, GError **error)
+{
+	OpenSSLKey *key;
+
+	G_LOCK (file_cache);
+	key = entry->openssl_key;
+	G_UNLOCK (file_cache);
+
+	if (!key) {
+		key = openssl_key_parse (entry->contents, error);
+		if (!key)
+			return NULL;
+
+		G_LOCK (file_cache);
+		if (!entry->openssl_key)
+			entry->openssl_key = key;
+		else {
+			/* Another thread was quicker */
+			openssl_key_free (key);
+			key = entry->openssl_key;
+		}
+		G_UNLOCK (file_cache);
+	}
+	return key;
+}
+
+/* HMAC-SHA256 of @password with a random per-process key, so that cached
+ * results can be matched to a password without keeping the password or
+ * anything that could be checked against a precomputed table.  Must be
+ * called with the file_cache lock held.
+ */
+static gboolean
+key_password_mac (const char *password, guint8 *mac)
+{
+	guint8 pad[KEY_PASSWORD_MAC_KEY_LEN];
+	guint8 inner[KEY_PASSWORD_MAC_LEN];
+	gsize len;
+	GChecksum *sum;
+	int i;
+
+	if (G_UNLIKELY (!have_password_mac_key)) {
+		if (!crypto_randomize (password_mac_key, sizeof (password_mac_key), NULL))
+			return FALSE;
+		have_password_mac_key = TRUE;
+	}
+
+	for (i = 0; i < KEY_PASSWORD_MAC_KEY_LEN; i++)
+		pad[i] = password_mac_key[i] ^ 0x36;
+	sum = g_checksum_new (G_CHECKSUM_SHA256);
+	g_checksum_update (sum, pad, sizeof (pad));
+	g_checksum_update (sum, (const guchar *) password, strlen (password));
+	len = sizeof (inner);
+	g_checksum_get_digest (sum, inner, &len);
+	g_checksum_free (sum);
+
+	for (i = 0; i < KEY_PASSWORD_MAC_KEY_LEN; i++)
+		pad[i] = password_mac_key[i] ^ 0x5c;
+	sum = g_checksum_new (G_CHECKSUM_SHA256);
+	g_checksum_update (sum, pad, sizeof (pad));
+	g_checksum_update (sum, inner, sizeof (inner));
+	len = KEY_PASSWORD_MAC_LEN;
+	g_checksum_get_digest (sum, mac, &len);
+	g_checksum_free (sum);
+
+	memset (pad, 0, sizeof (pad));
+	memset (inner, 0, sizeof (inner));
+	return TRUE;
+}
+
+/* Drops cached contents and results for @path, or for every file if @path
+ * is NULL.  Entries are revalidated against the file's inode, mtime and size
+ * on every lookup, so this is only needed when a file is rewritten in place
+ * without any of those changing, or to release the memory.
+ */
+void
+crypto_file_cache_invalidate (const char *path)
+{
+	FileCacheEntry *entry;
+
+	G_LOCK (file_cache);
+	if (file_cache) {
+		if (path) {
+			entry = g_hash_table_lookup (file_cache, path);
+			if (entry)
+				file_cache_remove (entry);
+		} else {
+			g_queue_clear (&file_cache_lru);
+			g_hash_table_remove_all (file_cache);
+			file_cache_bytes = 0;
+		}
+	}
+	G_UNLOCK (file_cache);
+}
+
+/* Returns the number of cached files and, in @out_bytes, their total size */
+guint
+crypto_file_cache_get_size (gsize *out_bytes)
+{
+	guint n;
+
+	G_LOCK (file_cache);
+	n = g_queue_get_length (&file_cache_lru);
+	if (out_bytes)
+		*out_bytes = file_cache_bytes;
+	G_UNLOCK (file_cache);
+	return n;
+}
+
 /*
  * Convert a hex string into bytes.
  */
@@ -516,51 +917,24 @@ crypto_decrypt_private_key_data (const GByteArray *contents,
                                  GError **error)
 {
 	GByteArray *decrypted = NULL;
-	NMCryptoKeyType key_type = NM_CRYPTO_KEY_TYPE_RSA;
-	GByteArray *data;
-	char *iv = NULL;
-	char *cipher = NULL;
+	OpenSSLKey *key;
 
 	g_return_val_if_fail (contents != NULL, NULL);
 	if (out_key_type)
 		g_return_val_if_fail (*out_key_type == NM_CRYPTO_KEY_TYPE_UNKNOWN, NULL);
 
 	/* OpenSSL non-standard legacy PEM files */
+	key = openssl_key_parse (contents, error);
+	if (!key)
+		return NULL;
 
-	/* Try RSA keys first */
-	data = parse_old_openssl_key_file (contents, key_type, &cipher, &iv, error);
-	if (!data) {
-		g_clear_error (error);
-
-		/* DSA next */
-		key_type = NM_CRYPTO_KEY_TYPE_DSA;
-		data = parse_old_openssl_key_file (contents, key_type, &cipher, &iv, error);
-		if (!data) {
-			g_clear_error (error);
-			g_set_error (error, NM_CRYPTO_ERROR,
-			             NM_CRYPTO_ERR_FILE_FORMAT_INVALID,
-			             _("Unable to determine private key type."));
-		}
-	}
-
-	if (data) {
-		/* return the key type even if decryption failed */
-		if (out_key_type)
-			*out_key_type = key_type;
-
-		if (password) {
-			decrypted = decrypt_key (cipher,
-						             key_type,
-						             data,
-						             iv,
-						             password,
-						             error);
-		}
-		g_byte_array_free (data, TRUE);
-	}
+	/* return the key type even if decryption failed */
+	if (out_key_type)
+		*out_key_type = key->type;
 
-	g_free (cipher);
-	g_free (iv);
+	if (password)
+		decrypted = decrypt_key (key->cipher, key->type, key->data, key->iv, password, error);
+	openssl_key_free (key);
 
 	return decrypted;
 }
@@ -571,24 +945,37 @@ crypto_decrypt_private_key (const char *file,
                             NMCryptoKeyType *out_key_type,
                             GError **error)
 {
-	GByteArray *contents;
-	GByteArray *key = NULL;
+	FileCacheEntry *entry;
+	OpenSSLKey *key;
+	GByteArray *decrypted = NULL;
+
+	g_return_val_if_fail (file != NULL, NULL);
+	if (out_key_type)
+		g_return_val_if_fail (*out_key_type == NM_CRYPTO_KEY_TYPE_UNKNOWN, NULL);
 
-	contents = file_to_g_byte_array (file, error);
-	if (contents) {
-		key = crypto_decrypt_private_key_data (contents, password, out_key_type, error);
-		g_byte_array_free (contents, TRUE);
+	entry = file_cache_get (file, error);
+	if (!entry)
+		return NULL;
+
+	key = file_cache_entry_get_openssl_key (entry, error);
+	if (key) {
+		if (out_key_type)
+			*out_key_type = key->type;
+		if (password)
+			decrypted = decrypt_key (key->cipher, key->type, key->data, key->iv, password, error);
 	}
-	return key;
+	file_cache_entry_unref (entry);
+
+	return decrypted;
 }
 
 static GByteArray *
-extract_pem_cert_data (GByteArray *contents, GError **error)
+extract_pem_cert_data (const GByteArray *contents, GError **error)
 {
 	GByteArray *cert = NULL;
 	gsize start = 0, end = 0;
 	unsigned char *der = NULL;
-	guint8 save_end;
+	char *b64;
 	gsize length = 0;
 
 	if (!find_tag (PEM_CERT_BEGIN, contents, 0, &start)) {
@@ -608,11 +995,12 @@ extract_pem_cert_data (GByteArray *contents, GError **error)
 		goto done;
 	}
 
-	/* g_base64_decode() wants a NULL-terminated string */
-	save_end = contents->data[end];
-	contents->data[end] = '\0';
-	der = g_base64_decode ((const char *) (contents->data + start), &length);
-	contents->data[end] = save_end;
+	/* g_base64_decode() wants a NULL-terminated string; decode a copy since
+	 * @contents may be shared with other threads.
+	 */
+	b64 = g_strndup ((const char *) (contents->data + start), end - start);
+	der = g_base64_decode (b64, &length);
+	g_free (b64);
 
 	if (der && length) {
 		cert = g_byte_array_sized_new (length);
@@ -635,45 +1023,66 @@ done:
 	return cert;
 }
 
+static NMCryptoFileFormat
+verify_certificate (FileCacheEntry *entry, GError **error)
+{
+	const GByteArray *contents = entry->contents;
+	GByteArray *array;
+	NMCryptoFileFormat format;
+
+	/* Check for PKCS#12 */
+	if (file_cache_entry_is_pkcs12 (entry))
+		return NM_CRYPTO_FILE_FORMAT_PKCS12;
+
+	/* Check for plain DER format */
+	if (contents->len > 2 && contents->data[0] == 0x30 && contents->data[1] == 0x82)
+		return crypto_verify_cert (contents->data, contents->len, error);
+
+	array = extract_pem_cert_data (contents, error);
+	if (!array)
+		return NM_CRYPTO_FILE_FORMAT_UNKNOWN;
+
+	format = crypto_verify_cert (array->data, array->len, error);
+	g_byte_array_free (array, TRUE);
+	return format;
+}
+
 GByteArray *
 crypto_load_and_verify_certificate (const char *file,
                                     NMCryptoFileFormat *out_file_format,
                                     GError **error)
 {
-	GByteArray *array, *contents;
+	FileCacheEntry *entry;
+	GByteArray *contents = NULL;
+	NMCryptoFileFormat format;
 
 	g_return_val_if_fail (file != NULL, NULL);
 	g_return_val_if_fail (out_file_format != NULL, NULL);
 	g_return_val_if_fail (*out_file_format == NM_CRYPTO_FILE_FORMAT_UNKNOWN, NULL);
 
-	contents = file_to_g_byte_array (file, error);
-	if (!contents)
+	entry = file_cache_get (file, error);
+	if (!entry)
 		return NULL;
 
-	/* Check for PKCS#12 */
-	if (crypto_is_pkcs12_data (contents)) {
-		*out_file_format = NM_CRYPTO_FILE_FORMAT_PKCS12;
-		return contents;
-	}
+	G_LOCK (file_cache);
+	format = entry->cert_format;
+	G_UNLOCK (file_cache);
 
-	/* Check for plain DER format */
-	if (contents->len > 2 && contents->data[0] == 0x30 && contents->data[1] == 0x82) {
-		*out_file_format = crypto_verify_cert (contents->data, contents->len, error);
-	} else {
-		array = extract_pem_cert_data (contents, error);
-		if (!array) {
-			g_byte_array_free (contents, TRUE);
-			return NULL;
+	if (format == NM_CRYPTO_FILE_FORMAT_UNKNOWN) {
+		format = verify_certificate (entry, error);
+		if (format == NM_CRYPTO_FILE_FORMAT_PKCS12 || format == NM_CRYPTO_FILE_FORMAT_X509) {
+			G_LOCK (file_cache);
+			entry->cert_format = format;
+			G_UNLOCK (file_cache);
 		}
-
-		*out_file_format = crypto_verify_cert (array->data, array->len, error);
-		g_byte_array_free (array, TRUE);
 	}
 
-	if (*out_file_format != NM_CRYPTO_FILE_FORMAT_X509) {
-		g_byte_array_free (contents, TRUE);
-		contents = NULL;
+	*out_file_format = format;
+	if (format == NM_CRYPTO_FILE_FORMAT_PKCS12 || format == NM_CRYPTO_FILE_FORMAT_X509) {
+		contents = g_byte_array_sized_new (entry->contents->len);
+		g_byte_array_append (contents, entry->contents->data, entry->contents->len);
 	}
+	file_cache_entry_unref (entry);
 
 	return contents;
 }
@@ -701,19 +1110,62 @@ crypto_is_pkcs12_data (const GByteArray *data)
 gboolean
 crypto_is_pkcs12_file (const char *file, GError **error)
 {
-	GByteArray *contents;
-	gboolean success = FALSE;
+	FileCacheEntry *entry;
+	gboolean success;
 
 	g_return_val_if_fail (file != NULL, FALSE);
 
-	contents = file_to_g_byte_array (file, error);
-	if (contents) {
-		success = crypto_is_pkcs12_data (contents);
-		g_byte_array_free (contents, TRUE);
-	}
+	entry = file_cache_get (file, error);
+	if (!entry)
+		return FALSE;
+
+	success = file_cache_entry_is_pkcs12 (entry);
+	file_cache_entry_unref (entry);
 	return success;
 }
 
+static NMCryptoFileFormat
+verify_private_key (FileCacheEntry *entry,
+                    const char *password,
+                    GError **error)
+{
+	GByteArray *pkcs8_key, *decrypted;
+	gboolean is_encrypted = FALSE;
+	OpenSSLKey *key;
+
+	/* Check for PKCS#12 first */
+	if (file_cache_entry_is_pkcs12 (entry)) {
+		if (!password || crypto_verify_pkcs12 (entry->contents, password, error))
+			return NM_CRYPTO_FILE_FORMAT_PKCS12;
+		return NM_CRYPTO_FILE_FORMAT_UNKNOWN;
+	}
+
+	/* Maybe it's PKCS#8 */
+	pkcs8_key = file_cache_entry_get_pkcs8_key (entry, &is_encrypted, error);
+	if (pkcs8_key) {
+		if (crypto_verify_pkcs8 (pkcs8_key, is_encrypted, password, error))
+			return NM_CRYPTO_FILE_FORMAT_RAW_KEY;
+		return NM_CRYPTO_FILE_FORMAT_UNKNOWN;
+	}
+	g_clear_error (error);
+
+	/* Or it's old-style OpenSSL */
+	key = file_cache_entry_get_openssl_key (entry, error);
+	if (!key)
+		return NM_CRYPTO_FILE_FORMAT_UNKNOWN;
+	if (!password)
+		return NM_CRYPTO_FILE_FORMAT_RAW_KEY;
+
+	decrypted = decrypt_key (key->cipher, key->type, key->data, key->iv, password, error);
+	if (!decrypted)
+		return NM_CRYPTO_FILE_FORMAT_UNKNOWN;
+
+	/* Don't leave decrypted key data around */
+	memset (decrypted->data, 0, decrypted->len);
+	g_byte_array_free (decrypted, TRUE);
+	return NM_CRYPTO_FILE_FORMAT_RAW_KEY;
+}
+
 /* Verifies that a private key can be read, and if a password is given, that
  * the private key can be decrypted with that password.
  */
@@ -722,40 +1174,19 @@ crypto_verify_private_key_data (const GByteArray *contents,
                                 const char *password,
                                 GError **error)
 {
-	GByteArray *tmp;
-	NMCryptoFileFormat format = NM_CRYPTO_FILE_FORMAT_UNKNOWN;
-	NMCryptoKeyType ktype = NM_CRYPTO_KEY_TYPE_UNKNOWN;
-	gboolean is_encrypted = FALSE;
+	FileCacheEntry *entry;
+	GByteArray *copy;
+	NMCryptoFileFormat format;
 
 	g_return_val_if_fail (contents != NULL, FALSE);
 
-	/* Check for PKCS#12 first */
-	if (crypto_is_pkcs12_data (contents)) {
-		if (!password || crypto_verify_pkcs12 (contents, password, error))
-			format = NM_CRYPTO_FILE_FORMAT_PKCS12;
-	} else {
-		/* Maybe it's PKCS#8 */
-		tmp = parse_pkcs8_key_file (contents, &is_encrypted, error);
-		if (tmp) {
-			if (crypto_verify_pkcs8 (tmp, is_encrypted, password, error))
-				format = NM_CRYPTO_FILE_FORMAT_RAW_KEY;
-		} else {
-			g_clear_error (error);
-
-			/* Or it's old-style OpenSSL */
-			tmp = crypto_decrypt_private_key_data (contents, password, &ktype, error);
-			if (tmp)
-				format = NM_CRYPTO_FILE_FORMAT_RAW_KEY;
-			else if (!password && (ktype != NM_CRYPTO_KEY_TYPE_UNKNOWN))
-				format = NM_CRYPTO_FILE_FORMAT_RAW_KEY;
-		}
+	/* A private, uncached entry so the checks are the same as for files */
+	copy = g_byte_array_sized_new (contents->len);
+	g_byte_array_append (copy, contents->data, contents->len);
+	entry = file_cache_entry_new (NULL, copy);
 
-		if (tmp) {
-			/* Don't leave decrypted key data around */
-			memset (tmp->data, 0, tmp->len);
-			g_byte_array_free (tmp, TRUE);
-		}
-	}
+	format = verify_private_key (entry, password, error);
+	file_cache_entry_unref (entry);
 
 	return format;
 }
@@ -765,16 +1196,43 @@ crypto_verify_private_key (const char *filename,
                            const char *password,
                            GError **error)
 {
-	GByteArray *contents;
+	FileCacheEntry *entry;
 	NMCryptoFileFormat format = NM_CRYPTO_FILE_FORMAT_UNKNOWN;
+	guint8 mac[KEY_PASSWORD_MAC_LEN];
+	gboolean have_mac = FALSE;
 
 	g_return_val_if_fail (filename != NULL, FALSE);
 
-	contents = file_to_g_byte_array (filename, error);
-	if (contents) {
-		format = crypto_verify_private_key_data (contents, password, error);
-		g_byte_array_free (contents, TRUE);
+	entry = file_cache_get (filename, error);
+	if (!entry)
+		return NM_CRYPTO_FILE_FORMAT_UNKNOWN;
+
+	G_LOCK (file_cache);
+	if (password) {
+		have_mac = key_password_mac (password, mac);
+		if (   have_mac
+		    && entry->key_password_format != NM_CRYPTO_FILE_FORMAT_UNKNOWN
+		    && !memcmp (mac, entry->key_password_mac, sizeof (mac)))
+			format = entry->key_password_format;
+	} else
+		format = entry->key_format;
+	G_UNLOCK (file_cache);
+
+	if (format == NM_CRYPTO_FILE_FORMAT_UNKNOWN) {
+		format = verify_private_key (entry, password, error);
+		if (format != NM_CRYPTO_FILE_FORMAT_UNKNOWN && (have_mac || !password)) {
+			/* Only the last password that worked is remembered */
+			G_LOCK (file_cache);
+			if (password) {
+				memcpy (entry->key_password_mac, mac, sizeof (mac));
+				entry->key_password_format = format;
+			} else
+				entry->key_format = format;
+			G_UNLOCK (file_cache);
+		}
 	}
+	file_cache_entry_unref (entry);
+
+	memset (mac, 0, sizeof (mac));
 	return format;
 }
-
@@ -97,6 +97,10 @@ NMCryptoFileFormat crypto_verify_private_key (const char *file,
                                               const char *password,
                                               GError **error);
 
+void crypto_file_cache_invalidate (const char *path);
+
+guint crypto_file_cache_get_size (gsize *out_bytes);
+
 /* Internal utils API bits for crypto providers */
 
 gboolean crypto_md5_hash (const char *salt,
@@ -98,6 +98,13 @@ typedef struct {
 
 	/* D-Bus path of the connection, if any */
 	char *path;
+
+	/* Bumped whenever a setting is added, removed, or changed; used to
+	 * skip re-verification of connections that have not changed since
+	 * they were last successfully verified.
+	 */
+	guint32 generation;
+	guint32 verified_generation;
 } NMConnectionPrivate;
 
 #define NM_CONNECTION_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), NM_TYPE_CONNECTION, NMConnectionPrivate))
@@ -119,6 +126,11 @@ enum {
 
 static guint signals[LAST_SIGNAL] = { 0 };
 
+/* Debugging counters for nm_connection_verify() */
+static guint verify_full_count = 0;
+static guint verify_cached_count = 0;
+static guint64 verify_full_usec = 0;
+
 /*************************************************************/
 
 static GHashTable *registered_settings = NULL;
@@ -302,6 +314,38 @@ nm_connection_create_setting (const char *name)
 	return setting;
 }
 
+static void
+connection_changed (NMConnection *connection)
+{
+	NMConnectionPrivate *priv = NM_CONNECTION_GET_PRIVATE (connection);
+
+	/* Skip 0, which means "never verified" */
+	if (G_UNLIKELY (++priv->generation == 0))
+		priv->generation = 1;
+}
+
+static void
+setting_changed_cb (NMSetting *setting, GParamSpec *pspec, NMConnection *self)
+{
+	connection_changed (self);
+}
+
+/* A setting may be shared between connections; only drop this one's handler */
+static void
+setting_release (NMConnection *self, NMSetting *setting)
+{
+	g_signal_handlers_disconnect_matched (setting, G_SIGNAL_MATCH_FUNC | G_SIGNAL_MATCH_DATA,
+	                                      0, 0, NULL, setting_changed_cb, self);
+	g_object_unref (setting);
+}
+
+static gboolean
+remove_one_setting (gpointer key, gpointer value, gpointer user_data)
+{
+	setting_release (NM_CONNECTION (user_data), NM_SETTING (value));
+	return TRUE;
+}
+
 static void
 parse_one_setting (gpointer key, gpointer value, gpointer user_data)
 {
@@ -329,11 +373,19 @@ parse_one_setting (gpointer key, gpointer value, gpointer user_data)
 void
 nm_connection_add_setting (NMConnection *connection, NMSetting *setting)
 {
+	NMConnectionPrivate *priv;
+	NMSetting *old;
+
 	g_return_if_fail (NM_IS_CONNECTION (connection));
 	g_return_if_fail (NM_IS_SETTING (setting));
 
-	g_hash_table_insert (NM_CONNECTION_GET_PRIVATE (connection)->settings,
-					 g_strdup (G_OBJECT_TYPE_NAME (setting)), setting);
+	priv = NM_CONNECTION_GET_PRIVATE (connection);
+	old = g_hash_table_lookup (priv->settings, G_OBJECT_TYPE_NAME (setting));
+	g_hash_table_insert (priv->settings, g_strdup (G_OBJECT_TYPE_NAME (setting)), setting);
+	if (old)
+		setting_release (connection, old);
+	g_signal_connect (setting, "notify", (GCallback) setting_changed_cb, connection);
+	connection_changed (connection);
 }
 
 /**
@@ -347,10 +399,19 @@ nm_connection_add_setting (NMConnection *connection, NMSetting *setting)
 void
 nm_connection_remove_setting (NMConnection *connection, GType setting_type)
 {
+	NMConnectionPrivate *priv;
+	NMSetting *setting;
+
 	g_return_if_fail (NM_IS_CONNECTION (connection));
 	g_return_if_fail (g_type_is_a (setting_type, NM_TYPE_SETTING));
 
-	g_hash_table_remove (NM_CONNECTION_GET_PRIVATE (connection)->settings, g_type_name (setting_type));
+	priv = NM_CONNECTION_GET_PRIVATE (connection);
+	setting = g_hash_table_lookup (priv->settings, g_type_name (setting_type));
+	if (setting) {
+		g_hash_table_remove (priv->settings, g_type_name (setting_type));
+		setting_release (connection, setting);
+		connection_changed (connection);
+	}
 }
 
 /**
@@ -470,7 +531,9 @@ nm_connection_replace_settings (NMConnection *connection,
 	if (!validate_permissions_type (new_settings, error))
 		return FALSE;
 
-	g_hash_table_remove_all (NM_CONNECTION_GET_PRIVATE (connection)->settings);
+	g_hash_table_foreach_remove (NM_CONNECTION_GET_PRIVATE (connection)->settings,
+	                             remove_one_setting, connection);
+	connection_changed (connection);
 	g_hash_table_foreach (new_settings, parse_one_setting, connection);
 
 	return nm_connection_verify (connection, error);
@@ -625,27 +688,10 @@ nm_connection_diff (NMConnection *a,
 	return *out_settings ? FALSE : TRUE;
 }
 
-/**
- * nm_connection_verify:
- * @connection: the #NMConnection to verify
- * @error: location to store error, or %NULL
- *
- * Validates the connection and all its settings.  Each setting's properties
- * have allowed values, and some values are dependent on other values.  For
- * example, if a WiFi connection is security enabled, the #NMSettingWireless
- * setting object's 'security' property must contain the setting name of the
- * #NMSettingWirelessSecurity object, which must also be present in the 
- * connection for the connection to be valid.  As another example, the
- * #NMSettingWired object's 'mac-address' property must be a validly formatted
- * MAC address.  The returned #GError contains information about which
- * setting and which property failed validation, and how it failed validation.
- *
- * Returns: %TRUE if the connection is valid, %FALSE if it is not
- **/
-gboolean
-nm_connection_verify (NMConnection *connection, GError **error)
+static gboolean
+verify_settings (NMConnection *connection, GError **error)
 {
-	NMConnectionPrivate *priv;
+	NMConnectionPrivate *priv = NM_CONNECTION_GET_PRIVATE (connection);
 	NMSettingConnection *s_con;
 	GHashTableIter iter;
 	gpointer value;
@@ -654,19 +700,6 @@ nm_connection_verify (NMConnection *connection, GError **error)
 	NMSetting *base;
 	const char *ctype;
 
-	if (error)
-		g_return_val_if_fail (*error == NULL, FALSE);
-
-	if (!NM_IS_CONNECTION (connection)) {
-		g_set_error_literal (error,
-		                     NM_SETTING_CONNECTION_ERROR,
-		                     NM_SETTING_CONNECTION_ERROR_UNKNOWN,
-		                     "invalid connection; failed verification");
-		g_return_val_if_fail (NM_IS_CONNECTION (connection), FALSE);
-	}
-
-	priv = NM_CONNECTION_GET_PRIVATE (connection);
-
 	/* First, make sure there's at least 'connection' setting */
 	s_con = nm_connection_get_setting_connection (connection);
 	if (!s_con) {
@@ -724,6 +757,90 @@ nm_connection_verify (NMConnection *connection, GError **error)
 	return TRUE;
 }
 
+/**
+ * nm_connection_verify:
+ * @connection: the #NMConnection to verify
+ * @error: location to store error, or %NULL
+ *
+ * Validates the connection and all its settings.  Each setting's properties
+ * have allowed values, and some values are dependent on other values.  For
+ * example, if a WiFi connection is security enabled, the #NMSettingWireless
+ * setting object's 'security' property must contain the setting name of the
+ * #NMSettingWirelessSecurity object, which must also be present in the 
+ * connection for the connection to be valid.  As another example, the
+ * #NMSettingWired object's 'mac-address' property must be a validly formatted
+ * MAC address.  The returned #GError contains information about which
+ * setting and which property failed validation, and how it failed validation.
+ *
+ * The result of a successful verification is remembered until a setting is
+ * added to or removed from the connection, or any property of one of its
+ * settings changes, so repeatedly verifying an unchanged connection is cheap.
+ *
+ * Returns: %TRUE if the connection is valid, %FALSE if it is not
+ **/
+gboolean
+nm_connection_verify (NMConnection *connection, GError **error)
+{
+	NMConnectionPrivate *priv;
+	GTimeVal start, end;
+	gboolean success;
+
+	if (error)
+		g_return_val_if_fail (*error == NULL, FALSE);
+
+	if (!NM_IS_CONNECTION (connection)) {
+		g_set_error_literal (error,
+		                     NM_SETTING_CONNECTION_ERROR,
+		                     NM_SETTING_CONNECTION_ERROR_UNKNOWN,
+		                     "invalid connection; failed verification");
+		g_return_val_if_fail (NM_IS_CONNECTION (connection), FALSE);
+	}
+
+	priv = NM_CONNECTION_GET_PRIVATE (connection);
+
+	if (priv->verified_generation && priv->verified_generation == priv->generation) {
+		verify_cached_count++;
+		return TRUE;
+	}
+
+	g_get_current_time (&start);
+	success = verify_settings (connection, error);
+	g_get_current_time (&end);
+
+	verify_full_count++;
+	verify_full_usec += MAX (0, ((gint64) end.tv_sec - start.tv_sec) * G_USEC_PER_SEC
+	                            + (end.tv_usec - start.tv_usec));
+
+	priv->verified_generation = success ? priv->generation : 0;
+	return success;
+}
+
+/**
+ * nm_connection_get_verify_stats:
+ * @out_full: (out) (allow-none): on return, the number of times
+ *   nm_connection_verify() fully validated a connection's settings
+ * @out_cached: (out) (allow-none): on return, the number of times
+ *   nm_connection_verify() returned a remembered result for an unchanged
+ *   connection
+ * @out_usec: (out) (allow-none): on return, the total time in microseconds
+ *   spent in full validations
+ *
+ * Returns process-wide counters describing the cost of connection
+ * verification.  For debugging and profiling purposes ONLY.
+ **/
+void
+nm_connection_get_verify_stats (guint *out_full,
+                                guint *out_cached,
+                                guint64 *out_usec)
+{
+	if (out_full)
+		*out_full = verify_full_count;
+	if (out_cached)
+		*out_cached = verify_cached_count;
+	if (out_usec)
+		*out_usec = verify_full_usec;
+}
+
 /**
  * nm_connection_update_secrets:
  * @connection: the #NMConnection
@@ -1194,13 +1311,21 @@ duplicate_cb (gpointer key, gpointer value, gpointer user_data)
 NMConnection *
 nm_connection_duplicate (NMConnection *connection)
 {
+	NMConnectionPrivate *priv, *dup_priv;
 	NMConnection *dup;
 
 	g_return_val_if_fail (NM_IS_CONNECTION (connection), NULL);
 
+	priv = NM_CONNECTION_GET_PRIVATE (connection);
+
 	dup = nm_connection_new ();
 	nm_connection_set_path (dup, nm_connection_get_path (connection));
-	g_hash_table_foreach (NM_CONNECTION_GET_PRIVATE (connection)->settings, duplicate_cb, dup);
+	g_hash_table_foreach (priv->settings, duplicate_cb, dup);
+
+	/* An exact copy of a verified connection is also valid */
+	dup_priv = NM_CONNECTION_GET_PRIVATE (dup);
+	if (priv->verified_generation && priv->verified_generation == priv->generation)
+		dup_priv->verified_generation = dup_priv->generation;
 
 	return dup;
 }
@@ -1632,7 +1757,7 @@ nm_connection_init (NMConnection *connection)
 {
 	NMConnectionPrivate *priv = NM_CONNECTION_GET_PRIVATE (connection);
 
-	priv->settings = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+	priv->settings = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
 }
 
 static void
@@ -1641,6 +1766,7 @@ finalize (GObject *object)
 	NMConnection *connection = NM_CONNECTION (object);
 	NMConnectionPrivate *priv = NM_CONNECTION_GET_PRIVATE (connection);
 
+	g_hash_table_foreach_remove (priv->settings, remove_one_setting, connection);
 	g_hash_table_destroy (priv->settings);
 	priv->settings = NULL;
 
@@ -146,6 +146,10 @@ gboolean      nm_connection_diff          (NMConnection *a,
 
 gboolean      nm_connection_verify        (NMConnection *connection, GError **error);
 
+void          nm_connection_get_verify_stats (guint *out_full,
+                                              guint *out_cached,
+                                              guint64 *out_usec);
+
 const char *  nm_connection_need_secrets  (NMConnection *connection,
                                            GPtrArray **hints);
 
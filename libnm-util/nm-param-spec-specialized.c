@@ -372,9 +372,8 @@ _gvalues_compare_map (const GValue *value1, const GValue *value2)
 }
 
 static gint
-_gvalue_ip6_address_compare (const GValue *value1, const GValue *value2)
+_ip6_address_compare (GValueArray *values1, GValueArray *values2)
 {
-	GValueArray *values1, *values2;
 	GValue *tmp_val;
 	GByteArray *addr1, *addr2;
 	guint32 prefix1, prefix2;
@@ -382,10 +381,6 @@ _gvalue_ip6_address_compare (const GValue *value1, const GValue *value2)
 	gint ret = 0;
 	int i;
 
-	/* IP6 addresses are GValueArrays (see nm-dbus-glib-types.h) */
-	values1 = g_value_get_boxed (value1);
-	values2 = g_value_get_boxed (value2);
-
 	/* Since they are NM IPv6 address structures, we expect both
 	 * to contain two elements as specified in nm-dbus-glib-types.h.
 	 */
@@ -430,9 +425,8 @@ _gvalue_ip6_address_compare (const GValue *value1, const GValue *value2)
 }
 
 static gint
-_gvalue_ip6_route_compare (const GValue *value1, const GValue *value2)
+_ip6_route_compare (GValueArray *values1, GValueArray *values2)
 {
-	GValueArray *values1, *values2;
 	GValue *tmp_val;
 	GByteArray *dest1, *dest2;
 	GByteArray *next_hop1, *next_hop2;
@@ -441,10 +435,6 @@ _gvalue_ip6_route_compare (const GValue *value1, const GValue *value2)
 	gint ret = 0;
 	int i;
 
-	/* IP6 routes are GValueArrays (see nm-dbus-glib-types.h) */
-	values1 = g_value_get_boxed (value1);
-	values2 = g_value_get_boxed (value2);
-
 	/* Since they are NM IPv6 route structures, we expect both
 	 * to contain 4 elements as specified in nm-dbus-glib-types.h.
 	 */
@@ -498,16 +488,193 @@ _gvalues_compare_struct (const GValue *value1, const GValue *value2)
 	 * _gvalues_compare() enforced that already.
 	 */
 
+	/* IP6 addresses and routes are GValueArrays (see nm-dbus-glib-types.h) */
 	if (G_VALUE_HOLDS (value1, DBUS_TYPE_G_IP6_ADDRESS)) {
-		return _gvalue_ip6_address_compare (value1, value2);
+		return _ip6_address_compare (g_value_get_boxed (value1), g_value_get_boxed (value2));
 	} else if (G_VALUE_HOLDS (value1, DBUS_TYPE_G_IP6_ROUTE)) {
-		return _gvalue_ip6_route_compare (value1, value2);
+		return _ip6_route_compare (g_value_get_boxed (value1), g_value_get_boxed (value2));
 	} else {
 		g_warning ("Don't know how to compare structures");
 		return (value1 == value2);
 	}
 }
 
+/* Direct comparators for the specialized types used by NMSetting
+ * properties.  These work on the boxed data itself and avoid the copying
+ * done by the generic collection and map code above.  Both pointers are
+ * non-NULL.
+ */
+
+typedef gint (*SpecializedCompareFunc) (gconstpointer p1, gconstpointer p2);
+
+#define CMP_LEN(len1, len2) ((len1) < (len2) ? -1 : (len1) > (len2))
+
+static gint
+_str_compare (const char *str1, const char *str2)
+{
+	if (str1 == str2)
+		return 0;
+	if (!str1)
+		return 1;
+	if (!str2)
+		return -1;
+	return strcmp (str1, str2);
+}
+
+static gint
+_byte_array_compare (gconstpointer p1, gconstpointer p2)
+{
+	const GByteArray *a1 = p1, *a2 = p2;
+
+	if (a1->len != a2->len)
+		return CMP_LEN (a1->len, a2->len);
+	return memcmp (a1->data, a2->data, a1->len);
+}
+
+static gint
+_uint_array_compare (gconstpointer p1, gconstpointer p2)
+{
+	const GArray *a1 = p1, *a2 = p2;
+
+	if (a1->len != a2->len)
+		return CMP_LEN (a1->len, a2->len);
+	return memcmp (a1->data, a2->data, a1->len * sizeof (guint));
+}
+
+static gint
+_ptr_array_compare (const GPtrArray *a1, const GPtrArray *a2, SpecializedCompareFunc func)
+{
+	gint ret;
+	guint i;
+
+	if (a1->len != a2->len)
+		return CMP_LEN (a1->len, a2->len);
+
+	for (i = 0; i < a1->len; i++) {
+		ret = func (g_ptr_array_index (a1, i), g_ptr_array_index (a2, i));
+		if (ret)
+			return ret;
+	}
+	return 0;
+}
+
+static gint
+_array_of_string_compare (gconstpointer p1, gconstpointer p2)
+{
+	return _ptr_array_compare (p1, p2, (SpecializedCompareFunc) _str_compare);
+}
+
+static gint
+_array_of_uint_array_compare (gconstpointer p1, gconstpointer p2)
+{
+	return _ptr_array_compare (p1, p2, _uint_array_compare);
+}
+
+static gint
+_array_of_byte_array_compare (gconstpointer p1, gconstpointer p2)
+{
+	return _ptr_array_compare (p1, p2, _byte_array_compare);
+}
+
+static gint
+_array_of_ip6_address_compare (gconstpointer p1, gconstpointer p2)
+{
+	return _ptr_array_compare (p1, p2, (SpecializedCompareFunc) _ip6_address_compare);
+}
+
+static gint
+_array_of_ip6_route_compare (gconstpointer p1, gconstpointer p2)
+{
+	return _ptr_array_compare (p1, p2, (SpecializedCompareFunc) _ip6_route_compare);
+}
+
+static gint
+_list_of_string_compare (gconstpointer p1, gconstpointer p2)
+{
+	const GSList *iter1 = p1, *iter2 = p2;
+	guint len1, len2;
+	gint ret;
+
+	len1 = g_slist_length ((GSList *) iter1);
+	len2 = g_slist_length ((GSList *) iter2);
+	if (len1 != len2)
+		return CMP_LEN (len1, len2);
+
+	for (; iter1 && iter2; iter1 = iter1->next, iter2 = iter2->next) {
+		ret = _str_compare (iter1->data, iter2->data);
+		if (ret)
+			return ret;
+	}
+	return 0;
+}
+
+static gint
+_map_of_string_compare (gconstpointer p1, gconstpointer p2)
+{
+	GHashTable *hash1 = (GHashTable *) p1, *hash2 = (GHashTable *) p2;
+	GHashTableIter iter;
+	gpointer key, value1, value2;
+	guint len1, len2;
+	gint ret;
+
+	len1 = g_hash_table_size (hash1);
+	len2 = g_hash_table_size (hash2);
+	if (len1 != len2)
+		return CMP_LEN (len1, len2);
+
+	g_hash_table_iter_init (&iter, hash1);
+	while (g_hash_table_iter_next (&iter, &key, &value1)) {
+		if (!g_hash_table_lookup_extended (hash2, key, NULL, &value2))
+			return 1;
+		ret = _str_compare (value1, value2);
+		if (ret)
+			return ret;
+	}
+	return 0;
+}
+
+typedef struct {
+	GType type;
+	SpecializedCompareFunc func;
+} SpecializedComparator;
+
+static SpecializedCompareFunc
+_get_specialized_comparator (GType type)
+{
+	static SpecializedComparator comparators[9];
+	guint i;
+
+	/* The DBUS_TYPE_* macros look up the type by name each time, so resolve
+	 * them only once.
+	 */
+	if (G_UNLIKELY (comparators[0].type == 0)) {
+		comparators[0].type = DBUS_TYPE_G_UCHAR_ARRAY;
+		comparators[0].func = _byte_array_compare;
+		comparators[1].type = DBUS_TYPE_G_UINT_ARRAY;
+		comparators[1].func = _uint_array_compare;
+		comparators[2].type = DBUS_TYPE_G_ARRAY_OF_ARRAY_OF_UINT;
+		comparators[2].func = _array_of_uint_array_compare;
+		comparators[3].type = DBUS_TYPE_G_MAP_OF_STRING;
+		comparators[3].func = _map_of_string_compare;
+		comparators[4].type = DBUS_TYPE_G_LIST_OF_STRING;
+		comparators[4].func = _list_of_string_compare;
+		comparators[5].type = DBUS_TYPE_G_ARRAY_OF_STRING;
+		comparators[5].func = _array_of_string_compare;
+		comparators[6].type = DBUS_TYPE_G_ARRAY_OF_ARRAY_OF_UCHAR;
+		comparators[6].func = _array_of_byte_array_compare;
+		comparators[7].type = DBUS_TYPE_G_ARRAY_OF_IP6_ADDRESS;
+		comparators[7].func = _array_of_ip6_address_compare;
+		comparators[8].type = DBUS_TYPE_G_ARRAY_OF_IP6_ROUTE;
+		comparators[8].func = _array_of_ip6_route_compare;
+	}
+
+	for (i = 0; i < G_N_ELEMENTS (comparators); i++) {
+		if (comparators[i].type == type)
+			return comparators[i].func;
+	}
+	return NULL;
+}
+
 gint
 _gvalues_compare (const GValue *value1, const GValue *value2)
 {
@@ -535,6 +702,7 @@ _gvalues_compare (const GValue *value1, const GValue *value2)
 	else if (G_VALUE_HOLDS_BOXED (value1)) {
 		gpointer p1 = g_value_get_boxed (value1);
 		gpointer p2 = g_value_get_boxed (value2);
+		SpecializedCompareFunc func;
 
 		if (p1 == p2)
 			ret = 0; /* Exactly the same values */
@@ -542,6 +710,8 @@ _gvalues_compare (const GValue *value1, const GValue *value2)
 			ret = 1; /* The comparision functions below don't handle NULLs */
 		else if (!p2)
 			ret = -1; /* The comparision functions below don't handle NULLs */
+		else if ((func = _get_specialized_comparator (type1)) != NULL)
+			ret = func (p1, p2);
 		else if (type1 == G_TYPE_STRV)
 			ret = _gvalues_compare_strv (value1, value2);
 		else if (dbus_g_type_is_collection (type1))
@@ -229,6 +229,15 @@ set_map (NMSettingVlan *self, NMVlanPriorityMap map, GSList *list)
 		g_assert_not_reached ();
 }
 
+static void
+notify_map (NMSettingVlan *self, NMVlanPriorityMap map)
+{
+	if (map == NM_VLAN_INGRESS_MAP)
+		g_object_notify (G_OBJECT (self), NM_SETTING_VLAN_INGRESS_PRIORITY_MAP);
+	else if (map == NM_VLAN_EGRESS_MAP)
+		g_object_notify (G_OBJECT (self), NM_SETTING_VLAN_EGRESS_PRIORITY_MAP);
+}
+
 /**
  * nm_setting_vlan_add_priority_str:
  * @setting: the #NMSettingVlan
@@ -268,11 +277,13 @@ nm_setting_vlan_add_priority_str (NMSettingVlan *setting,
 		if (p->from == item->from) {
 			p->to = item->to;
 			g_free (item);
+			notify_map (setting, map);
 			return TRUE;
 		}
 	}
 
 	set_map (setting, map, g_slist_append (list, item));
+	notify_map (setting, map);
 	return TRUE;
 }
 
@@ -372,6 +383,7 @@ nm_setting_vlan_add_priority (NMSettingVlan *setting,
 		item = iter->data;
 		if (item->from == from) {
 			item->to = to;
+			notify_map (setting, map);
 			return TRUE;
 		}
 	}
@@ -380,6 +392,7 @@ nm_setting_vlan_add_priority (NMSettingVlan *setting,
 	item->from = from;
 	item->to = to;
 	set_map (setting, map, g_slist_append (list, item));
+	notify_map (setting, map);
 
 	return TRUE;
 }
@@ -410,6 +423,7 @@ nm_setting_vlan_remove_priority (NMSettingVlan *setting,
 	item = g_slist_nth_data (list, idx);
 	priority_map_free ((PriorityMap *) item);
 	set_map (setting, map, g_slist_delete_link (list, item));
+	notify_map (setting, map);
 }
 
 /**
@@ -431,6 +445,7 @@ nm_setting_vlan_clear_priorities (NMSettingVlan *setting, NMVlanPriorityMap map)
 	list = get_map (setting, map);
 	nm_utils_slist_free (list, g_free);
 	set_map (setting, map, NULL);
+	notify_map (setting, map);
 }
 
 /*********************************************************************/
@@ -194,6 +194,7 @@ nm_setting_vpn_add_data_item (NMSettingVPN *setting,
 
 	g_hash_table_insert (NM_SETTING_VPN_GET_PRIVATE (setting)->data,
 	                     g_strdup (key), g_strdup (item));
+	g_object_notify (G_OBJECT (setting), NM_SETTING_VPN_DATA);
 }
 
 /**
@@ -228,6 +229,7 @@ nm_setting_vpn_remove_data_item (NMSettingVPN *setting, const char *key)
 	g_return_if_fail (NM_IS_SETTING_VPN (setting));
 
 	g_hash_table_remove (NM_SETTING_VPN_GET_PRIVATE (setting)->data, key);
+	g_object_notify (G_OBJECT (setting), NM_SETTING_VPN_DATA);
 }
 
 static void
@@ -319,6 +321,7 @@ nm_setting_vpn_add_secret (NMSettingVPN *setting,
 
 	g_hash_table_insert (NM_SETTING_VPN_GET_PRIVATE (setting)->secrets,
 	                     g_strdup (key), g_strdup (secret));
+	g_object_notify (G_OBJECT (setting), NM_SETTING_VPN_SECRETS);
 }
 
 /**
@@ -353,6 +356,7 @@ nm_setting_vpn_remove_secret (NMSettingVPN *setting, const char *key)
 	g_return_if_fail (NM_IS_SETTING_VPN (setting));
 
 	g_hash_table_remove (NM_SETTING_VPN_GET_PRIVATE (setting)->secrets, key);
+	g_object_notify (G_OBJECT (setting), NM_SETTING_VPN_SECRETS);
 }
 
 /**
@@ -428,6 +432,7 @@ update_secret_string (NMSetting *setting,
 	}
 
 	g_hash_table_insert (priv->secrets, g_strdup (key), g_strdup (value));
+	g_object_notify (G_OBJECT (setting), NM_SETTING_VPN_SECRETS);
 	return TRUE;
 }
 
@@ -475,6 +480,7 @@ update_secret_hash (NMSetting *setting,
 		g_hash_table_insert (priv->secrets, g_strdup (name), g_strdup (value));
 	}
 
+	g_object_notify (G_OBJECT (setting), NM_SETTING_VPN_SECRETS);
 	return TRUE;
 }
 
@@ -553,6 +559,7 @@ set_secret_flags (NMSetting *setting,
 	g_hash_table_insert (NM_SETTING_VPN_GET_PRIVATE (setting)->data,
 	                     g_strdup_printf ("%s-flags", secret_name),
 	                     g_strdup_printf ("%u", flags));
+	g_object_notify (G_OBJECT (setting), NM_SETTING_VPN_DATA);
 	return TRUE;
 }
 
@@ -634,6 +641,7 @@ clear_secrets_with_flags (NMSetting *setting,
 	NMSettingVPNPrivate *priv = NM_SETTING_VPN_GET_PRIVATE (setting);
 	GHashTableIter iter;
 	const char *secret;
+	gboolean changed = FALSE;
 
 	if (priv->secrets == NULL)
 		return;
@@ -644,9 +652,14 @@ clear_secrets_with_flags (NMSetting *setting,
 		NMSettingSecretFlags flags = NM_SETTING_SECRET_FLAG_NONE;
 
 		nm_setting_get_secret_flags (setting, secret, &flags, NULL);
-		if (func (setting, pspec->name, flags, user_data) == TRUE)
+		if (func (setting, pspec->name, flags, user_data) == TRUE) {
 			g_hash_table_iter_remove (&iter);
+			changed = TRUE;
+		}
 	}
+
+	if (changed)
+		g_object_notify (G_OBJECT (setting), NM_SETTING_VPN_SECRETS);
 }
 
 static void
@@ -219,6 +219,8 @@ get_encodings_for_lang (const char *lang,
 
 static gboolean initialized = FALSE;
 
+static void ssid_cache_flush (void);
+
 /**
  * nm_utils_init:
  * @error: location to store error, or %NULL
@@ -256,6 +258,8 @@ void
 nm_utils_deinit (void)
 {
 	if (initialized) {
+		ssid_cache_flush ();
+		crypto_file_cache_invalidate (NULL);
 		crypto_deinit ();
 		initialized = FALSE;
 	}
@@ -263,6 +267,135 @@ nm_utils_deinit (void)
 
 /* ssid helpers */
 
+/* The uncached conversion behind nm_utils_ssid_to_utf8() */
+static char *
+ssid_convert (const GByteArray *ssid)
+{
+	char *converted = NULL;
+	char *lang, *e1 = NULL, *e2 = NULL, *e3 = NULL;
+
+	/* LANG may be a good encoding hint */
+	g_get_charset ((const char **)(&e1));
+	if ((lang = getenv ("LANG"))) {
+		char * dot;
+
+		lang = g_ascii_strdown (lang, -1);
+		if ((dot = strchr (lang, '.')))
+			*dot = '\0';
+
+		get_encodings_for_lang (lang, &e1, &e2, &e3);
+		g_free (lang);
+	}
+
+	converted = g_convert ((const gchar *) ssid->data, ssid->len, "UTF-8", e1, NULL, NULL, NULL);
+	if (!converted && e2)
+		converted = g_convert ((const gchar *) ssid->data, ssid->len, "UTF-8", e2, NULL, NULL, NULL);
+
+	if (!converted && e3)
+		converted = g_convert ((const gchar *) ssid->data, ssid->len, "UTF-8", e3, NULL, NULL, NULL);
+
+	if (!converted) {
+		converted = g_convert_with_fallback ((const gchar *) ssid->data, ssid->len,
+		                                     "UTF-8", e1, "?", NULL, NULL, NULL);
+	}
+
+	return converted;
+}
+
+/* Conversions of non-UTF-8 SSIDs are cached, since the same handful of SSIDs
+ * get printed over and over again.  The result depends on LANG and the
+ * system charset, so the cache is flushed whenever either changes.
+ */
+
+#define SSID_CACHE_MAX_ENTRIES 64
+#define SSID_CACHE_MAX_LEN     32
+
+typedef struct {
+	guint8 ssid[SSID_CACHE_MAX_LEN];
+	guint len;
+	char *converted;
+	GList *lru_link;
+} SsidCacheEntry;
+
+G_LOCK_DEFINE_STATIC (ssid_cache);
+static GHashTable *ssid_cache = NULL;
+static GQueue ssid_cache_lru = G_QUEUE_INIT;
+static char *ssid_cache_lang = NULL;
+static char *ssid_cache_charset = NULL;
+
+static guint
+ssid_cache_entry_hash (gconstpointer key)
+{
+	const SsidCacheEntry *entry = key;
+	guint h = 5381, i;
+
+	for (i = 0; i < entry->len; i++)
+		h = (h << 5) + h + entry->ssid[i];
+	return h;
+}
+
+static gboolean
+ssid_cache_entry_equal (gconstpointer a, gconstpointer b)
+{
+	const SsidCacheEntry *entry_a = a, *entry_b = b;
+
+	return    entry_a->len == entry_b->len
+	       && memcmp (entry_a->ssid, entry_b->ssid, entry_a->len) == 0;
+}
+
+static void
+ssid_cache_entry_free (gpointer data)
+{
+	SsidCacheEntry *entry = data;
+
+	g_free (entry->converted);
+	g_slice_free (SsidCacheEntry, entry);
+}
+
+static void
+ssid_cache_clear (void)
+{
+	if (ssid_cache) {
+		g_hash_table_destroy (ssid_cache);
+		ssid_cache = NULL;
+	}
+	g_queue_clear (&ssid_cache_lru);
+	g_free (ssid_cache_lang);
+	ssid_cache_lang = NULL;
+	g_free (ssid_cache_charset);
+	ssid_cache_charset = NULL;
+}
+
+static void
+ssid_cache_flush (void)
+{
+	G_LOCK (ssid_cache);
+	ssid_cache_clear ();
+	G_UNLOCK (ssid_cache);
+}
+
+/* Must be called with the ssid_cache lock held */
+static void
+ssid_cache_check_locale (void)
+{
+	const char *lang = getenv ("LANG");
+	const char *charset = NULL;
+
+	g_get_charset (&charset);
+	if (   ssid_cache
+	    && g_strcmp0 (lang, ssid_cache_lang) == 0
+	    && g_strcmp0 (charset, ssid_cache_charset) == 0)
+		return;
+
+	ssid_cache_clear ();
+	ssid_cache = g_hash_table_new_full (ssid_cache_entry_hash,
+	                                    ssid_cache_entry_equal,
+	                                    NULL,
+	                                    ssid_cache_entry_free);
+	ssid_cache_lang = g_strdup (lang);
+	ssid_cache_charset = g_strdup (charset);
+}
+
 /**
  * nm_utils_ssid_to_utf8:
  * @ssid: a byte array containing the SSID data
@@ -287,6 +420,8 @@ nm_utils_deinit (void)
  *    ISO-8859-1 encoding, then to the Windows-1251 encoding.
  * 4) If step 3 fails, replaces non-UTF-8 characters with '?'.
  *
+ * Results of steps 2 - 4 are cached for recently seen SSIDs.
+ *
  * Again, this function should be used for debugging and display purposes
  * _only_.
  *
@@ -297,38 +432,63 @@ nm_utils_deinit (void)
 char *
 nm_utils_ssid_to_utf8 (const GByteArray *ssid)
 {
-	char *converted = NULL;
-	char *lang, *e1 = NULL, *e2 = NULL, *e3 = NULL;
+	SsidCacheEntry lookup, *entry;
+	char *converted;
+	guint i;
 
 	g_return_val_if_fail (ssid != NULL, NULL);
 
+	/* Plain printable ASCII is by far the most common case */
+	for (i = 0; i < ssid->len; i++) {
+		if (ssid->data[i] == 0 || ssid->data[i] >= 0x80)
+			break;
+	}
+	if (i == ssid->len)
+		return g_strndup ((const gchar *) ssid->data, ssid->len);
+
 	if (g_utf8_validate ((const gchar *) ssid->data, ssid->len, NULL))
 		return g_strndup ((const gchar *) ssid->data, ssid->len);
 
-	/* LANG may be a good encoding hint */
-	g_get_charset ((const char **)(&e1));
-	if ((lang = getenv ("LANG"))) {
-		char * dot;
+	if (ssid->len > SSID_CACHE_MAX_LEN)
+		return ssid_convert (ssid);
 
-		lang = g_ascii_strdown (lang, -1);
-		if ((dot = strchr (lang, '.')))
-			*dot = '\0';
+	G_LOCK (ssid_cache);
+	ssid_cache_check_locale ();
 
-		get_encodings_for_lang (lang, &e1, &e2, &e3);
-		g_free (lang);
+	memcpy (lookup.ssid, ssid->data, ssid->len);
+	lookup.len = ssid->len;
+	entry = g_hash_table_lookup (ssid_cache, &lookup);
+	if (entry) {
+		/* Move to the head of the LRU list */
+		g_queue_unlink (&ssid_cache_lru, entry->lru_link);
+		g_queue_push_head_link (&ssid_cache_lru, entry->lru_link);
+		converted = g_strdup (entry->converted);
+		G_UNLOCK (ssid_cache);
+		return converted;
 	}
+	G_UNLOCK (ssid_cache);
 
-	converted = g_convert ((const gchar *) ssid->data, ssid->len, "UTF-8", e1, NULL, NULL, NULL);
-	if (!converted && e2)
-		converted = g_convert ((const gchar *) ssid->data, ssid->len, "UTF-8", e2, NULL, NULL, NULL);
+	converted = ssid_convert (ssid);
+	if (!converted)
+		return NULL;
 
-	if (!converted && e3)
-		converted = g_convert ((const gchar *) ssid->data, ssid->len, "UTF-8", e3, NULL, NULL, NULL);
+	G_LOCK (ssid_cache);
+	/* The cache may have been flushed or filled while unlocked */
+	ssid_cache_check_locale ();
+	if (!g_hash_table_lookup (ssid_cache, &lookup)) {
+		if (g_queue_get_length (&ssid_cache_lru) >= SSID_CACHE_MAX_ENTRIES) {
+			entry = g_queue_pop_tail (&ssid_cache_lru);
+			g_hash_table_remove (ssid_cache, entry);
+		}
 
-	if (!converted) {
-		converted = g_convert_with_fallback ((const gchar *) ssid->data, ssid->len,
-		                                     "UTF-8", e1, "?", NULL, NULL, NULL);
+		entry = g_slice_new (SsidCacheEntry);
+		*entry = lookup;
+		entry->converted = g_strdup (converted);
+		g_queue_push_head (&ssid_cache_lru, entry);
+		entry->lru_link = g_queue_peek_head_link (&ssid_cache_lru);
+		g_hash_table_insert (ssid_cache, entry, entry);
 	}
+	G_UNLOCK (ssid_cache);
 
 	return converted;
 }
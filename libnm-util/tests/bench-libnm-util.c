@@ -0,0 +1,489 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2012 Red Hat, Inc.
+ *
+ */
+
+/* Microbenchmarks for the hot libnm-util paths.  Not run by 'make check';
+ * use 'make bench' in this directory, or run bench-libnm-util directly with
+ * an optional iteration count.  Allocation counts only cover the g_malloc()
+ * family, and are only available when GLib honors g_mem_set_vtable().
+ */
+
+#include <glib.h>
+#include <dbus/dbus-glib.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <arpa/inet.h>
+
+#include "nm-test-helpers.h"
+#include <nm-utils.h>
+
+#include "nm-setting-connection.h"
+#include "nm-setting-wired.h"
+#include "nm-setting-wireless.h"
+#include "nm-setting-wireless-security.h"
+#include "nm-setting-8021x.h"
+#include "nm-setting-ip4-config.h"
+#include "nm-setting-ip6-config.h"
+#include "nm-setting-vpn.h"
+#include "nm-setting-bond.h"
+
+#define TEST_CA_CERT     TEST_CERT_DIR "/test_ca_cert.pem"
+#define TEST_CLIENT_CERT TEST_CERT_DIR "/test_key_and_cert.pem"
+#define TEST_PRIVATE_KEY TEST_CERT_DIR "/test_key_and_cert.pem"
+
+#define DEFAULT_ITERATIONS 2000
+
+/*******************************************/
+
+static guint64 n_allocs = 0;
+static gboolean counting_allocs = FALSE;
+
+static gpointer
+count_malloc (gsize n_bytes)
+{
+	n_allocs++;
+	return malloc (n_bytes);
+}
+
+static gpointer
+count_realloc (gpointer mem, gsize n_bytes)
+{
+	n_allocs++;
+	return realloc (mem, n_bytes);
+}
+
+static gpointer
+count_calloc (gsize n_blocks, gsize n_block_bytes)
+{
+	n_allocs++;
+	return calloc (n_blocks, n_block_bytes);
+}
+
+static GMemVTable count_vtable = {
+	count_malloc,
+	count_realloc,
+	free,
+	count_calloc,
+	NULL,
+	NULL,
+};
+
+/*******************************************/
+
+static void
+add_connection_setting (NMConnection *connection, const char *id, const char *type)
+{
+	NMSetting *setting;
+	char *uuid;
+
+	setting = nm_setting_connection_new ();
+	uuid = nm_utils_uuid_generate ();
+	g_object_set (G_OBJECT (setting),
+	              NM_SETTING_CONNECTION_ID, id,
+	              NM_SETTING_CONNECTION_UUID, uuid,
+	              NM_SETTING_CONNECTION_TYPE, type,
+	              NM_SETTING_CONNECTION_TIMESTAMP, (guint64) 1325376000,
+	              NULL);
+	g_free (uuid);
+	nm_setting_connection_add_permission (NM_SETTING_CONNECTION (setting), "user", "alice", NULL);
+	nm_setting_connection_add_permission (NM_SETTING_CONNECTION (setting), "user", "bob", NULL);
+	nm_connection_add_setting (connection, setting);
+}
+
+static void
+add_ip4_setting (NMConnection *connection, guint n_addresses)
+{
+	NMSettingIP4Config *s_ip4;
+	NMIP4Address *addr;
+	guint i;
+
+	s_ip4 = (NMSettingIP4Config *) nm_setting_ip4_config_new ();
+	g_object_set (s_ip4,
+	              NM_SETTING_IP4_CONFIG_METHOD,
+	              n_addresses ? NM_SETTING_IP4_CONFIG_METHOD_MANUAL : NM_SETTING_IP4_CONFIG_METHOD_AUTO,
+	              NULL);
+
+	for (i = 0; i < n_addresses; i++) {
+		addr = nm_ip4_address_new ();
+		nm_ip4_address_set_address (addr, htonl (0x0a000001 + (i << 8)));
+		nm_ip4_address_set_prefix (addr, 24);
+		nm_ip4_address_set_gateway (addr, htonl (0x0a0000fe + (i << 8)));
+		nm_setting_ip4_config_add_address (s_ip4, addr);
+		nm_ip4_address_unref (addr);
+	}
+	nm_setting_ip4_config_add_dns (s_ip4, htonl (0x08080808));
+	nm_setting_ip4_config_add_dns (s_ip4, htonl (0x08080404));
+	nm_setting_ip4_config_add_dns_search (s_ip4, "example.com");
+	nm_setting_ip4_config_add_dns_search (s_ip4, "corp.example.com");
+
+	nm_connection_add_setting (connection, NM_SETTING (s_ip4));
+}
+
+static NMConnection *
+make_wired_connection (void)
+{
+	NMConnection *connection;
+	NMSetting *setting;
+
+	connection = nm_connection_new ();
+	add_connection_setting (connection, "Wired office", NM_SETTING_WIRED_SETTING_NAME);
+
+	setting = nm_setting_wired_new ();
+	g_object_set (G_OBJECT (setting), NM_SETTING_WIRED_MTU, 1500, NULL);
+	nm_connection_add_setting (connection, setting);
+
+	add_ip4_setting (connection, 4);
+
+	setting = nm_setting_ip6_config_new ();
+	g_object_set (G_OBJECT (setting),
+	              NM_SETTING_IP6_CONFIG_METHOD, NM_SETTING_IP6_CONFIG_METHOD_AUTO,
+	              NULL);
+	nm_connection_add_setting (connection, setting);
+
+	return connection;
+}
+
+static NMConnection *
+make_8021x_wifi_connection (void)
+{
+	NMConnection *connection;
+	NMSettingWireless *s_wifi;
+	NMSettingWirelessSecurity *s_wsec;
+	NMSetting8021x *s_8021x;
+	GByteArray *ssid;
+	GError *error = NULL;
+	gboolean success;
+
+	connection = nm_connection_new ();
+	add_connection_setting (connection, "Corporate WiFi", NM_SETTING_WIRELESS_SETTING_NAME);
+
+	s_wifi = (NMSettingWireless *) nm_setting_wireless_new ();
+	ssid = g_byte_array_new ();
+	g_byte_array_append (ssid, (const guint8 *) "corp-secure", strlen ("corp-secure"));
+	g_object_set (s_wifi,
+	              NM_SETTING_WIRELESS_SSID, ssid,
+	              NM_SETTING_WIRELESS_MODE, NM_SETTING_WIRELESS_MODE_INFRA,
+	              NM_SETTING_WIRELESS_SEC, NM_SETTING_WIRELESS_SECURITY_SETTING_NAME,
+	              NULL);
+	g_byte_array_free (ssid, TRUE);
+	nm_setting_wireless_add_seen_bssid (s_wifi, "00:11:22:33:44:55");
+	nm_setting_wireless_add_seen_bssid (s_wifi, "00:11:22:33:44:56");
+	nm_connection_add_setting (connection, NM_SETTING (s_wifi));
+
+	s_wsec = (NMSettingWirelessSecurity *) nm_setting_wireless_security_new ();
+	g_object_set (s_wsec, NM_SETTING_WIRELESS_SECURITY_KEY_MGMT, "wpa-eap", NULL);
+	nm_setting_wireless_security_add_proto (s_wsec, "rsn");
+	nm_setting_wireless_security_add_pairwise (s_wsec, "ccmp");
+	nm_setting_wireless_security_add_group (s_wsec, "ccmp");
+	nm_connection_add_setting (connection, NM_SETTING (s_wsec));
+
+	s_8021x = (NMSetting8021x *) nm_setting_802_1x_new ();
+	g_object_set (s_8021x, NM_SETTING_802_1X_IDENTITY, "Bill Smith", NULL);
+	nm_setting_802_1x_add_eap_method (s_8021x, "tls");
+
+	success = nm_setting_802_1x_set_ca_cert (s_8021x, TEST_CA_CERT,
+	                                         NM_SETTING_802_1X_CK_SCHEME_BLOB,
+	                                         NULL, &error);
+	ASSERT (success == TRUE, "8021x-wifi", "failed to set CA certificate: %s", error->message);
+
+	success = nm_setting_802_1x_set_client_cert (s_8021x, TEST_CLIENT_CERT,
+	                                             NM_SETTING_802_1X_CK_SCHEME_BLOB,
+	                                             NULL, &error);
+	ASSERT (success == TRUE, "8021x-wifi", "failed to set client certificate: %s", error->message);
+
+	success = nm_setting_802_1x_set_private_key (s_8021x, TEST_PRIVATE_KEY, "test",
+	                                             NM_SETTING_802_1X_CK_SCHEME_BLOB,
+	                                             NULL, &error);
+	ASSERT (success == TRUE, "8021x-wifi", "failed to set private key: %s", error->message);
+	nm_connection_add_setting (connection, NM_SETTING (s_8021x));
+
+	add_ip4_setting (connection, 0);
+
+	return connection;
+}
+
+static NMConnection *
+make_vpn_connection (void)
+{
+	NMConnection *connection;
+	NMSettingVPN *s_vpn;
+	char *key, *value;
+	guint i;
+
+	connection = nm_connection_new ();
+	add_connection_setting (connection, "Big VPN", NM_SETTING_VPN_SETTING_NAME);
+
+	s_vpn = (NMSettingVPN *) nm_setting_vpn_new ();
+	g_object_set (s_vpn,
+	              NM_SETTING_VPN_SERVICE_TYPE, "org.freedesktop.NetworkManager.openvpn",
+	              NM_SETTING_VPN_USER_NAME, "alice",
+	              NULL);
+
+	for (i = 0; i < 200; i++) {
+		key = g_strdup_printf ("option-%03u", i);
+		value = g_strdup_printf ("value for option %u with some realistic length", i);
+		nm_setting_vpn_add_data_item (s_vpn, key, value);
+		g_free (key);
+		g_free (value);
+	}
+	for (i = 0; i < 20; i++) {
+		key = g_strdup_printf ("secret-%02u", i);
+		value = g_strdup_printf ("s3kr1t-%u", i);
+		nm_setting_vpn_add_secret (s_vpn, key, value);
+		g_free (key);
+		g_free (value);
+	}
+	nm_connection_add_setting (connection, NM_SETTING (s_vpn));
+
+	add_ip4_setting (connection, 0);
+
+	return connection;
+}
+
+static NMConnection *
+make_bond_connection (void)
+{
+	NMConnection *connection;
+	NMSettingBond *s_bond;
+	GString *targets;
+	guint i;
+
+	connection = nm_connection_new ();
+	add_connection_setting (connection, "Bond uplink", NM_SETTING_BOND_SETTING_NAME);
+
+	s_bond = (NMSettingBond *) nm_setting_bond_new ();
+	g_object_set (s_bond, NM_SETTING_BOND_INTERFACE_NAME, "bond0", NULL);
+
+	targets = g_string_new (NULL);
+	for (i = 1; i <= 16; i++)
+		g_string_append_printf (targets, "%s192.168.%u.1", targets->len ? "," : "", i);
+
+	nm_setting_bond_add_option (s_bond, NM_SETTING_BOND_OPTION_MODE, "active-backup");
+	nm_setting_bond_add_option (s_bond, NM_SETTING_BOND_OPTION_MIIMON, "100");
+	nm_setting_bond_add_option (s_bond, NM_SETTING_BOND_OPTION_UPDELAY, "200");
+	nm_setting_bond_add_option (s_bond, NM_SETTING_BOND_OPTION_DOWNDELAY, "200");
+	nm_setting_bond_add_option (s_bond, NM_SETTING_BOND_OPTION_ARP_IP_TARGET, targets->str);
+	g_string_free (targets, TRUE);
+	nm_connection_add_setting (connection, NM_SETTING (s_bond));
+
+	add_ip4_setting (connection, 2);
+
+	return connection;
+}
+
+/*******************************************/
+
+typedef struct {
+	NMConnection *connection;
+	NMConnection *copy;
+	GHashTable *hash;
+} BenchData;
+
+typedef void (*BenchFunc) (BenchData *data);
+
+static void
+bench_compare (BenchData *data)
+{
+	nm_connection_compare (data->connection, data->copy, NM_SETTING_COMPARE_FLAG_EXACT);
+}
+
+static void
+bench_diff (BenchData *data)
+{
+	GHashTable *diffs = NULL;
+
+	nm_connection_diff (data->connection, data->copy, NM_SETTING_COMPARE_FLAG_EXACT, &diffs);
+	if (diffs)
+		g_hash_table_destroy (diffs);
+}
+
+static void
+bench_to_hash (BenchData *data)
+{
+	g_hash_table_destroy (nm_connection_to_hash (data->connection, NM_SETTING_HASH_FLAG_ALL));
+}
+
+static void
+bench_new_from_hash (BenchData *data)
+{
+	g_object_unref (nm_connection_new_from_hash (data->hash, NULL));
+}
+
+static void
+bench_duplicate (BenchData *data)
+{
+	g_object_unref (nm_connection_duplicate (data->connection));
+}
+
+static void
+bench_verify (BenchData *data)
+{
+	nm_connection_verify (data->connection, NULL);
+}
+
+static void
+bench_verify_changed (BenchData *data)
+{
+	/* Touch a property so the cached verification result is dropped */
+	g_object_notify (G_OBJECT (nm_connection_get_setting_connection (data->connection)),
+	                 NM_SETTING_CONNECTION_ID);
+	nm_connection_verify (data->connection, NULL);
+}
+
+static void
+print_result (const char *op, const char *corpus, guint iterations, gdouble elapsed, guint64 allocs)
+{
+	if (counting_allocs) {
+		fprintf (stdout, "%-24s %-12s %12.0f ns/op %10.1f allocs/op\n",
+		         op, corpus, elapsed * 1e9 / iterations, (gdouble) allocs / iterations);
+	} else {
+		fprintf (stdout, "%-24s %-12s %12.0f ns/op %10s allocs/op\n",
+		         op, corpus, elapsed * 1e9 / iterations, "-");
+	}
+}
+
+static void
+run_bench (const char *op,
+           const char *corpus,
+           guint iterations,
+           BenchFunc func,
+           BenchData *data)
+{
+	GTimer *timer;
+	guint64 start_allocs;
+	guint i;
+
+	/* Warm up caches and lazily-created types */
+	func (data);
+
+	timer = g_timer_new ();
+	start_allocs = n_allocs;
+	g_timer_start (timer);
+	for (i = 0; i < iterations; i++)
+		func (data);
+	g_timer_stop (timer);
+
+	print_result (op, corpus, iterations, g_timer_elapsed (timer, NULL), n_allocs - start_allocs);
+	g_timer_destroy (timer);
+}
+
+static void
+bench_corpus (const char *corpus, NMConnection *connection, guint iterations)
+{
+	BenchData data;
+	GError *error = NULL;
+
+	ASSERT (nm_connection_verify (connection, &error) == TRUE, corpus,
+	        "corpus connection failed to verify: %s",
+	        error ? error->message : "(none)");
+
+	data.connection = connection;
+	data.copy = nm_connection_duplicate (connection);
+	data.hash = nm_connection_to_hash (connection, NM_SETTING_HASH_FLAG_ALL);
+
+	run_bench ("compare", corpus, iterations, bench_compare, &data);
+	run_bench ("diff", corpus, iterations, bench_diff, &data);
+	run_bench ("to_hash", corpus, iterations, bench_to_hash, &data);
+	run_bench ("new_from_hash", corpus, iterations, bench_new_from_hash, &data);
+	run_bench ("duplicate", corpus, iterations, bench_duplicate, &data);
+	run_bench ("verify", corpus, iterations, bench_verify, &data);
+	run_bench ("verify (after change)", corpus, iterations, bench_verify_changed, &data);
+
+	g_hash_table_destroy (data.hash);
+	g_object_unref (data.copy);
+	g_object_unref (connection);
+}
+
+static void
+bench_ssid_to_utf8 (guint iterations)
+{
+	static const struct {
+		const char *name;
+		const char *ssid;
+	} ssids[] = {
+		{ "ascii",  "linksys" },
+		{ "utf8",   "caf\xc3\xa9-g\xc3\xa4ste" },
+		{ "latin1", "caf\xe9-g\xe4ste" },
+		{ NULL,     NULL },
+	};
+	GByteArray *ssid;
+	GTimer *timer;
+	guint64 start_allocs;
+	guint i, j;
+
+	for (i = 0; ssids[i].name; i++) {
+		ssid = g_byte_array_new ();
+		g_byte_array_append (ssid, (const guint8 *) ssids[i].ssid, strlen (ssids[i].ssid));
+
+		g_free (nm_utils_ssid_to_utf8 (ssid));
+
+		timer = g_timer_new ();
+		start_allocs = n_allocs;
+		g_timer_start (timer);
+		for (j = 0; j < iterations; j++)
+			g_free (nm_utils_ssid_to_utf8 (ssid));
+		g_timer_stop (timer);
+
+		print_result ("ssid_to_utf8", ssids[i].name, iterations,
+		              g_timer_elapsed (timer, NULL), n_allocs - start_allocs);
+		g_timer_destroy (timer);
+		g_byte_array_free (ssid, TRUE);
+	}
+}
+
+int main (int argc, char **argv)
+{
+	GError *error = NULL;
+	guint iterations = DEFAULT_ITERATIONS;
+	guint64 before;
+	char *base;
+
+	/* Both must happen before anything else touches GLib */
+	setenv ("G_SLICE", "always-malloc", 1);
+	g_mem_set_vtable (&count_vtable);
+
+	before = n_allocs;
+	g_free (g_malloc (1));
+	counting_allocs = (n_allocs != before);
+
+	if (argc > 1) {
+		iterations = (guint) strtoul (argv[1], NULL, 10);
+		ASSERT (iterations > 0, "bench-libnm-util", "usage: %s [iterations]", argv[0]);
+	}
+
+	g_type_init ();
+
+	if (!nm_utils_init (&error))
+		FAIL ("nm-utils-init", "failed to initialize libnm-util: %s", error->message);
+
+	fprintf (stdout, "%u iterations per operation\n", iterations);
+
+	bench_corpus ("wired", make_wired_connection (), iterations);
+	bench_corpus ("8021x-wifi", make_8021x_wifi_connection (), iterations);
+	bench_corpus ("vpn", make_vpn_connection (), iterations);
+	bench_corpus ("bond", make_bond_connection (), iterations);
+	bench_ssid_to_utf8 (iterations * 10);
+
+	base = g_path_get_basename (argv[0]);
+	fprintf (stdout, "%s: SUCCESS\n", base);
+	g_free (base);
+	return 0;
+}
@@ -113,6 +113,46 @@ test_load_cert (const char *path, const char *desc)
 	g_byte_array_free (array, TRUE);
 }
 
+static void
+test_cert_cache (const char *path, const char *desc)
+{
+	GByteArray *array1, *array2;
+	NMCryptoFileFormat format = NM_CRYPTO_FILE_FORMAT_UNKNOWN;
+	GError *error = NULL;
+	gsize bytes = 0;
+
+	crypto_file_cache_invalidate (NULL);
+	ASSERT (crypto_file_cache_get_size (NULL) == 0, desc, "cache not empty after invalidation");
+
+	array1 = crypto_load_and_verify_certificate (path, &format, &error);
+	ASSERT (array1 != NULL, desc,
+	        "couldn't read certificate file '%s': %d %s",
+	        path, error->code, error->message);
+	ASSERT (crypto_file_cache_get_size (&bytes) == 1, desc, "certificate file not cached");
+	ASSERT (bytes == array1->len, desc, "unexpected cache size %u", (guint) bytes);
+
+	/* Second load should come from the cache and return an identical copy */
+	format = NM_CRYPTO_FILE_FORMAT_UNKNOWN;
+	array2 = crypto_load_and_verify_certificate (path, &format, &error);
+	ASSERT (array2 != NULL, desc,
+	        "couldn't read cached certificate file '%s': %d %s",
+	        path, error->code, error->message);
+	ASSERT (format == NM_CRYPTO_FILE_FORMAT_X509, desc,
+	        "%s: unexpected cached certificate format (expected %d, got %d)",
+	        path, NM_CRYPTO_FILE_FORMAT_X509, format);
+	ASSERT (array1 != array2, desc, "cached certificate data not copied");
+	ASSERT (array1->len == array2->len && !memcmp (array1->data, array2->data, array1->len),
+	        desc, "cached certificate data differs");
+	ASSERT (crypto_file_cache_get_size (NULL) == 1, desc, "certificate file cached twice");
+
+	crypto_file_cache_invalidate (path);
+	ASSERT (crypto_file_cache_get_size (&bytes) == 0 && bytes == 0, desc,
+	        "certificate file still cached after invalidation");
+
+	g_byte_array_free (array1, TRUE);
+	g_byte_array_free (array2, TRUE);
+}
+
 static GByteArray *
 file_to_byte_array (const char *filename)
 {
@@ -321,9 +361,10 @@ int main (int argc, char **argv)
 	if (!crypto_init (&error))
 		FAIL ("crypto-init", "failed to initialize crypto: %s", error->message);
 
-	if (!strcmp (argv[1], "--cert"))
+	if (!strcmp (argv[1], "--cert")) {
 		test_load_cert (argv[2], "cert");
-	else if (!strcmp (argv[1], "--key")) {
+		test_cert_cache (argv[2], "cert-cache");
+	} else if (!strcmp (argv[1], "--key")) {
 		const char *decrypted_path = (argc == 5) ? argv[4] : NULL;
 
 		ASSERT (argc == 4 || argc == 5, "test-crypto",
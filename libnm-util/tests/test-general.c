@@ -22,7 +22,9 @@
 #include <glib.h>
 #include <dbus/dbus-glib.h>
 #include <string.h>
+#include <locale.h>
 #include <netinet/ether.h>
+#include <arpa/inet.h>
 #include <linux/if_infiniband.h>
 
 #include "nm-test-helpers.h"
@@ -1232,6 +1234,96 @@ test_connection_bad_base_types (void)
 	g_clear_error (&error);
 }
 
+static void
+test_connection_verify_cached (void)
+{
+	NMConnection *connection, *dup;
+	NMSettingConnection *s_con;
+	NMSettingIP4Config *s_ip4;
+	NMIP4Address *addr;
+	guint full = 0, cached = 0, full2 = 0, cached2 = 0;
+	GError *error = NULL;
+
+	connection = new_test_connection ();
+
+	/* First verification does the work */
+	nm_connection_get_verify_stats (&full, &cached, NULL);
+	g_assert (nm_connection_verify (connection, &error));
+	g_assert_no_error (error);
+	nm_connection_get_verify_stats (&full2, &cached2, NULL);
+	g_assert_cmpuint (full2, ==, full + 1);
+	g_assert_cmpuint (cached2, ==, cached);
+
+	/* Verifying an unchanged connection again is remembered */
+	g_assert (nm_connection_verify (connection, &error));
+	g_assert_no_error (error);
+	nm_connection_get_verify_stats (&full, &cached, NULL);
+	g_assert_cmpuint (full, ==, full2);
+	g_assert_cmpuint (cached, ==, cached2 + 1);
+
+	/* And so is verifying an exact duplicate */
+	dup = nm_connection_duplicate (connection);
+	g_assert (nm_connection_verify (dup, &error));
+	g_assert_no_error (error);
+	nm_connection_get_verify_stats (&full2, &cached2, NULL);
+	g_assert_cmpuint (full2, ==, full);
+	g_object_unref (dup);
+
+	/* Property changes invalidate the remembered result */
+	s_con = nm_connection_get_setting_connection (connection);
+	g_object_set (G_OBJECT (s_con), NM_SETTING_CONNECTION_ID, NULL, NULL);
+	g_assert (nm_connection_verify (connection, &error) == FALSE);
+	g_clear_error (&error);
+	g_object_set (G_OBJECT (s_con), NM_SETTING_CONNECTION_ID, "foobar", NULL);
+	g_assert (nm_connection_verify (connection, &error));
+	g_assert_no_error (error);
+
+	/* As do changes made through setting helper functions */
+	s_ip4 = nm_connection_get_setting_ip4_config (connection);
+	addr = nm_ip4_address_new ();
+	nm_ip4_address_set_address (addr, 0x01020304);
+	nm_ip4_address_set_prefix (addr, 24);
+	nm_setting_ip4_config_add_address (s_ip4, addr);
+	nm_ip4_address_unref (addr);
+	g_object_set (G_OBJECT (s_ip4),
+	              NM_SETTING_IP4_CONFIG_METHOD, NM_SETTING_IP4_CONFIG_METHOD_MANUAL,
+	              NULL);
+	g_assert (nm_connection_verify (connection, &error));
+	g_assert_no_error (error);
+
+	nm_setting_ip4_config_clear_addresses (s_ip4);
+	g_assert (nm_connection_verify (connection, &error) == FALSE);
+	g_clear_error (&error);
+
+	/* And removing settings */
+	g_object_set (G_OBJECT (s_ip4),
+	              NM_SETTING_IP4_CONFIG_METHOD, NM_SETTING_IP4_CONFIG_METHOD_AUTO,
+	              NULL);
+	g_assert (nm_connection_verify (connection, &error));
+	g_assert_no_error (error);
+	nm_connection_remove_setting (connection, NM_TYPE_SETTING_WIRED);
+	g_assert (nm_connection_verify (connection, &error) == FALSE);
+	g_clear_error (&error);
+	g_object_unref (connection);
+
+	/* A setting shared with another connection still invalidates this one
+	 * after the other connection drops it.
+	 */
+	connection = new_test_connection ();
+	dup = nm_connection_new ();
+	s_con = nm_connection_get_setting_connection (connection);
+	nm_connection_add_setting (dup, g_object_ref (s_con));
+	g_assert (nm_connection_verify (connection, &error));
+	g_assert_no_error (error);
+	g_object_unref (dup);
+
+	g_object_set (G_OBJECT (s_con), NM_SETTING_CONNECTION_ID, NULL, NULL);
+	g_assert (nm_connection_verify (connection, &error) == FALSE);
+	g_clear_error (&error);
+
+	g_object_unref (connection);
+}
+
 static void
 test_setting_compare_id (void)
 {
@@ -1256,6 +1348,99 @@ test_setting_compare_id (void)
 	g_assert (success);
 }
 
+static void
+test_setting_compare_ip_config (void)
+{
+	NMSettingIP4Config *s_ip4, *s_ip4_dup;
+	NMSettingIP6Config *s_ip6, *s_ip6_dup;
+	NMIP4Address *addr4;
+	NMIP6Address *addr6;
+	struct in6_addr in6;
+
+	s_ip4 = (NMSettingIP4Config *) nm_setting_ip4_config_new ();
+	g_object_set (s_ip4, NM_SETTING_IP4_CONFIG_METHOD, NM_SETTING_IP4_CONFIG_METHOD_MANUAL, NULL);
+	addr4 = nm_ip4_address_new ();
+	nm_ip4_address_set_address (addr4, 0x01020304);
+	nm_ip4_address_set_prefix (addr4, 24);
+	nm_setting_ip4_config_add_address (s_ip4, addr4);
+	nm_setting_ip4_config_add_dns (s_ip4, 0x08080808);
+	nm_setting_ip4_config_add_dns_search (s_ip4, "example.com");
+
+	s_ip4_dup = (NMSettingIP4Config *) nm_setting_duplicate (NM_SETTING (s_ip4));
+	g_assert (nm_setting_compare (NM_SETTING (s_ip4), NM_SETTING (s_ip4_dup), NM_SETTING_COMPARE_FLAG_EXACT));
+
+	/* Same length, different element in the array of arrays */
+	nm_setting_ip4_config_clear_addresses (s_ip4_dup);
+	nm_ip4_address_set_prefix (addr4, 16);
+	nm_setting_ip4_config_add_address (s_ip4_dup, addr4);
+	g_assert (!nm_setting_compare (NM_SETTING (s_ip4), NM_SETTING (s_ip4_dup), NM_SETTING_COMPARE_FLAG_EXACT));
+	g_object_unref (s_ip4_dup);
+
+	/* Different string list */
+	s_ip4_dup = (NMSettingIP4Config *) nm_setting_duplicate (NM_SETTING (s_ip4));
+	nm_setting_ip4_config_clear_dns_searches (s_ip4_dup);
+	nm_setting_ip4_config_add_dns_search (s_ip4_dup, "example.org");
+	g_assert (!nm_setting_compare (NM_SETTING (s_ip4), NM_SETTING (s_ip4_dup), NM_SETTING_COMPARE_FLAG_EXACT));
+	g_object_unref (s_ip4_dup);
+
+	nm_ip4_address_unref (addr4);
+	g_object_unref (s_ip4);
+
+	s_ip6 = (NMSettingIP6Config *) nm_setting_ip6_config_new ();
+	g_object_set (s_ip6, NM_SETTING_IP6_CONFIG_METHOD, NM_SETTING_IP6_CONFIG_METHOD_MANUAL, NULL);
+	addr6 = nm_ip6_address_new ();
+	inet_pton (AF_INET6, "2001:db8::1", &in6);
+	nm_ip6_address_set_address (addr6, &in6);
+	nm_ip6_address_set_prefix (addr6, 64);
+	nm_setting_ip6_config_add_address (s_ip6, addr6);
+	nm_setting_ip6_config_add_dns (s_ip6, &in6);
+
+	s_ip6_dup = (NMSettingIP6Config *) nm_setting_duplicate (NM_SETTING (s_ip6));
+	g_assert (nm_setting_compare (NM_SETTING (s_ip6), NM_SETTING (s_ip6_dup), NM_SETTING_COMPARE_FLAG_EXACT));
+
+	nm_setting_ip6_config_clear_addresses (s_ip6_dup);
+	inet_pton (AF_INET6, "2001:db8::2", &in6);
+	nm_ip6_address_set_address (addr6, &in6);
+	nm_setting_ip6_config_add_address (s_ip6_dup, addr6);
+	g_assert (!nm_setting_compare (NM_SETTING (s_ip6), NM_SETTING (s_ip6_dup), NM_SETTING_COMPARE_FLAG_EXACT));
+	g_object_unref (s_ip6_dup);
+
+	/* Different array of byte arrays */
+	s_ip6_dup = (NMSettingIP6Config *) nm_setting_duplicate (NM_SETTING (s_ip6));
+	nm_setting_ip6_config_clear_dns (s_ip6_dup);
+	nm_setting_ip6_config_add_dns (s_ip6_dup, &in6);
+	g_assert (!nm_setting_compare (NM_SETTING (s_ip6), NM_SETTING (s_ip6_dup), NM_SETTING_COMPARE_FLAG_EXACT));
+	g_object_unref (s_ip6_dup);
+
+	nm_ip6_address_unref (addr6);
+	g_object_unref (s_ip6);
+}
+
+static void
+test_setting_compare_vpn_data (void)
+{
+	NMSettingVPN *s_vpn, *s_vpn_dup;
+
+	s_vpn = (NMSettingVPN *) nm_setting_vpn_new ();
+	nm_setting_vpn_add_data_item (s_vpn, "foo", "bar");
+	nm_setting_vpn_add_data_item (s_vpn, "baz", "bam");
+
+	s_vpn_dup = (NMSettingVPN *) nm_setting_duplicate (NM_SETTING (s_vpn));
+	g_assert (nm_setting_compare (NM_SETTING (s_vpn), NM_SETTING (s_vpn_dup), NM_SETTING_COMPARE_FLAG_EXACT));
+
+	/* Same keys, different value */
+	nm_setting_vpn_add_data_item (s_vpn_dup, "baz", "boo");
+	g_assert (!nm_setting_compare (NM_SETTING (s_vpn), NM_SETTING (s_vpn_dup), NM_SETTING_COMPARE_FLAG_EXACT));
+
+	/* Same size, different key */
+	nm_setting_vpn_remove_data_item (s_vpn_dup, "baz");
+	nm_setting_vpn_add_data_item (s_vpn_dup, "qux", "bam");
+	g_assert (!nm_setting_compare (NM_SETTING (s_vpn), NM_SETTING (s_vpn_dup), NM_SETTING_COMPARE_FLAG_EXACT));
+
+	g_object_unref (s_vpn_dup);
+	g_object_unref (s_vpn);
+}
+
 static void
 test_setting_compare_secrets (NMSettingSecretFlags secret_flags,
                               NMSettingCompareFlags comp_flags,
@@ -1321,6 +1506,67 @@ test_setting_compare_vpn_secrets (NMSettingSecretFlags secret_flags,
 	g_assert (success);
 }
 
+static char *
+ssid_to_utf8 (const char *data, guint len)
+{
+	GByteArray *ssid;
+	char *utf8;
+
+	ssid = g_byte_array_sized_new (len);
+	g_byte_array_append (ssid, (const guint8 *) data, len);
+	utf8 = nm_utils_ssid_to_utf8 (ssid);
+	g_byte_array_free (ssid, TRUE);
+	return utf8;
+}
+
+static void
+test_utils_ssid_to_utf8 (void)
+{
+	char *old_lang, *old_charset, *utf8;
+
+	/* The conversion depends on LANG and the locale's charset; pin both */
+	old_lang = g_strdup (g_getenv ("LANG"));
+	old_charset = g_strdup (g_getenv ("CHARSET"));
+	g_unsetenv ("CHARSET");
+	setlocale (LC_ALL, "C");
+	g_setenv ("LANG", "C", TRUE);
+
+	utf8 = ssid_to_utf8 ("linksys", 7);
+	g_assert_cmpstr (utf8, ==, "linksys");
+	g_free (utf8);
+
+	utf8 = ssid_to_utf8 ("caf\xc3\xa9", 5);
+	g_assert_cmpstr (utf8, ==, "caf\xc3\xa9");
+	g_free (utf8);
+
+	/* Latin-1 is converted, and the cached result must match */
+	g_setenv ("LANG", "de_DE", TRUE);
+	utf8 = ssid_to_utf8 ("caf\xe9", 4);
+	g_assert_cmpstr (utf8, ==, "caf\xc3\xa9");
+	g_free (utf8);
+	utf8 = ssid_to_utf8 ("caf\xe9", 4);
+	g_assert_cmpstr (utf8, ==, "caf\xc3\xa9");
+	g_free (utf8);
+
+	/* Changing the language must not return the stale cached conversion */
+	g_setenv ("LANG", "ru_RU", TRUE);
+	utf8 = ssid_to_utf8 ("\xf0\xd2\xc9\xd7\xc5\xd4", 6);
+	g_assert_cmpstr (utf8, ==, "\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82");
+	g_free (utf8);
+	utf8 = ssid_to_utf8 ("caf\xe9", 4);
+	g_assert_cmpstr (utf8, !=, "caf\xc3\xa9");
+	g_free (utf8);
+
+	if (old_lang)
+		g_setenv ("LANG", old_lang, TRUE);
+	else
+		g_unsetenv ("LANG");
+	g_free (old_lang);
+	if (old_charset)
+		g_setenv ("CHARSET", old_charset, TRUE);
+	g_free (old_charset);
+}
+
 static void
 test_hwaddr_aton_ether_normal (void)
 {
@@ -1385,6 +1631,8 @@ int main (int argc, char **argv)
 	test_setting_to_hash_no_secrets ();
 	test_setting_to_hash_only_secrets ();
 	test_setting_compare_id ();
+	test_setting_compare_ip_config ();
+	test_setting_compare_vpn_data ();
 	test_setting_compare_secrets (NM_SETTING_SECRET_FLAG_AGENT_OWNED, NM_SETTING_COMPARE_FLAG_IGNORE_AGENT_OWNED_SECRETS, TRUE);
 	test_setting_compare_secrets (NM_SETTING_SECRET_FLAG_NOT_SAVED, NM_SETTING_COMPARE_FLAG_IGNORE_NOT_SAVED_SECRETS, TRUE);
 	test_setting_compare_secrets (NM_SETTING_SECRET_FLAG_NONE, NM_SETTING_COMPARE_FLAG_IGNORE_SECRETS, TRUE);
@@ -1403,6 +1651,9 @@ int main (int argc, char **argv)
 	test_connection_diff_no_secrets ();
 	test_connection_good_base_types ();
 	test_connection_bad_base_types ();
+	test_connection_verify_cached ();
+
+	test_utils_ssid_to_utf8 ();
 
 	test_hwaddr_aton_ether_normal ();
 	test_hwaddr_aton_ib_normal ();
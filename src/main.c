@@ -55,6 +55,7 @@
 #include "nm-config.h"
 #include "nm-posix-signals.h"
 #include "nm-system.h"
+#include "nm-properties-changed-signal.h"
 
 #if !defined(NM_DIST_VERSION)
 # define NM_DIST_VERSION VERSION
@@ -533,6 +534,8 @@ main (int argc, char *argv[])
 	/* Initialize our DBus service & connection */
 	dbus_mgr = nm_dbus_manager_get ();
 
+	nm_properties_changed_signal_set_rate_limit (nm_config_get_properties_changed_interval (config));
+
 	vpn_manager = nm_vpn_manager_get ();
 	if (!vpn_manager) {
 		nm_log_err (LOGD_CORE, "failed to start the VPN manager.");
@@ -498,7 +498,7 @@ nm_active_connection_class_init (NMActiveConnectionClass *vpn_class)
 		nm_properties_changed_signal_new (object_class,
 		                                  G_STRUCT_OFFSET (NMActiveConnectionClass, properties_changed));
 
-	dbus_g_object_type_install_info (G_TYPE_FROM_CLASS (vpn_class),
-									 &dbus_glib_nm_active_connection_object_info);
+	nm_properties_changed_signal_install_info (G_OBJECT_CLASS (vpn_class),
+	                                           &dbus_glib_nm_active_connection_object_info);
 }
 
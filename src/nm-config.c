@@ -37,6 +37,7 @@ struct NMConfig {
 	char *connectivity_uri;
 	guint connectivity_interval;
 	char *connectivity_response;
+	guint properties_changed_interval;
 };
 
 /************************************************************************/
@@ -124,6 +125,14 @@ nm_config_get_connectivity_response (NMConfig *config)
 	return config->connectivity_response;
 }
 
+guint
+nm_config_get_properties_changed_interval (NMConfig *config)
+{
+	g_return_val_if_fail (config != NULL, 0);
+
+	return config->properties_changed_interval;
+}
+
 
 /************************************************************************/
 
@@ -165,6 +174,7 @@ fill_from_file (NMConfig *config,
 
 		config->dhcp_client = g_key_file_get_value (kf, "main", "dhcp", NULL);
 		config->dns_plugins = g_key_file_get_string_list (kf, "main", "dns", NULL, NULL);
+		config->properties_changed_interval = MAX (0, g_key_file_get_integer (kf, "main", "properties-changed-interval", NULL));
 
 		if (cli_log_level && strlen (cli_log_level))
 			config->log_level = g_strdup (cli_log_level);
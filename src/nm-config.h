@@ -52,6 +52,7 @@ const char *nm_config_get_log_domains (NMConfig *config);
 const char *nm_config_get_connectivity_uri (NMConfig *config);
 const guint nm_config_get_connectivity_interval (NMConfig *config);
 const char *nm_config_get_connectivity_response (NMConfig *config);
+guint nm_config_get_properties_changed_interval (NMConfig *config);
 
 void nm_config_free (NMConfig *config);
 
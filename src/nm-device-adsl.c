@@ -846,6 +846,6 @@ nm_device_adsl_class_init (NMDeviceAdslClass *klass)
 		nm_properties_changed_signal_new (object_class,
 		                                  G_STRUCT_OFFSET (NMDeviceAdslClass, properties_changed));
 
-	dbus_g_object_type_install_info (G_TYPE_FROM_CLASS (klass),
-	                                 &dbus_glib_nm_device_adsl_object_info);
+	nm_properties_changed_signal_install_info (G_OBJECT_CLASS (klass),
+	                                           &dbus_glib_nm_device_adsl_object_info);
 }
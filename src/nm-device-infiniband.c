@@ -502,8 +502,8 @@ nm_device_infiniband_class_init (NMDeviceInfinibandClass *klass)
 		nm_properties_changed_signal_new (object_class,
 										  G_STRUCT_OFFSET (NMDeviceInfinibandClass, properties_changed));
 
-	dbus_g_object_type_install_info (G_TYPE_FROM_CLASS (klass),
-									 &dbus_glib_nm_device_infiniband_object_info);
+	nm_properties_changed_signal_install_info (G_OBJECT_CLASS (klass),
+	                                           &dbus_glib_nm_device_infiniband_object_info);
 
 	dbus_g_error_domain_register (NM_INFINIBAND_ERROR, NULL, NM_TYPE_INFINIBAND_ERROR);
 }
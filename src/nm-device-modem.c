@@ -539,6 +539,6 @@ nm_device_modem_class_init (NMDeviceModemClass *mclass)
 					  g_cclosure_marshal_VOID__VOID,
 					  G_TYPE_NONE, 0);
 
-	dbus_g_object_type_install_info (G_TYPE_FROM_CLASS (mclass),
-	                                 &dbus_glib_nm_device_modem_object_info);
+	nm_properties_changed_signal_install_info (G_OBJECT_CLASS (mclass),
+	                                           &dbus_glib_nm_device_modem_object_info);
 }
@@ -551,7 +551,7 @@ nm_device_olpc_mesh_class_init (NMDeviceOlpcMeshClass *klass)
 		nm_properties_changed_signal_new (object_class,
 		                                  G_STRUCT_OFFSET (NMDeviceOlpcMeshClass, properties_changed));
 
-	dbus_g_object_type_install_info (G_TYPE_FROM_CLASS (klass), &dbus_glib_nm_device_olpc_mesh_object_info);
+	nm_properties_changed_signal_install_info (G_OBJECT_CLASS (klass), &dbus_glib_nm_device_olpc_mesh_object_info);
 
 	dbus_g_error_domain_register (NM_OLPC_MESH_ERROR, NULL, 
 		NM_TYPE_OLPC_MESH_ERROR);
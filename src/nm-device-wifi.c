@@ -49,6 +49,7 @@
 #include "nm-supplicant-interface.h"
 #include "nm-supplicant-config.h"
 #include "nm-properties-changed-signal.h"
+#include "nm-dbus-glib-types.h"
 #include "nm-setting-connection.h"
 #include "nm-setting-wireless.h"
 #include "nm-setting-wireless-security.h"
@@ -60,6 +61,7 @@
 #include "nm-settings-connection.h"
 #include "nm-enum-types.h"
 #include "wifi-utils.h"
+#include "nm-wifi-scan-list.h"
 
 static gboolean impl_device_get_access_points (NMDeviceWifi *device,
                                                GPtrArray **aps,
@@ -77,8 +79,32 @@ static void impl_device_request_scan (NMDeviceWifi *device,
 #define SCAN_INTERVAL_STEP 20
 #define SCAN_INTERVAL_MAX 120
 
+/* Seconds between polls of the link's signal strength and bitrate; when the
+ * driver reports link changes itself the poll only catches bitrate drift.
+ */
+#define PERIODIC_UPDATE_INTERVAL 6
+#define PERIODIC_UPDATE_INTERVAL_MONITORED 30
+
+/* While activated, background scans are planned from the link quality and
+ * how much the scan list changed since the last scan; see plan_scan().
+ */
+#define SCAN_WEAK_STRENGTH 40      /* percent; below this, look for roam candidates */
+#define SCAN_CHURN_HIGH 5          /* APs added or removed since the last scan */
+#define SCAN_FULL_MAX_AGE 300      /* seconds between full scans, at most */
+
+/* How long an AP the supplicant no longer knows stays in the scan list:
+ * three scan intervals while scanning regularly, bounded by these.
+ */
+#define PRUNE_INTERVAL_MIN 60
+#define PRUNE_INTERVAL_MAX (SCAN_INTERVAL_MAX * 3)
+
+/* How long new BSSes are held back when no ScanDone arrives */
+#define SCAN_BATCH_DELAY_MS 1000
+
 #define WIRELESS_SECRETS_TRIES "wireless-secrets-tries"
 
+#define WPAS_REMOVED_TAG "supplicant-removed"
+
 G_DEFINE_TYPE (NMDeviceWifi, nm_device_wifi, NM_TYPE_DEVICE)
 
 #define NM_DEVICE_WIFI_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), NM_TYPE_DEVICE_WIFI, NMDeviceWifiPrivate))
@@ -138,15 +164,21 @@ struct _NMDeviceWifiPrivate {
 
 	gint8             invalid_strength_counter;
 
-	GSList *          ap_list;
+	NMAPTable *       aps;
 	NMAccessPoint *   current_ap;
 	guint32           rate;
 	gboolean          enabled; /* rfkilled or not */
 	
 	time_t            scheduled_scan_time;
 	guint8            scan_interval; /* seconds */
+	time_t            last_full_scan;
+	GHashTable *      hidden_probes; /* SSID -> HiddenProbe */
+	guint             hidden_scans;  /* Scans that probed hidden SSIDs */
+	guint             scan_churn;    /* APs added or removed since the last scan */
 	guint             pending_scan_id;
 	guint             scanlist_cull_id;
+	GSList *          scan_batch;    /* New BSSes not merged yet, newest first */
+	guint             scan_batch_id;
 
 	Supplicant        supplicant;
 	WifiData *        wifi_data;
@@ -155,6 +187,7 @@ struct _NMDeviceWifiPrivate {
 
 	guint32           failed_link_count;
 	guint             periodic_source_id;
+	gboolean          link_monitored;
 	guint             link_timeout_id;
 
 	NMDeviceWifiCapabilities capabilities;
@@ -201,6 +234,10 @@ static void supplicant_iface_notify_scanning_cb (NMSupplicantInterface * iface,
 
 static void schedule_scanlist_cull (NMDeviceWifi *self);
 
+static void scan_batch_flush (NMDeviceWifi *self);
+
+static void scan_batch_clear (NMDeviceWifi *self);
+
 static gboolean request_wireless_scan (gpointer user_data);
 
 static void update_hw_address (NMDevice *dev);
@@ -470,27 +507,90 @@ supplicant_interface_release (NMDeviceWifi *self)
 static NMAccessPoint *
 get_ap_by_path (NMDeviceWifi *self, const char *path)
 {
-	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
-	GSList *iter;
-
-	for (iter = priv->ap_list; iter; iter = g_slist_next (iter)) {
-		if (g_strcmp0 (path, nm_ap_get_dbus_path (NM_AP (iter->data))) == 0)
-			return NM_AP (iter->data);
-	}
-	return NULL;
+	return nm_ap_table_lookup_dbus_path (NM_DEVICE_WIFI_GET_PRIVATE (self)->aps, path);
 }
 
 static NMAccessPoint *
 get_ap_by_supplicant_path (NMDeviceWifi *self, const char *path)
 {
-	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
-	GSList *iter;
+	return nm_ap_table_lookup_supplicant_path (NM_DEVICE_WIFI_GET_PRIVATE (self)->aps, path);
+}
 
-	for (iter = priv->ap_list; iter && path; iter = g_slist_next (iter)) {
-		if (g_strcmp0 (path, nm_ap_get_supplicant_path (NM_AP (iter->data))) == 0)
-			return NM_AP (iter->data);
-	}
-	return NULL;
+static void
+ap_get_keys (gpointer item, NMWifiScanListKeys *keys)
+{
+	NMAccessPoint *ap = NM_AP (item);
+
+	keys->dbus_path = nm_ap_get_dbus_path (ap);
+	keys->supplicant_path = nm_ap_get_supplicant_path (ap);
+	keys->bssid = nm_ap_get_address (ap);
+	keys->bssid_valid = nm_ethernet_address_is_valid (keys->bssid);
+	keys->last_seen = nm_ap_get_last_seen (ap);
+	keys->in_supplicant =    keys->supplicant_path
+	                      && !g_object_get_data (G_OBJECT (ap), WPAS_REMOVED_TAG);
+}
+
+static gpointer
+ap_find (NMAPTable *table, gpointer scanned, gboolean strict_match)
+{
+	return nm_ap_match_in_table (NM_AP (scanned), table, strict_match);
+}
+
+typedef struct {
+	NMDeviceWifi *self;
+	GHashTable *changed_ssids;
+	gboolean debug;
+} ScanListContext;
+
+static void     scan_list_update_ap (gpointer item, gpointer scanned, gpointer user_data);
+static gboolean scan_list_keep_ap   (gpointer item, gpointer user_data);
+static void     scan_list_remove_ap (gpointer item, gpointer user_data);
+
+static const NMWifiScanListFuncs scan_list_funcs = {
+	ap_get_keys,
+	ap_find,
+	scan_list_update_ap,
+	scan_list_keep_ap,
+	scan_list_remove_ap
+};
+
+/* The AP must already be exported, so it can be found by its D-Bus path */
+static void
+add_access_point (NMDeviceWifi *self, NMAccessPoint *ap)
+{
+	ScanListContext ctx = { self, NULL, FALSE };
+
+	nm_wifi_scan_list_add (NM_DEVICE_WIFI_GET_PRIVATE (self)->aps, ap, &scan_list_funcs, &ctx);
+}
+
+/* Call after changing the AP's keys, or whether it is kept in the list */
+static void
+sync_access_point (NMDeviceWifi *self, NMAccessPoint *ap)
+{
+	ScanListContext ctx = { self, NULL, FALSE };
+
+	nm_wifi_scan_list_sync (NM_DEVICE_WIFI_GET_PRIVATE (self)->aps, ap, &scan_list_funcs, &ctx);
+}
+
+static void
+set_ap_last_seen (NMDeviceWifi *self, NMAccessPoint *ap, glong last_seen)
+{
+	nm_ap_set_last_seen (ap, last_seen);
+	sync_access_point (self, ap);
+}
+
+static void
+set_ap_address (NMDeviceWifi *self, NMAccessPoint *ap, const struct ether_addr *bssid)
+{
+	nm_ap_set_address (ap, bssid);
+	sync_access_point (self, ap);
+}
+
+static void
+set_ap_removed (NMDeviceWifi *self, NMAccessPoint *ap)
+{
+	g_object_set_data (G_OBJECT (ap), WPAS_REMOVED_TAG, GUINT_TO_POINTER (TRUE));
+	sync_access_point (self, ap);
 }
 
 static NMAccessPoint *
@@ -502,7 +602,7 @@ get_active_ap (NMDeviceWifi *self,
 	const char *iface = nm_device_get_iface (NM_DEVICE (self));
 	struct ether_addr bssid;
 	GByteArray *ssid;
-	GSList *iter;
+	GList *iter;
 	int i = 0;
 	NMAccessPoint *match_nofreq = NULL, *active_ap = NULL;
 	gboolean found_a_band = FALSE;
@@ -538,7 +638,7 @@ get_active_ap (NMDeviceWifi *self,
 		nm_log_dbg (LOGD_WIFI, "  Pass #%d %s", i, i > 1 ? "(ignoring SSID)" : "");
 
 		/* Find this SSID + BSSID in the device's AP list */
-		for (iter = priv->ap_list; iter; iter = g_slist_next (iter)) {
+		for (iter = nm_ap_table_get_list (priv->aps); iter; iter = g_list_next (iter)) {
 			NMAccessPoint *ap = NM_AP (iter->data);
 			const struct ether_addr	*ap_bssid = nm_ap_get_address (ap);
 			const GByteArray *ap_ssid = nm_ap_get_ssid (ap);
@@ -681,16 +781,22 @@ set_active_ap (NMDeviceWifi *self, NMAccessPoint *new_ap)
 		 * do a lot of searches looking for the current AP, it saves
 		 * time to have it in front.
 		 */
-		priv->ap_list = g_slist_remove (priv->ap_list, new_ap);
-		priv->ap_list = g_slist_prepend (priv->ap_list, new_ap);
+		nm_ap_table_move_to_front (priv->aps, new_ap);
 
 		/* Update seen BSSIDs cache */
 		update_seen_bssids_cache (self, priv->current_ap);
+
+		/* The current AP is never culled; stop aging it */
+		sync_access_point (self, new_ap);
 	}
 
 	/* Unref old AP here to ensure object lives if new_ap == old_ap */
-	if (old_ap)
+	if (old_ap) {
+		/* Let it age again if it's still in the list */
+		if (old_ap != new_ap)
+			sync_access_point (self, old_ap);
 		g_object_unref (old_ap);
+	}
 
 	/* Only notify if it's really changed */
 	if (   (!old_path && new_ap)
@@ -708,7 +814,8 @@ periodic_update (gpointer user_data)
 	NMDeviceWifi *self = NM_DEVICE_WIFI (user_data);
 	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
 	NMAccessPoint *new_ap;
-	guint32 new_rate, percent;
+	guint32 new_rate;
+	int percent;
 	NMDeviceState state;
 	guint32 supplicant_state;
 
@@ -750,15 +857,17 @@ periodic_update (gpointer user_data)
 		 */
 		if (   (bssid.ether_addr_octet[0] & 0x02)
 		    && nm_ethernet_address_is_valid (&bssid))
-			nm_ap_set_address (priv->current_ap, &bssid);
+			set_ap_address (self, priv->current_ap, &bssid);
 	}
 
+	/* Signal and bitrate in one go */
+	wifi_utils_get_link (priv->wifi_data, &percent, &new_rate);
+
 	new_ap = get_active_ap (self, NULL, FALSE);
 	if (new_ap) {
 		/* Try to smooth out the strength.  Atmel cards, for example, will give no strength
 		 * one second and normal strength the next.
 		 */
-		percent = wifi_utils_get_qual (priv->wifi_data);
 		if (percent >= 0 || ++priv->invalid_strength_counter > 3) {
 			nm_ap_set_strength (new_ap, (gint8) percent);
 			priv->invalid_strength_counter = 0;
@@ -796,7 +905,6 @@ periodic_update (gpointer user_data)
 		set_active_ap (self, new_ap);
 	}
 
-	new_rate = wifi_utils_get_rate (priv->wifi_data);
 	if (new_rate != priv->rate) {
 		priv->rate = new_rate;
 		g_object_notify (G_OBJECT (self), NM_DEVICE_WIFI_BITRATE);
@@ -823,16 +931,40 @@ is_up (NMDevice *device)
 	return TRUE;
 }
 
+static void
+link_changed_cb (gpointer user_data)
+{
+	periodic_update (user_data);
+}
+
 static gboolean
 bring_up (NMDevice *dev)
 {
 	NMDeviceWifi *self = NM_DEVICE_WIFI (dev);
 	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
 
-	priv->periodic_source_id = g_timeout_add_seconds (6, periodic_update, self);
+	if (!priv->link_monitored && priv->wifi_data)
+		priv->link_monitored = wifi_utils_monitor_link (priv->wifi_data, link_changed_cb, self);
+
+	priv->periodic_source_id = g_timeout_add_seconds (priv->link_monitored ?
+	                                                      PERIODIC_UPDATE_INTERVAL_MONITORED :
+	                                                      PERIODIC_UPDATE_INTERVAL,
+	                                                  periodic_update,
+	                                                  self);
 	return TRUE;
 }
 
+static void
+unmonitor_link (NMDeviceWifi *self)
+{
+	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
+
+	if (priv->link_monitored) {
+		wifi_utils_unmonitor_link (priv->wifi_data);
+		priv->link_monitored = FALSE;
+	}
+}
+
 static gboolean
 _set_hw_addr (NMDeviceWifi *self, const guint8 *addr, const char *detail)
 {
@@ -875,30 +1007,110 @@ _set_hw_addr (NMDeviceWifi *self, const guint8 *addr, const char *detail)
 	return success;
 }
 
+/* Sets of SSIDs whose visibility changed, so that only the connections for
+ * them need their availability rechecked.
+ */
+static guint
+ssid_hash (gconstpointer key)
+{
+	const GByteArray *ssid = key;
+	guint len = ssid->len, h = 0, i;
+
+	if (len && ssid->data[len - 1] == '\0')
+		len--;
+	for (i = 0; i < len; i++)
+		h = (h << 5) - h + ssid->data[i];
+	return h;
+}
+
+static gboolean
+ssid_equal (gconstpointer a, gconstpointer b)
+{
+	return nm_utils_same_ssid (a, b, TRUE);
+}
+
+static GHashTable *
+ssid_set_new (void)
+{
+	return g_hash_table_new_full (ssid_hash, ssid_equal, (GDestroyNotify) g_byte_array_unref, NULL);
+}
+
+static void
+ssid_set_add (GHashTable *ssids, const GByteArray *ssid)
+{
+	GByteArray *copy;
+
+	if (!ssid || nm_utils_is_empty_ssid (ssid->data, ssid->len))
+		return;
+	if (g_hash_table_lookup_extended (ssids, ssid, NULL, NULL))
+		return;
+
+	copy = g_byte_array_sized_new (ssid->len);
+	g_byte_array_append (copy, ssid->data, ssid->len);
+	g_hash_table_insert (ssids, copy, NULL);
+}
+
+static gboolean
+connection_ssid_in_set (NMDevice *device, NMConnection *connection, gpointer user_data)
+{
+	NMSettingWireless *s_wifi;
+	const GByteArray *ssid;
+
+	s_wifi = nm_connection_get_setting_wireless (connection);
+	if (!s_wifi)
+		return FALSE;
+	ssid = nm_setting_wireless_get_ssid (s_wifi);
+	return ssid && g_hash_table_lookup_extended (user_data, ssid, NULL, NULL);
+}
+
+static void
+recheck_available_connections_for_ssids (NMDeviceWifi *self, GHashTable *ssids)
+{
+	if (g_hash_table_size (ssids)) {
+		nm_device_recheck_available_connections_filtered (NM_DEVICE (self),
+		                                                  connection_ssid_in_set,
+		                                                  ssids);
+	}
+}
+
+/* If @changed_ssids is given the AP's SSID is added to it and the caller
+ * rechecks the available connections; otherwise that happens here.
+ */
 static void
-remove_access_point (NMDeviceWifi *device, NMAccessPoint *ap)
+remove_access_point (NMDeviceWifi *device, NMAccessPoint *ap, GHashTable *changed_ssids)
 {
 	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (device);
+	GHashTable *ssids = changed_ssids ? changed_ssids : ssid_set_new ();
+
+	ssid_set_add (ssids, nm_ap_get_ssid (ap));
 
 	g_signal_emit (device, signals[ACCESS_POINT_REMOVED], 0, ap);
-	priv->ap_list = g_slist_remove (priv->ap_list, ap);
+	nm_ap_table_remove (priv->aps, ap);
+	priv->scan_churn++;
 	g_object_unref (ap);
 
-	nm_device_recheck_available_connections (NM_DEVICE (device));
+	if (!changed_ssids) {
+		recheck_available_connections_for_ssids (device, ssids);
+		g_hash_table_destroy (ssids);
+	}
 }
 
 static void
 remove_all_aps (NMDeviceWifi *self)
 {
 	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
+	GHashTable *ssids;
+
+	scan_batch_clear (self);
 
 	/* Remove outdated APs */
-	while (g_slist_length (priv->ap_list)) {
-		NMAccessPoint *ap = NM_AP (priv->ap_list->data);
-		remove_access_point (self, ap);
+	ssids = ssid_set_new ();
+	while (nm_ap_table_size (priv->aps)) {
+		NMAccessPoint *ap = NM_AP (nm_ap_table_get_list (priv->aps)->data);
+		remove_access_point (self, ap, ssids);
 	}
-	g_slist_free (priv->ap_list);
-	priv->ap_list = NULL;
+	recheck_available_connections_for_ssids (self, ssids);
+	g_hash_table_destroy (ssids);
 }
 
 static void
@@ -911,6 +1123,7 @@ take_down (NMDevice *dev)
 		g_source_remove (priv->periodic_source_id);
 		priv->periodic_source_id = 0;
 	}
+	unmonitor_link (self);
 
 	cleanup_association_attempt (self, TRUE);
 	set_active_ap (self, NULL);
@@ -948,7 +1161,7 @@ deactivate (NMDevice *dev)
 	 * and thus the AP culling never happens. (bgo #569241)
 	 */
 	if (orig_ap && nm_ap_get_fake (orig_ap)) {
-	    remove_access_point (self, orig_ap);
+	    remove_access_point (self, orig_ap, NULL);
 	}
 
 	/* Reset MAC address back to initial address */
@@ -1111,7 +1324,7 @@ check_connection_available (NMDevice *device, NMConnection *connection)
 	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (device);
 	NMSettingWireless *s_wifi;
 	const char *mode;
-	GSList *ap_iter = NULL;
+	GList *ap_iter = NULL;
 
 	s_wifi = nm_connection_get_setting_wireless (connection);
 
@@ -1127,7 +1340,7 @@ check_connection_available (NMDevice *device, NMConnection *connection)
 		return TRUE;
 
 	/* check if its visible */
-	for (ap_iter = priv->ap_list; ap_iter; ap_iter = g_slist_next (ap_iter)) {
+	for (ap_iter = nm_ap_table_get_list (priv->aps); ap_iter; ap_iter = g_list_next (ap_iter)) {
 		if (nm_ap_check_compatible (NM_AP (ap_iter->data), connection))
 			return TRUE;
 	}
@@ -1187,7 +1400,7 @@ complete_connection (NMDevice *device,
 	char *format, *str_ssid = NULL;
 	NMAccessPoint *ap = NULL;
 	const GByteArray *ssid = NULL;
-	GSList *iter;
+	GList *iter;
 
 	s_wifi = nm_connection_get_setting_wireless (connection);
 	s_wsec = nm_connection_get_setting_wireless_security (connection);
@@ -1213,7 +1426,7 @@ complete_connection (NMDevice *device,
 		}
 
 		/* Find a compatible AP in the scan list */
-		for (iter = priv->ap_list; iter; iter = g_slist_next (iter)) {
+		for (iter = nm_ap_table_get_list (priv->aps); iter; iter = g_list_next (iter)) {
 			if (nm_ap_check_compatible (NM_AP (iter->data), connection)) {
 				ap = NM_AP (iter->data);
 				break;
@@ -1382,7 +1595,8 @@ get_best_auto_connection (NMDevice *dev,
 {
 	NMDeviceWifi *self = NM_DEVICE_WIFI (dev);
 	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
-	GSList *iter, *ap_iter;
+	GSList *iter;
+	GList *ap_iter;
 
 	for (iter = connections; iter; iter = g_slist_next (iter)) {
 		NMConnection *connection = NM_CONNECTION (iter->data);
@@ -1441,7 +1655,7 @@ get_best_auto_connection (NMDevice *dev,
 		if (s_ip4 && !strcmp (method, NM_SETTING_IP4_CONFIG_METHOD_SHARED))
 			return connection;
 
-		for (ap_iter = priv->ap_list; ap_iter; ap_iter = g_slist_next (ap_iter)) {
+		for (ap_iter = nm_ap_table_get_list (priv->aps); ap_iter; ap_iter = g_list_next (ap_iter)) {
 			NMAccessPoint *ap = NM_AP (ap_iter->data);
 
 			if (nm_ap_check_compatible (ap, connection)) {
@@ -1458,13 +1672,13 @@ static void
 ap_list_dump (NMDeviceWifi *self)
 {
 	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
-	GSList * elt;
+	GList * elt;
 	int i = 0;
 
 	g_return_if_fail (NM_IS_DEVICE_WIFI (self));
 
 	nm_log_dbg (LOGD_WIFI_SCAN, "Current AP list:");
-	for (elt = priv->ap_list; elt; elt = g_slist_next (elt), i++) {
+	for (elt = nm_ap_table_get_list (priv->aps); elt; elt = g_list_next (elt), i++) {
 		NMAccessPoint * ap = NM_AP (elt->data);
 		nm_ap_dump (ap, "List AP: ");
 	}
@@ -1477,11 +1691,11 @@ impl_device_get_access_points (NMDeviceWifi *self,
                                GError **err)
 {
 	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
-	GSList *elt;
+	GList *elt;
 
 	*aps = g_ptr_array_new ();
 
-	for (elt = priv->ap_list; elt; elt = g_slist_next (elt)) {
+	for (elt = nm_ap_table_get_list (priv->aps); elt; elt = g_list_next (elt)) {
 		NMAccessPoint * ap = NM_AP (elt->data);
 
 		if (nm_ap_get_ssid (ap))
@@ -1490,6 +1704,20 @@ impl_device_get_access_points (NMDeviceWifi *self,
 	return TRUE;
 }
 
+static void
+add_snapshot_properties (NMDevice *device, GHashTable *props)
+{
+	GValue *value;
+	GPtrArray *aps = NULL;
+
+	impl_device_get_access_points (NM_DEVICE_WIFI (device), &aps, NULL);
+
+	value = g_slice_new0 (GValue);
+	g_value_init (value, DBUS_TYPE_G_ARRAY_OF_OBJECT_PATH);
+	g_value_take_boxed (value, aps);
+	g_hash_table_insert (props, g_strdup ("AccessPoints"), value);
+}
+
 static void
 request_scan_cb (NMDevice *device,
                  DBusGMethodInvocation *context,
@@ -1508,6 +1736,8 @@ request_scan_cb (NMDevice *device,
 		dbus_g_method_return_error (context, error);
 		g_error_free (error);
 	} else {
+		/* Scans asked for by clients always cover all channels */
+		NM_DEVICE_WIFI_GET_PRIVATE (self)->last_full_scan = 0;
 		cancel_pending_scan (self);
 		request_wireless_scan (self);
 		dbus_g_method_return (context);
@@ -1680,6 +1910,68 @@ hidden_filter_func (NMConnectionProvider *provider,
 	return s_wifi ? nm_setting_wireless_get_hidden (s_wifi) : FALSE;
 }
 
+/* Probe statistics of a hidden SSID, kept across scans */
+typedef struct {
+	GByteArray *ssid;
+	double credit;       /* Grows each scan the SSID isn't probed */
+	guint probes;        /* Scans that probed the SSID */
+	guint found;         /* BSSes with the SSID merged into the scan list */
+	guint last_probe;    /* Value of hidden_scans when last probed */
+	guint generation;    /* Last time the SSID belonged to a hidden connection */
+} HiddenProbe;
+
+static void
+hidden_probe_free (gpointer data)
+{
+	HiddenProbe *probe = data;
+
+	g_byte_array_unref (probe->ssid);
+	g_slice_free (HiddenProbe, probe);
+}
+
+static gint
+hidden_probe_compare (gconstpointer a, gconstpointer b)
+{
+	const HiddenProbe *pa = *(HiddenProbe **) a;
+	const HiddenProbe *pb = *(HiddenProbe **) b;
+
+	if (pa->credit != pb->credit)
+		return pa->credit > pb->credit ? -1 : 1;
+	/* Least recently probed first */
+	return pa->last_probe < pb->last_probe ? -1 : (pa->last_probe > pb->last_probe);
+}
+
+static void
+hidden_probes_dump (NMDeviceWifi *self)
+{
+	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
+	GHashTableIter iter;
+	HiddenProbe *probe;
+
+	if (   !nm_logging_level_enabled (LOGL_DEBUG)
+	    || !nm_logging_domain_enabled (LOGD_WIFI_SCAN))
+		return;
+
+	g_hash_table_iter_init (&iter, priv->hidden_probes);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &probe)) {
+		nm_log_dbg (LOGD_WIFI_SCAN, "(%s): hidden SSID '%s': probed %u times, last %u scans ago, "
+		            "found %u BSSes, credit %.2f",
+		            nm_device_get_iface (NM_DEVICE (self)),
+		            nm_utils_escape_ssid (probe->ssid->data, probe->ssid->len),
+		            probe->probes,
+		            probe->probes ? priv->hidden_scans - probe->last_probe : 0,
+		            probe->found,
+		            probe->credit);
+	}
+}
+
+/* Picks the hidden SSIDs to probe for in the next scan.  The supplicant can
+ * only probe for max_scan_ssids - 1 of them at a time, so when there are
+ * more, they take turns: every scan each hidden SSID earns credit and the
+ * ones with the most credit are probed, which spends it.  Recently used
+ * connections and SSIDs with BSSes seen before earn credit faster, so they
+ * are probed more often, but all of them are probed eventually.
+ */
 static GPtrArray *
 build_hidden_probe_list (NMDeviceWifi *self)
 {
@@ -1687,7 +1979,10 @@ build_hidden_probe_list (NMDeviceWifi *self)
 	guint max_scan_ssids = nm_supplicant_interface_get_max_scan_ssids (priv->supplicant.iface);
 	NMConnectionProvider *provider = nm_device_get_connection_provider (NM_DEVICE (self));
 	GSList *connections, *iter;
-	GPtrArray *ssids = NULL;
+	GPtrArray *ssids = NULL, *candidates;
+	GHashTableIter hiter;
+	HiddenProbe *probe;
+	guint i, n, rank = 0, generation;
 	static GByteArray *nullssid = NULL;
 
 	/* Need at least two: wildcard SSID and one or more hidden SSIDs */
@@ -1698,33 +1993,174 @@ build_hidden_probe_list (NMDeviceWifi *self)
 	if (G_UNLIKELY (nullssid == NULL))
 		nullssid = g_byte_array_new ();
 
+	/* All hidden connections, most recently used first */
 	connections = nm_connection_provider_get_best_connections (provider,
-	                                                           max_scan_ssids - 1,
+	                                                           0,
 	                                                           NM_SETTING_WIRELESS_SETTING_NAME,
 	                                                           NULL,
 	                                                           hidden_filter_func,
 	                                                           NULL);
-	if (connections && connections->data) {
-		ssids = g_ptr_array_sized_new (max_scan_ssids - 1);
-		g_ptr_array_add (ssids, nullssid);  /* Add wildcard SSID */
-	}
+	if (!connections)
+		return NULL;
 
-	for (iter = connections; iter; iter = g_slist_next (iter)) {
+	n = g_slist_length (connections);
+	generation = ++priv->hidden_scans;
+	candidates = g_ptr_array_sized_new (n);
+
+	for (iter = connections; iter; iter = g_slist_next (iter), rank++) {
 		NMConnection *connection = iter->data;
 		NMSettingWireless *s_wifi;
 		const GByteArray *ssid;
+		double weight;
+		GSList *seen;
 
 		s_wifi = (NMSettingWireless *) nm_connection_get_setting_wireless (connection);
 		g_assert (s_wifi);
 		ssid = nm_setting_wireless_get_ssid (s_wifi);
 		g_assert (ssid);
-		g_ptr_array_add (ssids, (gpointer) ssid);
+
+		probe = g_hash_table_lookup (priv->hidden_probes, ssid);
+		if (!probe) {
+			probe = g_slice_new0 (HiddenProbe);
+			probe->ssid = g_byte_array_sized_new (ssid->len);
+			g_byte_array_append (probe->ssid, ssid->data, ssid->len);
+			g_hash_table_insert (priv->hidden_probes, probe->ssid, probe);
+		}
+
+		/* Several connections may share an SSID; count it once */
+		if (probe->generation == generation)
+			continue;
+		probe->generation = generation;
+
+		/* Between 1 and 3 by recency, plus 1 if it was ever seen */
+		weight = 1.0 + 2.0 * (n - rank) / n;
+		seen = nm_settings_connection_get_seen_bssids (NM_SETTINGS_CONNECTION (connection));
+		if (seen || probe->found)
+			weight += 1.0;
+		g_slist_foreach (seen, (GFunc) g_free, NULL);
+		g_slist_free (seen);
+
+		probe->credit += weight;
+		g_ptr_array_add (candidates, probe);
 	}
 	g_slist_free (connections);
 
+	/* Forget SSIDs that no longer belong to any hidden connection */
+	g_hash_table_iter_init (&hiter, priv->hidden_probes);
+	while (g_hash_table_iter_next (&hiter, NULL, (gpointer) &probe)) {
+		if (probe->generation != generation)
+			g_hash_table_iter_remove (&hiter);
+	}
+
+	g_ptr_array_sort (candidates, hidden_probe_compare);
+
+	ssids = g_ptr_array_sized_new (max_scan_ssids);
+	g_ptr_array_add (ssids, nullssid);  /* Add wildcard SSID */
+	for (i = 0; i < candidates->len && i < max_scan_ssids - 1; i++) {
+		probe = g_ptr_array_index (candidates, i);
+		probe->credit = 0;
+		probe->probes++;
+		probe->last_probe = priv->hidden_scans;
+		g_ptr_array_add (ssids, probe->ssid);
+	}
+	g_ptr_array_free (candidates, TRUE);
+
+	hidden_probes_dump (self);
+
 	return ssids;
 }
 
+typedef enum {
+	SCAN_PLAN_WAIT = 0,  /* Skip this scan */
+	SCAN_PLAN_CHANNELS,  /* Scan only the channels of the current ESS */
+	SCAN_PLAN_FULL,      /* Scan all channels */
+} ScanPlan;
+
+static const char *
+scan_plan_to_string (ScanPlan plan)
+{
+	switch (plan) {
+	case SCAN_PLAN_WAIT:
+		return "wait";
+	case SCAN_PLAN_CHANNELS:
+		return "channels";
+	default:
+		return "full";
+	}
+}
+
+/* Frequencies of the APs in the scan list that belong to the same ESS as
+ * the current AP, which is where roaming candidates are.
+ */
+static GArray *
+get_ess_freqs (NMDeviceWifi *self)
+{
+	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
+	const GByteArray *ssid;
+	GArray *freqs;
+	GList *iter;
+	guint i;
+
+	ssid = nm_ap_get_ssid (priv->current_ap);
+	if (!ssid)
+		return NULL;
+
+	freqs = g_array_new (FALSE, FALSE, sizeof (guint32));
+	for (iter = nm_ap_table_get_list (priv->aps); iter; iter = g_list_next (iter)) {
+		NMAccessPoint *ap = iter->data;
+		guint32 freq = nm_ap_get_freq (ap);
+
+		if (!freq || !nm_utils_same_ssid (ssid, nm_ap_get_ssid (ap), TRUE))
+			continue;
+
+		for (i = 0; i < freqs->len; i++) {
+			if (g_array_index (freqs, guint32, i) == freq)
+				break;
+		}
+		if (i == freqs->len)
+			g_array_append_val (freqs, freq);
+	}
+
+	if (!freqs->len) {
+		g_array_free (freqs, TRUE);
+		return NULL;
+	}
+	return freqs;
+}
+
+/* Decides what kind of scan to do next.  Scanning takes the radio off the
+ * current channel, so on an activated link the full-band scan is only done
+ * when the list is stale or changing a lot while the signal is weak.  With
+ * a good signal and a quiet neighbourhood, the scan is skipped altogether.
+ */
+static ScanPlan
+plan_scan (NMDeviceWifi *self, GArray **out_freqs)
+{
+	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
+	gboolean weak, churning;
+	time_t now = time (NULL);
+
+	*out_freqs = NULL;
+
+	if (   nm_device_get_state (NM_DEVICE (self)) != NM_DEVICE_STATE_ACTIVATED
+	    || !priv->current_ap
+	    || nm_ap_get_fake (priv->current_ap)
+	    || priv->mode != NM_802_11_MODE_INFRA
+	    || now - priv->last_full_scan >= SCAN_FULL_MAX_AGE)
+		return SCAN_PLAN_FULL;
+
+	weak = nm_ap_get_strength (priv->current_ap) < SCAN_WEAK_STRENGTH;
+	churning = priv->scan_churn >= SCAN_CHURN_HIGH;
+
+	if (weak && churning)
+		return SCAN_PLAN_FULL;
+	if (!weak && !churning)
+		return SCAN_PLAN_WAIT;
+
+	*out_freqs = get_ess_freqs (self);
+	return *out_freqs ? SCAN_PLAN_CHANNELS : SCAN_PLAN_FULL;
+}
+
 static gboolean
 request_wireless_scan (gpointer user_data)
 {
@@ -1732,10 +2168,22 @@ request_wireless_scan (gpointer user_data)
 	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
 	gboolean backoff = FALSE;
 	GPtrArray *ssids = NULL;
+	GArray *freqs = NULL;
+	ScanPlan plan;
 
 	if (check_scanning_allowed (self)) {
-		nm_log_dbg (LOGD_WIFI_SCAN, "(%s): scanning requested",
-		            nm_device_get_iface (NM_DEVICE (self)));
+		plan = plan_scan (self, &freqs);
+		nm_log_dbg (LOGD_WIFI_SCAN, "(%s): scanning requested (%s, %u APs changed)",
+		            nm_device_get_iface (NM_DEVICE (self)),
+		            scan_plan_to_string (plan),
+		            priv->scan_churn);
+
+		if (plan == SCAN_PLAN_WAIT) {
+			/* Nothing is wrong with the link; look again later */
+			priv->pending_scan_id = 0;
+			schedule_scan (self, TRUE);
+			return FALSE;
+		}
 
 		ssids = build_hidden_probe_list (self);
 
@@ -1757,13 +2205,19 @@ request_wireless_scan (gpointer user_data)
 			}
 		}
 
-		if (nm_supplicant_interface_request_scan (priv->supplicant.iface, ssids)) {
+		if (nm_supplicant_interface_request_scan (priv->supplicant.iface, ssids, freqs)) {
 			/* success */
 			backoff = TRUE;
+			priv->scan_churn = 0;
+			if (plan == SCAN_PLAN_FULL)
+				priv->last_full_scan = time (NULL);
 		}
 
+		if (freqs)
+			g_array_free (freqs, TRUE);
+
 		if (ssids) {
-			/* Elements owned by the connections, so we don't free them here */
+			/* Elements owned by the probe statistics, so we don't free them here */
 			g_ptr_array_free (ssids, TRUE);
 		}
 	} else {
@@ -1849,6 +2303,9 @@ supplicant_iface_scan_done_cb (NMSupplicantInterface *iface,
 	            nm_device_get_iface (NM_DEVICE (self)),
 	            success ? "successful" : "failed");
 
+	/* Results of this scan are in; merge them all at once */
+	scan_batch_flush (self);
+
 	schedule_scan (self, success);
 
 	/* Ensure that old APs get removed, which otherwise only
@@ -1866,12 +2323,57 @@ supplicant_iface_scan_done_cb (NMSupplicantInterface *iface,
 #define MAC_FMT "%02x:%02x:%02x:%02x:%02x:%02x"
 #define MAC_ARG(x) ((guint8*)(x))[0],((guint8*)(x))[1],((guint8*)(x))[2],((guint8*)(x))[3],((guint8*)(x))[4],((guint8*)(x))[5]
 
+/* Replaces the known @item with the scan result it was matched to */
+static void
+scan_list_update_ap (gpointer item, gpointer scanned, gpointer user_data)
+{
+	ScanListContext *ctx = user_data;
+	NMAccessPoint *found_ap = NM_AP (item);
+	NMAccessPoint *merge_ap = NM_AP (scanned);
+	const GByteArray *ssid = nm_ap_get_ssid (merge_ap);
+	const struct ether_addr *bssid = nm_ap_get_address (merge_ap);
+
+	nm_log_dbg (LOGD_WIFI_SCAN, "(%s): merging AP '%s' " MAC_FMT " (%p) with existing (%p)",
+	            nm_device_get_iface (NM_DEVICE (ctx->self)),
+	            ssid ? nm_utils_escape_ssid (ssid->data, ssid->len) : "(none)",
+	            MAC_ARG (bssid->ether_addr_octet),
+	            merge_ap,
+	            found_ap);
+
+	/* Changed security or a fake AP turning real can change which
+	 * connections it is compatible with.
+	 */
+	if (   nm_ap_get_fake (found_ap)
+	    || nm_ap_get_flags (found_ap) != nm_ap_get_flags (merge_ap)
+	    || nm_ap_get_wpa_flags (found_ap) != nm_ap_get_wpa_flags (merge_ap)
+	    || nm_ap_get_rsn_flags (found_ap) != nm_ap_get_rsn_flags (merge_ap))
+		ssid_set_add (ctx->changed_ssids, nm_ap_get_ssid (found_ap));
+
+	nm_ap_set_supplicant_path (found_ap, nm_ap_get_supplicant_path (merge_ap));
+	nm_ap_set_flags (found_ap, nm_ap_get_flags (merge_ap));
+	nm_ap_set_wpa_flags (found_ap, nm_ap_get_wpa_flags (merge_ap));
+	nm_ap_set_rsn_flags (found_ap, nm_ap_get_rsn_flags (merge_ap));
+	nm_ap_set_strength (found_ap, nm_ap_get_strength (merge_ap));
+	nm_ap_set_last_seen (found_ap, nm_ap_get_last_seen (merge_ap));
+	nm_ap_set_broadcast (found_ap, nm_ap_get_broadcast (merge_ap));
+	nm_ap_set_freq (found_ap, nm_ap_get_freq (merge_ap));
+	nm_ap_set_max_bitrate (found_ap, nm_ap_get_max_bitrate (merge_ap));
+	if (g_object_get_data (G_OBJECT (merge_ap), WPAS_REMOVED_TAG))
+		g_object_set_data (G_OBJECT (found_ap), WPAS_REMOVED_TAG, GUINT_TO_POINTER (TRUE));
+
+	/* If the AP is noticed in a scan, it's automatically no longer
+	 * fake, since it clearly exists somewhere.
+	 */
+	nm_ap_set_fake (found_ap, FALSE);
+}
+
 /*
  * merge_scanned_ap
  *
  * If there is already an entry that matches the BSSID and ESSID of the
  * AP to merge, replace that entry with the scanned AP.  Otherwise, add
- * the scanned AP to the list.
+ * the scanned AP to the list.  SSIDs that may have become usable are
+ * added to @changed_ssids.
  *
  * TODO: possibly need to differentiate entries based on security too; i.e. if
  * there are two scan results with the same BSSID and SSID but different
@@ -1880,10 +2382,11 @@ supplicant_iface_scan_done_cb (NMSupplicantInterface *iface,
  */
 static void
 merge_scanned_ap (NMDeviceWifi *self,
-                  NMAccessPoint *merge_ap)
+                  NMAccessPoint *merge_ap,
+                  GHashTable *changed_ssids)
 {
 	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
-	NMAccessPoint *found_ap = NULL;
+	ScanListContext ctx;
 	const GByteArray *ssid;
 	const struct ether_addr *bssid;
 	gboolean strict_match = TRUE;
@@ -1922,97 +2425,135 @@ merge_scanned_ap (NMDeviceWifi *self,
 	if (current_ap && nm_ap_get_fake (current_ap))
 		strict_match = FALSE;
 
-	found_ap = get_ap_by_supplicant_path (self, nm_ap_get_supplicant_path (merge_ap));
-	if (!found_ap)
-		found_ap = nm_ap_match_in_list (merge_ap, priv->ap_list, strict_match);
-	if (found_ap) {
-		nm_log_dbg (LOGD_WIFI_SCAN, "(%s): merging AP '%s' " MAC_FMT " (%p) with existing (%p)",
-		            nm_device_get_iface (NM_DEVICE (self)),
-		            ssid ? nm_utils_escape_ssid (ssid->data, ssid->len) : "(none)",
-		            MAC_ARG (bssid->ether_addr_octet),
-		            merge_ap,
-		            found_ap);
-
-		nm_ap_set_supplicant_path (found_ap, nm_ap_get_supplicant_path (merge_ap));
-		nm_ap_set_flags (found_ap, nm_ap_get_flags (merge_ap));
-		nm_ap_set_wpa_flags (found_ap, nm_ap_get_wpa_flags (merge_ap));
-		nm_ap_set_rsn_flags (found_ap, nm_ap_get_rsn_flags (merge_ap));
-		nm_ap_set_strength (found_ap, nm_ap_get_strength (merge_ap));
-		nm_ap_set_last_seen (found_ap, nm_ap_get_last_seen (merge_ap));
-		nm_ap_set_broadcast (found_ap, nm_ap_get_broadcast (merge_ap));
-		nm_ap_set_freq (found_ap, nm_ap_get_freq (merge_ap));
-		nm_ap_set_max_bitrate (found_ap, nm_ap_get_max_bitrate (merge_ap));
-
-		/* If the AP is noticed in a scan, it's automatically no longer
-		 * fake, since it clearly exists somewhere.
-		 */
-		nm_ap_set_fake (found_ap, FALSE);
-	} else {
-		/* New entry in the list */
-		nm_log_dbg (LOGD_WIFI_SCAN, "(%s): adding new AP '%s' " MAC_FMT " (%p)",
-		            nm_device_get_iface (NM_DEVICE (self)),
-		            ssid ? nm_utils_escape_ssid (ssid->data, ssid->len) : "(none)",
-		            MAC_ARG (bssid->ether_addr_octet),
-		            merge_ap);
+	ctx.self = self;
+	ctx.changed_ssids = changed_ssids;
+	ctx.debug = FALSE;
+	if (nm_wifi_scan_list_merge (priv->aps, merge_ap, strict_match, &scan_list_funcs, &ctx))
+		return;
 
-		g_object_ref (merge_ap);
-		priv->ap_list = g_slist_prepend (priv->ap_list, merge_ap);
-		nm_ap_export_to_dbus (merge_ap);
-		g_signal_emit (self, signals[ACCESS_POINT_ADDED], 0, merge_ap);
-		nm_device_recheck_available_connections (NM_DEVICE (self));
+	/* New entry in the list */
+	nm_log_dbg (LOGD_WIFI_SCAN, "(%s): adding new AP '%s' " MAC_FMT " (%p)",
+	            nm_device_get_iface (NM_DEVICE (self)),
+	            ssid ? nm_utils_escape_ssid (ssid->data, ssid->len) : "(none)",
+	            MAC_ARG (bssid->ether_addr_octet),
+	            merge_ap);
+
+	g_object_ref (merge_ap);
+	nm_ap_export_to_dbus (merge_ap);
+	add_access_point (self, merge_ap);
+	priv->scan_churn++;
+
+	/* Credit the hidden SSID probe that found it */
+	if (ssid && g_hash_table_size (priv->hidden_probes)) {
+		HiddenProbe *probe = g_hash_table_lookup (priv->hidden_probes, ssid);
+
+		if (probe)
+			probe->found++;
 	}
+	g_signal_emit (self, signals[ACCESS_POINT_ADDED], 0, merge_ap);
+	ssid_set_add (changed_ssids, nm_ap_get_ssid (merge_ap));
 }
 
-#define WPAS_REMOVED_TAG "supplicant-removed"
-
-static gboolean
-cull_scan_list (NMDeviceWifi *self)
+static void
+scan_batch_clear (NMDeviceWifi *self)
 {
 	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
-	time_t now = time (NULL);
-	GSList *outdated_list = NULL;
-	GSList *elt;
-	guint32 removed = 0, total = 0;
 
-	priv->scanlist_cull_id = 0;
+	if (priv->scan_batch_id) {
+		g_source_remove (priv->scan_batch_id);
+		priv->scan_batch_id = 0;
+	}
 
-	nm_log_dbg (LOGD_WIFI_SCAN, "(%s): checking scan list for outdated APs",
-	            nm_device_get_iface (NM_DEVICE (self)));
+	g_slist_foreach (priv->scan_batch, (GFunc) g_object_unref, NULL);
+	g_slist_free (priv->scan_batch);
+	priv->scan_batch = NULL;
+}
 
-	/* Walk the access point list and remove any access points older than
-	 * three times the inactive scan interval.
-	 */
-	for (elt = priv->ap_list; elt; elt = g_slist_next (elt), total++) {
-		NMAccessPoint *ap = elt->data;
-		const guint prune_interval_s = SCAN_INTERVAL_MAX * 3;
+/* Merges the BSSes that arrived since the last flush into the scan list,
+ * and rechecks the available connections once for all of them.
+ */
+static void
+scan_batch_flush (NMDeviceWifi *self)
+{
+	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
+	GSList *batch, *iter;
+	GHashTable *changed_ssids;
 
-		/* Don't cull the associated AP or manually created APs */
-		if (ap == priv->current_ap || nm_ap_get_fake (ap))
-			continue;
+	if (priv->scan_batch_id) {
+		g_source_remove (priv->scan_batch_id);
+		priv->scan_batch_id = 0;
+	}
 
-		/* Don't cull APs still known to the supplicant.  Since the supplicant
-		 * doesn't yet emit property updates for "last seen" we have to rely
-		 * on changing signal strength for updating "last seen".  But if the
-		 * AP's strength doesn't change we won't get any updates for the AP,
-		 * and we'll end up here even if the AP was still found by the
-		 * supplicant in the last scan.
-		 */
-		if (   nm_ap_get_supplicant_path (ap)
-		    && g_object_get_data (G_OBJECT (ap), WPAS_REMOVED_TAG) == NULL)
-			continue;
+	if (!priv->scan_batch)
+		return;
+
+	/* Merge in the order the supplicant reported them */
+	batch = g_slist_reverse (priv->scan_batch);
+	priv->scan_batch = NULL;
+
+	nm_log_dbg (LOGD_WIFI_SCAN, "(%s): merging %d new BSSes",
+	            nm_device_get_iface (NM_DEVICE (self)),
+	            g_slist_length (batch));
 
-		if (nm_ap_get_last_seen (ap) + prune_interval_s < now)
-			outdated_list = g_slist_append (outdated_list, ap);
+	changed_ssids = ssid_set_new ();
+	for (iter = batch; iter; iter = g_slist_next (iter)) {
+		merge_scanned_ap (self, NM_AP (iter->data), changed_ssids);
+		g_object_unref (iter->data);
 	}
+	g_slist_free (batch);
 
-	/* Remove outdated APs */
-	for (elt = outdated_list; elt; elt = g_slist_next (elt)) {
-		NMAccessPoint *outdated_ap = NM_AP (elt->data);
-		const struct ether_addr *bssid;
-		const GByteArray *ssid;
+	recheck_available_connections_for_ssids (self, changed_ssids);
+	g_hash_table_destroy (changed_ssids);
+
+	/* Remove outdated access points */
+	schedule_scanlist_cull (self);
+}
+
+static gboolean
+scan_batch_timeout (gpointer user_data)
+{
+	NMDeviceWifi *self = NM_DEVICE_WIFI (user_data);
+
+	NM_DEVICE_WIFI_GET_PRIVATE (self)->scan_batch_id = 0;
+	scan_batch_flush (self);
+	return FALSE;
+}
+
+/* Scans are rare while activated, so APs are kept for the longest
+ * interval then; otherwise an AP is stale after missing about three scans.
+ */
+static guint
+get_prune_interval (NMDeviceWifi *self)
+{
+	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
+
+	if (   nm_device_is_activating (NM_DEVICE (self))
+	    || nm_device_get_state (NM_DEVICE (self)) == NM_DEVICE_STATE_ACTIVATED)
+		return PRUNE_INTERVAL_MAX;
+
+	return CLAMP (priv->scan_interval * 3, PRUNE_INTERVAL_MIN, PRUNE_INTERVAL_MAX);
+}
+
+/* Don't cull the associated AP or manually created APs */
+static gboolean
+scan_list_keep_ap (gpointer item, gpointer user_data)
+{
+	ScanListContext *ctx = user_data;
+
+	return    item == NM_DEVICE_WIFI_GET_PRIVATE (ctx->self)->current_ap
+	       || nm_ap_get_fake (NM_AP (item));
+}
+
+static void
+scan_list_remove_ap (gpointer item, gpointer user_data)
+{
+	ScanListContext *ctx = user_data;
+	NMAccessPoint *outdated_ap = NM_AP (item);
+
+	if (ctx->debug) {
+		const struct ether_addr *bssid = nm_ap_get_address (outdated_ap);
+		const GByteArray *ssid = nm_ap_get_ssid (outdated_ap);
 
-		bssid = nm_ap_get_address (outdated_ap);
-		ssid = nm_ap_get_ssid (outdated_ap);
 		nm_log_dbg (LOGD_WIFI_SCAN,
 		            "   removing %02x:%02x:%02x:%02x:%02x:%02x (%s%s%s)",
 		            bssid->ether_addr_octet[0], bssid->ether_addr_octet[1],
@@ -2021,20 +2562,45 @@ cull_scan_list (NMDeviceWifi *self)
 		            ssid ? "'" : "",
 		            ssid ? nm_utils_escape_ssid (ssid->data, ssid->len) : "(none)",
 		            ssid ? "'" : "");
-
-		remove_access_point (self, outdated_ap);
-		removed++;
 	}
-	g_slist_free (outdated_list);
+
+	remove_access_point (ctx->self, outdated_ap, ctx->changed_ssids);
+}
+
+static gboolean
+cull_scan_list (NMDeviceWifi *self)
+{
+	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
+	time_t now = time (NULL);
+	guint prune_interval_s = get_prune_interval (self);
+	ScanListContext ctx;
+	guint32 removed, total = nm_ap_table_size (priv->aps);
+
+	priv->scanlist_cull_id = 0;
+
+	ctx.self = self;
+	ctx.changed_ssids = ssid_set_new ();
+	ctx.debug =    nm_logging_level_enabled (LOGL_DEBUG)
+	            && nm_logging_domain_enabled (LOGD_WIFI_SCAN);
+
+	nm_log_dbg (LOGD_WIFI_SCAN, "(%s): checking scan list for APs older than %u seconds",
+	            nm_device_get_iface (NM_DEVICE (self)),
+	            prune_interval_s);
+
+	removed = nm_wifi_scan_list_cull (priv->aps,
+	                                  (glong) now - prune_interval_s,
+	                                  &scan_list_funcs,
+	                                  &ctx);
 
 	nm_log_dbg (LOGD_WIFI_SCAN, "(%s): removed %d APs (of %d)",
 	            nm_device_get_iface (NM_DEVICE (self)),
 	            removed, total);
 
-	ap_list_dump (self);
+	if (ctx.debug && removed)
+		ap_list_dump (self);
 
-	if(removed > 0)
-	    nm_device_recheck_available_connections (NM_DEVICE (self));
+	recheck_available_connections_for_ssids (self, ctx.changed_ssids);
+	g_hash_table_destroy (ctx.changed_ssids);
 
 	return FALSE;
 }
@@ -2072,18 +2638,21 @@ supplicant_iface_new_bss_cb (NMSupplicantInterface *iface,
 
 	ap = nm_ap_new_from_properties (object_path, properties);
 	if (ap) {
+		NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
+
 		nm_ap_dump (ap, "New AP: ");
 
-		/* Add the AP to the device's AP list */
-		merge_scanned_ap (self, ap);
-		g_object_unref (ap);
+		/* Queue the AP for the device's AP list; the batch is merged when
+		 * the scan is done, or shortly after if this BSS didn't come from
+		 * a scan we know about.
+		 */
+		priv->scan_batch = g_slist_prepend (priv->scan_batch, ap);
+		if (!priv->scan_batch_id)
+			priv->scan_batch_id = g_timeout_add (SCAN_BATCH_DELAY_MS, scan_batch_timeout, self);
 	} else {
 		nm_log_warn (LOGD_WIFI_SCAN, "(%s): invalid AP properties received",
 		             nm_device_get_iface (NM_DEVICE (self)));
 	}
-
-	/* Remove outdated access points */
-	schedule_scanlist_cull (self);
 }
 
 static void
@@ -2107,7 +2676,7 @@ supplicant_iface_bss_updated_cb (NMSupplicantInterface *iface,
 	/* Update the AP's last-seen property */
 	ap = get_ap_by_supplicant_path (self, object_path);
 	if (ap)
-		nm_ap_set_last_seen (ap, (guint32) time (NULL));
+		set_ap_last_seen (self, ap, (guint32) time (NULL));
 
 	/* Remove outdated access points */
 	schedule_scanlist_cull (self);
@@ -2124,8 +2693,20 @@ supplicant_iface_bss_removed_cb (NMSupplicantInterface *iface,
 	g_return_if_fail (object_path != NULL);
 
 	ap = get_ap_by_supplicant_path (self, object_path);
+	if (!ap) {
+		GSList *iter;
+
+		/* It may not have been merged yet */
+		for (iter = NM_DEVICE_WIFI_GET_PRIVATE (self)->scan_batch; iter; iter = g_slist_next (iter)) {
+			if (g_strcmp0 (object_path, nm_ap_get_supplicant_path (iter->data)) == 0) {
+				ap = iter->data;
+				break;
+			}
+		}
+	}
+
 	if (ap)
-		g_object_set_data (G_OBJECT (ap), WPAS_REMOVED_TAG, GUINT_TO_POINTER (TRUE));
+		set_ap_removed (self, ap);
 }
 
 
@@ -2213,7 +2794,7 @@ link_timeout_cb (gpointer user_data)
 		ap = nm_device_wifi_get_activation_ap (self);
 
 	if (ap)
-		remove_access_point (self, ap);
+		remove_access_point (self, ap, NULL);
 
 	nm_device_state_changed (dev,
 	                         NM_DEVICE_STATE_FAILED,
@@ -2930,7 +3511,7 @@ act_stage1_prepare (NMDevice *dev, NMDeviceStateReason *reason)
 	NMConnection *connection;
 	NMSettingWireless *s_wireless;
 	const GByteArray *cloned_mac;
-	GSList *iter;
+	GList *iter;
 	const char *mode;
 
 	req = nm_device_get_act_request (NM_DEVICE (self));
@@ -2977,7 +3558,7 @@ act_stage1_prepare (NMDevice *dev, NMDeviceStateReason *reason)
 			goto done;
 
 		/* Find a compatible AP in the scan list */
-		for (iter = priv->ap_list; iter; iter = g_slist_next (iter)) {
+		for (iter = nm_ap_table_get_list (priv->aps); iter; iter = g_list_next (iter)) {
 			NMAccessPoint *candidate = NM_AP (iter->data);
 
 			if (nm_ap_check_compatible (candidate, connection)) {
@@ -3002,8 +3583,8 @@ act_stage1_prepare (NMDevice *dev, NMDeviceStateReason *reason)
 		else if (nm_ap_is_hotspot (ap))
 			nm_ap_set_address (ap, (const struct ether_addr *) &priv->hw_addr);
 
-		priv->ap_list = g_slist_prepend (priv->ap_list, ap);
 		nm_ap_export_to_dbus (ap);
+		add_access_point (self, ap);
 		g_signal_emit (self, signals[ACCESS_POINT_ADDED], 0, ap);
 		nm_device_recheck_available_connections (NM_DEVICE (self));
 	}
@@ -3332,7 +3913,7 @@ activation_success_handler (NMDevice *dev)
 	 */
 	wifi_utils_get_bssid (priv->wifi_data, &bssid);
 	if (!nm_ethernet_address_is_valid (nm_ap_get_address (ap)))
-		nm_ap_set_address (ap, &bssid);
+		set_ap_address (self, ap, &bssid);
 	if (!nm_ap_get_freq (ap))
 		nm_ap_set_freq (ap, wifi_utils_get_freq (priv->wifi_data));
 	if (!nm_ap_get_max_bitrate (ap))
@@ -3353,7 +3934,7 @@ activation_success_handler (NMDevice *dev)
 		nm_active_connection_set_specific_object (NM_ACTIVE_CONNECTION (req),
 		                                          nm_ap_get_dbus_path (tmp_ap));
 
-		priv->ap_list = g_slist_remove (priv->ap_list, ap);
+		nm_ap_table_remove (priv->aps, ap);
 		g_object_unref (ap);
 	}
 
@@ -3388,7 +3969,7 @@ activation_failure_handler (NMDevice *dev)
 			 * list because we don't have any scan or capability info
 			 * for it, and they are pretty much useless.
 			 */
-			remove_access_point (self, ap);
+			remove_access_point (self, ap, NULL);
 		}
 	}
 }
@@ -3622,7 +4203,11 @@ nm_device_wifi_new (const char *udi,
 static void
 nm_device_wifi_init (NMDeviceWifi *self)
 {
-	NM_DEVICE_WIFI_GET_PRIVATE (self)->mode = NM_802_11_MODE_INFRA;
+	NMDeviceWifiPrivate *priv = NM_DEVICE_WIFI_GET_PRIVATE (self);
+
+	priv->mode = NM_802_11_MODE_INFRA;
+	priv->aps = nm_ap_table_new ();
+	priv->hidden_probes = g_hash_table_new_full (ssid_hash, ssid_equal, NULL, hidden_probe_free);
 }
 
 static void
@@ -3642,6 +4227,7 @@ dispose (GObject *object)
 		g_source_remove (priv->periodic_source_id);
 		priv->periodic_source_id = 0;
 	}
+	unmonitor_link (self);
 
 	cleanup_association_attempt (self, TRUE);
 	supplicant_interface_release (self);
@@ -3666,6 +4252,15 @@ dispose (GObject *object)
 	G_OBJECT_CLASS (nm_device_wifi_parent_class)->dispose (object);
 }
 
+static void
+finalize (GObject *object)
+{
+	nm_ap_table_free (NM_DEVICE_WIFI_GET_PRIVATE (object)->aps);
+	g_hash_table_destroy (NM_DEVICE_WIFI_GET_PRIVATE (object)->hidden_probes);
+
+	G_OBJECT_CLASS (nm_device_wifi_parent_class)->finalize (object);
+}
+
 static void
 get_property (GObject *object, guint prop_id,
               GValue *value, GParamSpec *pspec)
@@ -3737,6 +4332,7 @@ nm_device_wifi_class_init (NMDeviceWifiClass *klass)
 	object_class->get_property = get_property;
 	object_class->set_property = set_property;
 	object_class->dispose = dispose;
+	object_class->finalize = finalize;
 
 	parent_class->get_type_capabilities = get_type_capabilities;
 	parent_class->get_generic_capabilities = get_generic_capabilities;
@@ -3763,6 +4359,7 @@ nm_device_wifi_class_init (NMDeviceWifiClass *klass)
 	parent_class->deactivate = deactivate;
 	parent_class->can_interrupt_activation = can_interrupt_activation;
 	parent_class->spec_match_list = spec_match_list;
+	parent_class->add_snapshot_properties = add_snapshot_properties;
 	parent_class->hwaddr_matches = hwaddr_matches;
 
 	parent_class->state_changed = device_state_changed;
@@ -3872,7 +4469,7 @@ nm_device_wifi_class_init (NMDeviceWifiClass *klass)
 		              _nm_marshal_BOOLEAN__VOID,
 		              G_TYPE_BOOLEAN, 0);
 
-	dbus_g_object_type_install_info (G_TYPE_FROM_CLASS (klass), &dbus_glib_nm_device_wifi_object_info);
+	nm_properties_changed_signal_install_info (G_OBJECT_CLASS (klass), &dbus_glib_nm_device_wifi_object_info);
 
 	dbus_g_error_domain_register (NM_WIFI_ERROR, NULL, NM_TYPE_WIFI_ERROR);
 }
@@ -4842,8 +4842,8 @@ nm_device_class_init (NMDeviceClass *klass)
 		              _nm_marshal_VOID__OBJECT_OBJECT,
 		              G_TYPE_NONE, 2, G_TYPE_OBJECT, G_TYPE_OBJECT);
 
-	dbus_g_object_type_install_info (G_TYPE_FROM_CLASS (klass),
-	                                 &dbus_glib_nm_device_interface_object_info);
+	nm_properties_changed_signal_install_info (G_OBJECT_CLASS (klass),
+	                                           &dbus_glib_nm_device_interface_object_info);
 
 	dbus_g_error_domain_register (NM_DEVICE_ERROR, NULL, NM_TYPE_DEVICE_ERROR);
 }
@@ -5525,6 +5525,7 @@ _try_add_available_connection (NMDevice *self, NMConnection *connection)
 			g_hash_table_insert (NM_DEVICE_GET_PRIVATE (self)->available_connections,
 					             g_object_ref (connection),
 					             GUINT_TO_POINTER (1));
+			return TRUE;
 		}
 	}
 	return FALSE;
@@ -5565,6 +5566,47 @@ nm_device_recheck_available_connections (NMDevice *device)
 	_signal_available_connections_changed (device);
 }
 
+/**
+ * nm_device_recheck_available_connections_filtered:
+ * @device: the device
+ * @filter: selects the connections to recheck
+ * @user_data: passed to @filter
+ *
+ * Like nm_device_recheck_available_connections(), but only re-evaluates the
+ * connections @filter returns %TRUE for, keeping the others as they are.
+ * Signals at most once, and only if the set of available connections changed.
+ */
+void
+nm_device_recheck_available_connections_filtered (NMDevice *device,
+                                                  NMDeviceConnectionFilterFunc filter,
+                                                  gpointer user_data)
+{
+	NMDevicePrivate *priv;
+	const GSList *connections, *iter;
+	gboolean changed = FALSE;
+
+	g_return_if_fail (NM_IS_DEVICE (device));
+	g_return_if_fail (filter != NULL);
+
+	priv = NM_DEVICE_GET_PRIVATE (device);
+
+	connections = nm_connection_provider_get_connections (priv->con_provider);
+	for (iter = connections; iter; iter = g_slist_next (iter)) {
+		NMConnection *connection = NM_CONNECTION (iter->data);
+		gboolean was, is;
+
+		if (!filter (device, connection, user_data))
+			continue;
+
+		was = _del_available_connection (device, connection);
+		is = _try_add_available_connection (device, connection);
+		changed |= (was != is);
+	}
+
+	if (changed)
+		_signal_available_connections_changed (device);
+}
+
 static void
 cp_connection_added (NMConnectionProvider *cp, NMConnection *connection, gpointer user_data)
 {
@@ -5614,6 +5656,30 @@ nm_device_supports_vlans (NMDevice *device)
 	return NM_IS_DEVICE_ETHERNET (device);
 }
 
+/**
+ * nm_device_get_snapshot_properties:
+ * @device: the device
+ *
+ * Collects the exported D-Bus properties of @device, plus any object lists
+ * the device type only exports through D-Bus methods (keyed by the name
+ * libnm-glib uses for them, eg "AccessPoints").
+ *
+ * Returns: a new a{sv} hash table; free with g_hash_table_destroy().  %NULL
+ * if the device type has no introspection data.
+ */
+GHashTable *
+nm_device_get_snapshot_properties (NMDevice *device)
+{
+	GHashTable *props;
+
+	g_return_val_if_fail (NM_IS_DEVICE (device), NULL);
+
+	props = nm_properties_changed_signal_get_all (G_OBJECT (device));
+	if (props && NM_DEVICE_GET_CLASS (device)->add_snapshot_properties)
+		NM_DEVICE_GET_CLASS (device)->add_snapshot_properties (device, props);
+	return props;
+}
+
 /**
  * nm_device_read_hwaddr:
  * @dev: the device
@@ -191,6 +191,12 @@ typedef struct {
 
 	gboolean        (* have_any_ready_slaves) (NMDevice *self,
 	                                           const GSList *slaves);
+
+	/* Adds object lists that are only exported through D-Bus methods
+	 * (like GetAccessPoints) to a property snapshot of the device.
+	 */
+	void            (* add_snapshot_properties) (NMDevice *self,
+	                                             GHashTable *props);
 } NMDeviceClass;
 
 
@@ -306,6 +312,8 @@ void nm_device_set_connection_provider (NMDevice *device, NMConnectionProvider *
 
 gboolean nm_device_supports_vlans (NMDevice *device);
 
+GHashTable *nm_device_get_snapshot_properties (NMDevice *device);
+
 G_END_DECLS
 
 #endif	/* NM_DEVICE_H */
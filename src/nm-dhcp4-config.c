@@ -203,7 +203,8 @@ nm_dhcp4_config_class_init (NMDHCP4ConfigClass *config_class)
 	signals[PROPERTIES_CHANGED] = 
 		nm_properties_changed_signal_new (object_class,
 								    G_STRUCT_OFFSET (NMDHCP4ConfigClass, properties_changed));
+	nm_properties_changed_signal_cache_get_all (object_class, NM_DBUS_INTERFACE_DHCP4_CONFIG);
 
-	dbus_g_object_type_install_info (G_TYPE_FROM_CLASS (config_class),
-									 &dbus_glib_nm_dhcp4_config_object_info);
+	nm_properties_changed_signal_install_info (G_OBJECT_CLASS (config_class),
+	                                           &dbus_glib_nm_dhcp4_config_object_info);
 }
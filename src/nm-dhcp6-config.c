@@ -204,6 +204,6 @@ nm_dhcp6_config_class_init (NMDHCP6ConfigClass *config_class)
 		nm_properties_changed_signal_new (object_class,
 								    G_STRUCT_OFFSET (NMDHCP6ConfigClass, properties_changed));
 
-	dbus_g_object_type_install_info (G_TYPE_FROM_CLASS (config_class),
-									 &dbus_glib_nm_dhcp6_config_object_info);
+	nm_properties_changed_signal_install_info (G_OBJECT_CLASS (config_class),
+	                                           &dbus_glib_nm_dhcp6_config_object_info);
 }
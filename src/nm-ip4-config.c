@@ -35,6 +35,7 @@
 
 #include "nm-ip4-config-glue.h"
 #include "nm-dbus-glib-types.h"
+#include "nm-properties-changed-signal.h"
 
 
 G_DEFINE_TYPE (NMIP4Config, nm_ip4_config, G_TYPE_OBJECT)
@@ -136,6 +137,7 @@ nm_ip4_config_take_address (NMIP4Config *config, NMIP4Address *address)
 
 	priv = NM_IP4_CONFIG_GET_PRIVATE (config);
 	priv->addresses = g_slist_append (priv->addresses, address);
+	nm_properties_changed_signal_invalidate_get_all (G_OBJECT (config));
 }
 
 void
@@ -155,6 +157,7 @@ nm_ip4_config_add_address (NMIP4Config *config,
 	}
 
 	priv->addresses = g_slist_append (priv->addresses, nm_ip4_address_dup (address));
+	nm_properties_changed_signal_invalidate_get_all (G_OBJECT (config));
 }
 
 void
@@ -173,6 +176,7 @@ nm_ip4_config_replace_address (NMIP4Config *config,
 	nm_ip4_address_unref ((NMIP4Address *) old->data);
 
 	old->data = nm_ip4_address_dup (new_address);
+	nm_properties_changed_signal_invalidate_get_all (G_OBJECT (config));
 }
 
 NMIP4Address *nm_ip4_config_get_address (NMIP4Config *config, guint i)
@@ -221,6 +225,7 @@ void nm_ip4_config_add_nameserver (NMIP4Config *config, guint32 nameserver)
 	}
 
 	g_array_append_val (priv->nameservers, nameserver);
+	nm_properties_changed_signal_invalidate_get_all (G_OBJECT (config));
 }
 
 guint32 nm_ip4_config_get_nameserver (NMIP4Config *config, guint i)
@@ -246,6 +251,7 @@ void nm_ip4_config_reset_nameservers (NMIP4Config *config)
 	priv = NM_IP4_CONFIG_GET_PRIVATE (config);
 	if (priv->nameservers->len)
 		g_array_remove_range (priv->nameservers, 0, priv->nameservers->len);
+	nm_properties_changed_signal_invalidate_get_all (G_OBJECT (config));
 }
 
 void nm_ip4_config_add_wins (NMIP4Config *config, guint32 wins)
@@ -266,6 +272,7 @@ void nm_ip4_config_add_wins (NMIP4Config *config, guint32 wins)
 	}
 
 	g_array_append_val (priv->wins, wins);
+	nm_properties_changed_signal_invalidate_get_all (G_OBJECT (config));
 }
 
 guint32 nm_ip4_config_get_wins (NMIP4Config *config, guint i)
@@ -291,6 +298,7 @@ void nm_ip4_config_reset_wins (NMIP4Config *config)
 	priv = NM_IP4_CONFIG_GET_PRIVATE (config);
 	if (priv->wins->len)
 		g_array_remove_range (priv->wins, 0, priv->wins->len);
+	nm_properties_changed_signal_invalidate_get_all (G_OBJECT (config));
 }
 
 void
@@ -303,6 +311,7 @@ nm_ip4_config_take_route (NMIP4Config *config, NMIP4Route *route)
 
 	priv = NM_IP4_CONFIG_GET_PRIVATE (config);
 	priv->routes = g_slist_append (priv->routes, route);
+	nm_properties_changed_signal_invalidate_get_all (G_OBJECT (config));
 }
 
 void
@@ -321,6 +330,7 @@ nm_ip4_config_add_route (NMIP4Config *config, NMIP4Route *route)
 	}
 
 	priv->routes = g_slist_append (priv->routes, nm_ip4_route_dup (route));
+	nm_properties_changed_signal_invalidate_get_all (G_OBJECT (config));
 }
 
 void
@@ -339,6 +349,7 @@ nm_ip4_config_replace_route (NMIP4Config *config,
 	nm_ip4_route_unref ((NMIP4Route *) old->data);
 
 	old->data = nm_ip4_route_dup (new_route);
+	nm_properties_changed_signal_invalidate_get_all (G_OBJECT (config));
 }
 
 NMIP4Route *
@@ -365,6 +376,7 @@ void nm_ip4_config_reset_routes (NMIP4Config *config)
 	priv = NM_IP4_CONFIG_GET_PRIVATE (config);
 	g_slist_foreach (priv->routes, (GFunc) g_free, NULL);
 	priv->routes = NULL;
+	nm_properties_changed_signal_invalidate_get_all (G_OBJECT (config));
 }
 
 void nm_ip4_config_add_domain (NMIP4Config *config, const char *domain)
@@ -384,6 +396,7 @@ void nm_ip4_config_add_domain (NMIP4Config *config, const char *domain)
 	}
 
 	g_ptr_array_add (priv->domains, g_strdup (domain));
+	nm_properties_changed_signal_invalidate_get_all (G_OBJECT (config));
 }
 
 const char *nm_ip4_config_get_domain (NMIP4Config *config, guint i)
@@ -412,6 +425,7 @@ void nm_ip4_config_reset_domains (NMIP4Config *config)
 		g_free (g_ptr_array_index (priv->domains, i));
 	g_ptr_array_free (priv->domains, TRUE);
 	priv->domains = g_ptr_array_sized_new (3);
+	nm_properties_changed_signal_invalidate_get_all (G_OBJECT (config));
 }
 
 void nm_ip4_config_add_search (NMIP4Config *config, const char *search)
@@ -943,6 +957,9 @@ nm_ip4_config_class_init (NMIP4ConfigClass *config_class)
 	object_class->get_property = get_property;
 	object_class->finalize = finalize;
 
+	/* Exported configs rarely change; the setters drop the cached reply */
+	nm_properties_changed_signal_cache_get_all (object_class, NM_DBUS_INTERFACE_IP4_CONFIG);
+
 	/* properties */
 	g_object_class_install_property
 		(object_class, PROP_ADDRESSES,
@@ -980,6 +997,6 @@ nm_ip4_config_class_init (NMIP4ConfigClass *config_class)
 							 DBUS_TYPE_G_UINT_ARRAY,
 							 G_PARAM_READABLE));
 
-	dbus_g_object_type_install_info (G_TYPE_FROM_CLASS (config_class),
-									 &dbus_glib_nm_ip4_config_object_info);
+	nm_properties_changed_signal_install_info (G_OBJECT_CLASS (config_class),
+	                                           &dbus_glib_nm_ip4_config_object_info);
 }
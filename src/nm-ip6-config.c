@@ -24,6 +24,7 @@
 #include <string.h>
 #include "nm-ip6-config.h"
 #include "nm-dbus-manager.h"
+#include "nm-properties-changed-signal.h"
 #include "NetworkManager.h"
 #include "NetworkManagerUtils.h"
 #include "nm-setting-ip6-config.h"
@@ -847,6 +848,6 @@ nm_ip6_config_class_init (NMIP6ConfigClass *config_class)
 		                    DBUS_TYPE_G_ARRAY_OF_IP6_ROUTE,
 		                    G_PARAM_READABLE));
 
-	dbus_g_object_type_install_info (G_TYPE_FROM_CLASS (config_class),
-									 &dbus_glib_nm_ip6_config_object_info);
+	nm_properties_changed_signal_install_info (G_OBJECT_CLASS (config_class),
+	                                           &dbus_glib_nm_ip6_config_object_info);
 }
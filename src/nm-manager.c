@@ -89,6 +89,10 @@ static gboolean impl_manager_get_device_by_ip_iface (NMManager *self,
                                                      char **out_object_path,
                                                      GError **error);
 
+static gboolean impl_manager_get_object_tree (NMManager *self,
+                                              GHashTable **out_objects,
+                                              GError **error);
+
 static void impl_manager_activate_connection (NMManager *manager,
                                               const char *connection_path,
                                               const char *device_path,
@@ -1525,29 +1529,22 @@ manager_hidden_ap_found (NMDevice *device,
 	NMManager *manager = NM_MANAGER (user_data);
 	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (manager);
 	const struct ether_addr *bssid;
-	GSList *iter;
-	GSList *connections;
-	gboolean done = FALSE;
+	NMSettingsConnection *connection;
+	NMSettingWireless *s_wifi;
 
 	g_return_if_fail (nm_ap_get_ssid (ap) == NULL);
 
 	bssid = nm_ap_get_address (ap);
 	g_assert (bssid);
 
-	/* Look for this AP's BSSID in the seen-bssids list of a connection,
-	 * and if a match is found, copy over the SSID */
-	connections = nm_settings_get_connections (priv->settings);
-	for (iter = connections; iter && !done; iter = g_slist_next (iter)) {
-		NMConnection *connection = NM_CONNECTION (iter->data);
-		NMSettingWireless *s_wifi;
-
-		s_wifi = nm_connection_get_setting_wireless (connection);
-		if (s_wifi) {
-			if (nm_settings_connection_has_seen_bssid (NM_SETTINGS_CONNECTION (connection), bssid))
-				nm_ap_set_ssid (ap, nm_setting_wireless_get_ssid (s_wifi));
-		}
+	/* Look for a connection that has seen this AP's BSSID, and if one is
+	 * found, copy over the SSID */
+	connection = nm_settings_get_connection_by_seen_bssid (priv->settings, bssid);
+	if (connection) {
+		s_wifi = nm_connection_get_setting_wireless (NM_CONNECTION (connection));
+		if (s_wifi)
+			nm_ap_set_ssid (ap, nm_setting_wireless_get_ssid (s_wifi));
 	}
-	g_slist_free (connections);
 }
 
 static RfKillState
@@ -2408,6 +2405,85 @@ impl_manager_get_device_by_ip_iface (NMManager *self,
 	return path ? TRUE : FALSE;
 }
 
+static void object_tree_add (GHashTable *tree, DBusGConnection *bus, const char *path);
+
+static void
+object_tree_add_referenced (GHashTable *tree, DBusGConnection *bus, GHashTable *props)
+{
+	GHashTableIter iter;
+	GValue *value;
+
+	g_hash_table_iter_init (&iter, props);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &value)) {
+		if (G_VALUE_HOLDS (value, DBUS_TYPE_G_OBJECT_PATH))
+			object_tree_add (tree, bus, g_value_get_boxed (value));
+		else if (G_VALUE_HOLDS (value, DBUS_TYPE_G_ARRAY_OF_OBJECT_PATH)) {
+			GPtrArray *paths = g_value_get_boxed (value);
+			guint i;
+
+			for (i = 0; paths && i < paths->len; i++)
+				object_tree_add (tree, bus, g_ptr_array_index (paths, i));
+		}
+	}
+}
+
+static void
+object_tree_add (GHashTable *tree, DBusGConnection *bus, const char *path)
+{
+	GObject *object;
+	GHashTable *props;
+
+	if (!path || !strcmp (path, "/") || g_hash_table_lookup (tree, path))
+		return;
+
+	object = dbus_g_connection_lookup_g_object (bus, path);
+	if (!object)
+		return;
+
+	/* Clients read connections through the settings service instead */
+	if (NM_IS_SETTINGS_CONNECTION (object))
+		return;
+
+	if (NM_IS_DEVICE (object))
+		props = nm_device_get_snapshot_properties (NM_DEVICE (object));
+	else
+		props = nm_properties_changed_signal_get_all (object);
+	if (!props)
+		return;
+	g_hash_table_insert (tree, g_strdup (path), props);
+
+	object_tree_add_referenced (tree, bus, props);
+}
+
+static gboolean
+impl_manager_get_object_tree (NMManager *self,
+                              GHashTable **out_objects,
+                              GError **error)
+{
+	NMManagerPrivate *priv = NM_MANAGER_GET_PRIVATE (self);
+	DBusGConnection *bus = nm_dbus_manager_get_connection (priv->dbus_mgr);
+	GHashTable *tree, *props;
+	GPtrArray *devices = NULL;
+	GValue *value;
+
+	tree = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+	                              (GDestroyNotify) g_hash_table_destroy);
+
+	/* The device list is only exported through GetDevices() */
+	props = nm_properties_changed_signal_get_all (G_OBJECT (self));
+	impl_manager_get_devices (self, &devices, NULL);
+	value = g_slice_new0 (GValue);
+	g_value_init (value, DBUS_TYPE_G_ARRAY_OF_OBJECT_PATH);
+	g_value_take_boxed (value, devices);
+	g_hash_table_insert (props, g_strdup ("Devices"), value);
+	g_hash_table_insert (tree, g_strdup (NM_DBUS_PATH), props);
+
+	object_tree_add_referenced (tree, bus, props);
+
+	*out_objects = tree;
+	return TRUE;
+}
+
 static NMActiveConnection *
 internal_activate_device (NMManager *manager,
                           NMDevice *device,
@@ -4107,6 +4183,10 @@ nm_manager_new (NMSettings *settings,
 		return NULL;
     }
 
+	/* Serve GetAll for access points and IP/DHCP configs from a cache */
+	if (!nm_properties_changed_signal_add_get_all_filter (bus))
+		nm_log_warn (LOGD_CORE, "failed to register DBus GetAll cache filter");
+
 	priv->settings = g_object_ref (settings);
 
 	priv->state_file = g_strdup (state_file);
@@ -4244,6 +4324,7 @@ dispose (GObject *object)
 		dbus_connection = dbus_g_connection_get_connection (bus);
 		g_assert (dbus_connection);
 		dbus_connection_remove_filter (dbus_connection, prop_filter, manager);
+		nm_properties_changed_signal_remove_get_all_filter (bus);
 	}
 	g_object_unref (priv->dbus_mgr);
 
@@ -4776,8 +4857,8 @@ nm_manager_class_init (NMManagerClass *manager_class)
 		              g_cclosure_marshal_VOID__OBJECT,
 		              G_TYPE_NONE, 1, G_TYPE_OBJECT);
 
-	dbus_g_object_type_install_info (G_TYPE_FROM_CLASS (manager_class),
-	                                 &dbus_glib_nm_manager_object_info);
+	nm_properties_changed_signal_install_info (G_OBJECT_CLASS (manager_class),
+	                                           &dbus_glib_nm_manager_object_info);
 
 	dbus_g_error_domain_register (NM_MANAGER_ERROR, NULL, NM_TYPE_MANAGER_ERROR);
 	dbus_g_error_domain_register (NM_LOGGING_ERROR, "org.freedesktop.NetworkManager.Logging", NM_TYPE_LOGGING_ERROR);
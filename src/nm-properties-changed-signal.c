@@ -23,6 +23,7 @@
 #include <stdio.h>
 
 #include <dbus/dbus-glib.h>
+#include <dbus/dbus-glib-lowlevel.h>
 #ifdef DEBUG
 #include "nm-logging.h"
 #endif
@@ -30,13 +31,42 @@
 #include "nm-dbus-glib-types.h"
 
 #define NM_DBUS_PROPERTY_CHANGED "NM_DBUS_PROPERTY_CHANGED"
+#define NM_DBUS_GET_ALL_REPLY    "NM_DBUS_GET_ALL_REPLY"
+
+static GQuark dbus_name_quark;
+static GQuark threshold_quark;
+static GQuark get_all_iface_quark;
+static GQuark exported_props_quark;
+
+/* Minimum time between two PropertiesChanged signals of an object */
+static guint rate_limit_interval = 0;
 
 typedef struct {
+	/* D-Bus property name (interned) -> GValue */
 	GHashTable *hash;
 	gulong signal_id;
 	guint idle_id;
+
+	/* Rate limiting; while timeout_id is set, changes are only collected */
+	guint timeout_id;
+
+	/* GParamSpec -> last value queued for emission, for properties
+	 * with a minimum-change threshold.
+	 */
+	GHashTable *last_values;
 } PropertiesChangedInfo;
 
+static void
+init_quarks (void)
+{
+	if (G_UNLIKELY (!dbus_name_quark)) {
+		dbus_name_quark = g_quark_from_static_string ("nm-dbus-property-name");
+		threshold_quark = g_quark_from_static_string ("nm-dbus-property-threshold");
+		get_all_iface_quark = g_quark_from_static_string ("nm-dbus-get-all-interface");
+		exported_props_quark = g_quark_from_static_string ("nm-dbus-exported-properties");
+	}
+}
+
 static void
 destroy_value (gpointer data)
 {
@@ -47,14 +77,13 @@ destroy_value (gpointer data)
 }
 
 static PropertiesChangedInfo *
-properties_changed_info_new (void)
+properties_changed_info_new (GObject *object)
 {
 	PropertiesChangedInfo *info;
 
 	info = g_slice_new0 (PropertiesChangedInfo);
-	info->hash = g_hash_table_new_full (g_str_hash, g_str_equal, 
-								 (GDestroyNotify) g_free,
-								 destroy_value);
+	info->hash = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, destroy_value);
+
 	return info;
 }
 
@@ -65,8 +94,12 @@ properties_changed_info_destroy (gpointer data)
 
 	if (info->idle_id)
 		g_source_remove (info->idle_id);
+	if (info->timeout_id)
+		g_source_remove (info->timeout_id);
 
 	g_hash_table_destroy (info->hash);
+	if (info->last_values)
+		g_hash_table_destroy (info->last_values);
 	g_slice_free (PropertiesChangedInfo, info);
 }
 
@@ -97,14 +130,11 @@ add_to_string (gpointer key, gpointer value, gpointer user_data)
 }
 #endif
 
-static gboolean
-properties_changed (gpointer data)
-{
-	GObject *object = G_OBJECT (data);
-	PropertiesChangedInfo *info = (PropertiesChangedInfo *) g_object_get_data (object, NM_DBUS_PROPERTY_CHANGED);
-
-	g_assert (info);
+static gboolean rate_limit_expired (gpointer data);
 
+static void
+emit_changes (GObject *object, PropertiesChangedInfo *info)
+{
 #ifdef DEBUG
 	{
 		char buf[2048] = { 0, };
@@ -115,10 +145,43 @@ properties_changed (gpointer data)
 
 	g_signal_emit (object, info->signal_id, 0, info->hash);
 	g_hash_table_remove_all (info->hash);
+}
+
+static gboolean
+properties_changed (gpointer data)
+{
+	GObject *object = G_OBJECT (data);
+	PropertiesChangedInfo *info = (PropertiesChangedInfo *) g_object_get_data (object, NM_DBUS_PROPERTY_CHANGED);
+
+	g_assert (info);
+
+	emit_changes (object, info);
+
+	/* Hold back further changes until the interval is over */
+	if (rate_limit_interval)
+		info->timeout_id = g_timeout_add (rate_limit_interval, rate_limit_expired, object);
 
 	return FALSE;
 }
 
+static gboolean
+rate_limit_expired (gpointer data)
+{
+	GObject *object = G_OBJECT (data);
+	PropertiesChangedInfo *info = (PropertiesChangedInfo *) g_object_get_data (object, NM_DBUS_PROPERTY_CHANGED);
+
+	g_assert (info);
+
+	/* Emit what was collected during the interval and start another one */
+	if (g_hash_table_size (info->hash)) {
+		emit_changes (object, info);
+		return TRUE;
+	}
+
+	info->timeout_id = 0;
+	return FALSE;
+}
+
 static void
 idle_id_reset (gpointer data)
 {
@@ -157,19 +220,92 @@ uscore_to_wincaps (const char *uscore)
 	return g_string_free (str, FALSE);
 }
 
+/* The D-Bus name of a property, computed once per GParamSpec */
+static const char *
+get_dbus_name (GParamSpec *pspec)
+{
+	const char *name;
+	char *tmp;
+
+	name = g_param_spec_get_qdata (pspec, dbus_name_quark);
+	if (G_UNLIKELY (!name)) {
+		tmp = uscore_to_wincaps (pspec->name);
+		name = g_intern_string (tmp);
+		g_free (tmp);
+		g_param_spec_set_qdata (pspec, dbus_name_quark, (gpointer) name);
+	}
+	return name;
+}
+
+static gboolean
+value_get_int64 (const GValue *value, gint64 *out)
+{
+	switch (G_TYPE_FUNDAMENTAL (G_VALUE_TYPE (value))) {
+	case G_TYPE_CHAR:
+		*out = g_value_get_schar (value);
+		return TRUE;
+	case G_TYPE_UCHAR:
+		*out = g_value_get_uchar (value);
+		return TRUE;
+	case G_TYPE_INT:
+		*out = g_value_get_int (value);
+		return TRUE;
+	case G_TYPE_UINT:
+		*out = g_value_get_uint (value);
+		return TRUE;
+	case G_TYPE_INT64:
+		*out = g_value_get_int64 (value);
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+/* Returns TRUE if @value differs enough from the last queued value of a
+ * thresholded property to be worth sending, and remembers it if so.
+ */
+static gboolean
+passes_threshold (PropertiesChangedInfo *info, GParamSpec *pspec, const GValue *value)
+{
+	guint threshold;
+	gint64 new_val;
+	gpointer last;
+
+	threshold = GPOINTER_TO_UINT (g_param_spec_get_qdata (pspec, threshold_quark));
+	if (!threshold || !value_get_int64 (value, &new_val))
+		return TRUE;
+
+	if (!info->last_values)
+		info->last_values = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+
+	last = g_hash_table_lookup (info->last_values, pspec);
+	if (last && ABS (new_val - *((gint64 *) last)) < threshold)
+		return FALSE;
+
+	if (!last) {
+		last = g_new (gint64, 1);
+		g_hash_table_insert (info->last_values, pspec, last);
+	}
+	*((gint64 *) last) = new_val;
+	return TRUE;
+}
+
 static void
 notify (GObject *object, GParamSpec *pspec)
 {
 	PropertiesChangedInfo *info;
 	GValue *value;
 
+	/* The cached GetAll reply may hold it even if PropertiesChanged doesn't */
+	nm_properties_changed_signal_invalidate_get_all (object);
+
 	/* Ignore properties that shouldn't be exported */
 	if (pspec->flags & NM_PROPERTY_PARAM_NO_EXPORT)
 		return;
 
 	info = (PropertiesChangedInfo *) g_object_get_data (object, NM_DBUS_PROPERTY_CHANGED);
 	if (!info) {
-		info = properties_changed_info_new ();
+		info = properties_changed_info_new (object);
 		g_object_set_data_full (object, NM_DBUS_PROPERTY_CHANGED, info, properties_changed_info_destroy);
 		info->signal_id = g_signal_lookup ("properties-changed", G_OBJECT_TYPE (object));
 		g_assert (info->signal_id);
@@ -178,18 +314,599 @@ notify (GObject *object, GParamSpec *pspec)
 	value = g_slice_new0 (GValue);
 	g_value_init (value, pspec->value_type);
 	g_object_get_property (object, pspec->name, value);
-	g_hash_table_insert (info->hash, uscore_to_wincaps (pspec->name), value);
 
-	if (!info->idle_id)
+	if (!passes_threshold (info, pspec, value)) {
+		destroy_value (value);
+		return;
+	}
+
+	g_hash_table_insert (info->hash, (char *) get_dbus_name (pspec), value);
+
+	/* During a rate limit interval the timeout emits the changes */
+	if (!info->idle_id && !info->timeout_id)
 		info->idle_id = g_idle_add_full (G_PRIORITY_DEFAULT_IDLE, properties_changed, object, idle_id_reset);
 }
 
+static gboolean
+value_type_is_exportable (GType type)
+{
+	switch (G_TYPE_FUNDAMENTAL (type)) {
+	case G_TYPE_BOOLEAN:
+	case G_TYPE_CHAR:
+	case G_TYPE_UCHAR:
+	case G_TYPE_INT:
+	case G_TYPE_UINT:
+	case G_TYPE_INT64:
+	case G_TYPE_UINT64:
+	case G_TYPE_DOUBLE:
+	case G_TYPE_STRING:
+		return TRUE;
+	case G_TYPE_BOXED:
+		return    type == G_TYPE_STRV
+		       || type == DBUS_TYPE_G_OBJECT_PATH
+		       || dbus_g_type_is_collection (type)
+		       || dbus_g_type_is_map (type)
+		       || dbus_g_type_is_struct (type);
+	default:
+		return FALSE;
+	}
+}
+
+/**
+ * nm_properties_changed_signal_install_info:
+ * @object_class: the class
+ * @info: the class's dbus-glib introspection data
+ *
+ * Installs @info like dbus_g_object_type_install_info() does, and remembers
+ * which properties it exports for nm_properties_changed_signal_get_all().
+ */
+void
+nm_properties_changed_signal_install_info (GObjectClass *object_class,
+                                           const DBusGObjectInfo *info)
+{
+	GType type = G_OBJECT_CLASS_TYPE (object_class);
+	GHashTable *names;
+	const char *p, *iface, *name;
+
+	dbus_g_object_type_install_info (type, info);
+
+	init_quarks ();
+
+	/* Interned D-Bus property name -> interned interface */
+	names = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+	/* A list of "interface\0DBusName\0" entries, each followed by
+	 * "name_on_object\0access\0" from format version 1 on, and ending
+	 * with an empty string.
+	 */
+	for (p = info->exported_properties; p && *p; ) {
+		iface = g_intern_string (p);
+		p += strlen (p) + 1;
+		name = g_intern_string (p);
+		g_hash_table_insert (names, (gpointer) name, (gpointer) iface);
+		p += strlen (p) + 1;
+		if (info->format_version >= 1) {
+			p += strlen (p) + 1;
+			p += strlen (p) + 1;
+		}
+	}
+
+	g_type_set_qdata (type, exported_props_quark, names);
+}
+
+/* Collects the GParamSpecs of the properties @object exports on D-Bus,
+ * according to the introspection data its class and parent classes installed
+ * with nm_properties_changed_signal_install_info(); only those on @iface if
+ * it isn't %NULL.  dbus-glib's own GetAll goes by the same list.
+ *
+ * Returns %FALSE if no introspection data was installed for @object's type.
+ */
+static gboolean
+list_exported_properties (GObject *object, const char *iface, GSList **out)
+{
+	GSList *exported = NULL, *iter;
+	GParamSpec **pspecs;
+	guint n_pspecs, i;
+	GHashTable *names;
+	GType type;
+	const char *prop_iface;
+
+	init_quarks ();
+	for (type = G_OBJECT_TYPE (object); type; type = g_type_parent (type)) {
+		names = g_type_get_qdata (type, exported_props_quark);
+		if (names)
+			exported = g_slist_prepend (exported, names);
+	}
+	if (!exported)
+		return FALSE;
+
+	if (iface)
+		iface = g_intern_string (iface);
+
+	*out = NULL;
+	pspecs = g_object_class_list_properties (G_OBJECT_GET_CLASS (object), &n_pspecs);
+	for (i = 0; i < n_pspecs; i++) {
+		GParamSpec *pspec = pspecs[i];
+
+		if (   !(pspec->flags & G_PARAM_READABLE)
+		    || !value_type_is_exportable (pspec->value_type))
+			continue;
+
+		/* NM_PROPERTY_PARAM_NO_EXPORT only keeps a property out of
+		 * PropertiesChanged; the introspection data decides the rest.
+		 */
+		prop_iface = NULL;
+		for (iter = exported; iter && !prop_iface; iter = iter->next)
+			prop_iface = g_hash_table_lookup (iter->data, get_dbus_name (pspec));
+		if (!prop_iface || (iface && prop_iface != iface))
+			continue;
+
+		*out = g_slist_prepend (*out, pspec);
+	}
+	g_free (pspecs);
+	g_slist_free (exported);
+
+	*out = g_slist_reverse (*out);
+	return TRUE;
+}
+
+/**
+ * nm_properties_changed_signal_get_all:
+ * @object: the object
+ *
+ * Reads every property that @object exports on D-Bus (according to the
+ * introspection data its class and parent classes installed with
+ * nm_properties_changed_signal_install_info()) into a hash table keyed by
+ * the D-Bus property name.
+ *
+ * Returns: a new a{sv} hash table; free with g_hash_table_destroy().  %NULL
+ * if no introspection data was installed for @object's type.
+ */
+GHashTable *
+nm_properties_changed_signal_get_all (GObject *object)
+{
+	GHashTable *hash;
+	GSList *props, *iter;
+	GValue *value;
+
+	g_return_val_if_fail (G_IS_OBJECT (object), NULL);
+
+	if (!list_exported_properties (object, NULL, &props))
+		return NULL;
+
+	hash = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, destroy_value);
+	for (iter = props; iter; iter = iter->next) {
+		GParamSpec *pspec = iter->data;
+
+		value = g_slice_new0 (GValue);
+		g_value_init (value, pspec->value_type);
+		g_object_get_property (object, pspec->name, value);
+		g_hash_table_insert (hash, g_strdup (get_dbus_name (pspec)), value);
+	}
+	g_slist_free (props);
+
+	return hash;
+}
+
+/**
+ * nm_properties_changed_signal_set_rate_limit:
+ * @interval_ms: minimum time between two PropertiesChanged signals, or 0
+ *
+ * Limits every object that uses nm_properties_changed_signal_new() to one
+ * PropertiesChanged signal per @interval_ms.  The first change is still sent
+ * right away; changes made during the interval are merged and sent when it
+ * ends.
+ */
+void
+nm_properties_changed_signal_set_rate_limit (guint interval_ms)
+{
+	rate_limit_interval = interval_ms;
+}
+
+/**
+ * nm_properties_changed_signal_set_threshold:
+ * @object_class: a class that uses nm_properties_changed_signal_new()
+ * @property: name of an integer property of @object_class
+ * @threshold: minimum change worth signalling
+ *
+ * Drops changes of @property that differ by less than @threshold from the
+ * last value sent in PropertiesChanged.  Clients that need the exact value
+ * can still read it with Get or GetAll.
+ */
+void
+nm_properties_changed_signal_set_threshold (GObjectClass *object_class,
+                                            const char *property,
+                                            guint threshold)
+{
+	GParamSpec *pspec;
+
+	pspec = g_object_class_find_property (object_class, property);
+	g_return_if_fail (pspec != NULL);
+
+	init_quarks ();
+	g_param_spec_set_qdata (pspec, threshold_quark, GUINT_TO_POINTER (threshold));
+}
+
+/*****************************************************************************/
+/* Cached GetAll replies.
+ *
+ * dbus-glib answers Properties.GetAll by reading and marshalling every
+ * property again.  For classes that opt in, a connection filter answers it
+ * instead with a copy of a reply marshalled once and kept until a property
+ * changes.
+ */
+
+static gboolean
+append_signature (GString *sig, GType type)
+{
+	switch (G_TYPE_FUNDAMENTAL (type)) {
+	case G_TYPE_BOOLEAN:
+		g_string_append_c (sig, 'b');
+		return TRUE;
+	case G_TYPE_CHAR:
+	case G_TYPE_UCHAR:
+		g_string_append_c (sig, 'y');
+		return TRUE;
+	case G_TYPE_INT:
+		g_string_append_c (sig, 'i');
+		return TRUE;
+	case G_TYPE_UINT:
+		g_string_append_c (sig, 'u');
+		return TRUE;
+	case G_TYPE_INT64:
+		g_string_append_c (sig, 'x');
+		return TRUE;
+	case G_TYPE_UINT64:
+		g_string_append_c (sig, 't');
+		return TRUE;
+	case G_TYPE_DOUBLE:
+		g_string_append_c (sig, 'd');
+		return TRUE;
+	case G_TYPE_STRING:
+		g_string_append_c (sig, 's');
+		return TRUE;
+	default:
+		break;
+	}
+
+	if (type == G_TYPE_VALUE) {
+		g_string_append_c (sig, 'v');
+		return TRUE;
+	} else if (type == DBUS_TYPE_G_OBJECT_PATH) {
+		g_string_append_c (sig, 'o');
+		return TRUE;
+	} else if (type == G_TYPE_STRV) {
+		g_string_append (sig, "as");
+		return TRUE;
+	} else if (dbus_g_type_is_collection (type)) {
+		g_string_append_c (sig, 'a');
+		return append_signature (sig, dbus_g_type_get_collection_specialization (type));
+	} else if (dbus_g_type_is_map (type)) {
+		g_string_append (sig, "a{");
+		if (   !append_signature (sig, dbus_g_type_get_map_key_specialization (type))
+		    || !append_signature (sig, dbus_g_type_get_map_value_specialization (type)))
+			return FALSE;
+		g_string_append_c (sig, '}');
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+static char *
+get_signature (GType type)
+{
+	GString *sig = g_string_sized_new (8);
+
+	if (!append_signature (sig, type)) {
+		g_string_free (sig, TRUE);
+		return NULL;
+	}
+	return g_string_free (sig, FALSE);
+}
+
+typedef struct {
+	DBusMessageIter *iter;
+	gboolean success;
+} AppendInfo;
+
+static gboolean append_value (DBusMessageIter *iter, const GValue *value);
+
+static void
+append_collection_item (const GValue *value, gpointer user_data)
+{
+	AppendInfo *info = user_data;
+
+	if (info->success)
+		info->success = append_value (info->iter, value);
+}
+
+static void
+append_map_item (const GValue *key, const GValue *value, gpointer user_data)
+{
+	AppendInfo *info = user_data;
+	DBusMessageIter entry;
+
+	if (!info->success)
+		return;
+
+	dbus_message_iter_open_container (info->iter, DBUS_TYPE_DICT_ENTRY, NULL, &entry);
+	info->success = append_value (&entry, key) && append_value (&entry, value);
+	dbus_message_iter_close_container (info->iter, &entry);
+}
+
+static gboolean
+append_container (DBusMessageIter *iter, const GValue *value)
+{
+	GType type = G_VALUE_TYPE (value);
+	DBusMessageIter sub;
+	AppendInfo info;
+	char *sig;
+
+	/* Element signature, without the leading 'a' */
+	sig = get_signature (type);
+	if (!sig)
+		return FALSE;
+
+	dbus_message_iter_open_container (iter, DBUS_TYPE_ARRAY, sig + 1, &sub);
+	g_free (sig);
+
+	info.iter = &sub;
+	info.success = TRUE;
+	if (g_value_get_boxed (value)) {
+		if (type == G_TYPE_STRV) {
+			char **strv = g_value_get_boxed (value);
+
+			for (; *strv; strv++)
+				dbus_message_iter_append_basic (&sub, DBUS_TYPE_STRING, strv);
+		} else if (dbus_g_type_is_collection (type))
+			dbus_g_type_collection_value_iterate (value, append_collection_item, &info);
+		else
+			dbus_g_type_map_value_iterate (value, append_map_item, &info);
+	}
+
+	dbus_message_iter_close_container (iter, &sub);
+	return info.success;
+}
+
+static gboolean
+append_value (DBusMessageIter *iter, const GValue *value)
+{
+	GType type = G_VALUE_TYPE (value);
+	DBusMessageIter sub;
+	dbus_bool_t b;
+	guchar y;
+	dbus_int32_t i;
+	dbus_uint32_t u;
+	dbus_int64_t x;
+	dbus_uint64_t t;
+	double d;
+	const char *str;
+	const GValue *inner;
+	char *sig;
+	gboolean success;
+
+	switch (G_TYPE_FUNDAMENTAL (type)) {
+	case G_TYPE_BOOLEAN:
+		b = g_value_get_boolean (value);
+		return dbus_message_iter_append_basic (iter, DBUS_TYPE_BOOLEAN, &b);
+	case G_TYPE_CHAR:
+		y = (guchar) g_value_get_schar (value);
+		return dbus_message_iter_append_basic (iter, DBUS_TYPE_BYTE, &y);
+	case G_TYPE_UCHAR:
+		y = g_value_get_uchar (value);
+		return dbus_message_iter_append_basic (iter, DBUS_TYPE_BYTE, &y);
+	case G_TYPE_INT:
+		i = g_value_get_int (value);
+		return dbus_message_iter_append_basic (iter, DBUS_TYPE_INT32, &i);
+	case G_TYPE_UINT:
+		u = g_value_get_uint (value);
+		return dbus_message_iter_append_basic (iter, DBUS_TYPE_UINT32, &u);
+	case G_TYPE_INT64:
+		x = g_value_get_int64 (value);
+		return dbus_message_iter_append_basic (iter, DBUS_TYPE_INT64, &x);
+	case G_TYPE_UINT64:
+		t = g_value_get_uint64 (value);
+		return dbus_message_iter_append_basic (iter, DBUS_TYPE_UINT64, &t);
+	case G_TYPE_DOUBLE:
+		d = g_value_get_double (value);
+		return dbus_message_iter_append_basic (iter, DBUS_TYPE_DOUBLE, &d);
+	case G_TYPE_STRING:
+		str = g_value_get_string (value);
+		if (!str)
+			str = "";
+		return dbus_message_iter_append_basic (iter, DBUS_TYPE_STRING, &str);
+	default:
+		break;
+	}
+
+	if (type == G_TYPE_VALUE) {
+		inner = g_value_get_boxed (value);
+		if (!inner)
+			return FALSE;
+		sig = get_signature (G_VALUE_TYPE (inner));
+		if (!sig)
+			return FALSE;
+		dbus_message_iter_open_container (iter, DBUS_TYPE_VARIANT, sig, &sub);
+		g_free (sig);
+		success = append_value (&sub, inner);
+		dbus_message_iter_close_container (iter, &sub);
+		return success;
+	} else if (type == DBUS_TYPE_G_OBJECT_PATH) {
+		str = g_value_get_boxed (value);
+		if (!str)
+			str = "/";
+		return dbus_message_iter_append_basic (iter, DBUS_TYPE_OBJECT_PATH, &str);
+	} else if (   type == G_TYPE_STRV
+	           || dbus_g_type_is_collection (type)
+	           || dbus_g_type_is_map (type))
+		return append_container (iter, value);
+
+	return FALSE;
+}
+
+static DBusMessage *
+build_get_all_reply (GObject *object, DBusMessage *message, const char *iface)
+{
+	DBusMessage *reply;
+	DBusMessageIter iter, dict, entry, variant;
+	GSList *props, *piter;
+	gboolean success = TRUE;
+
+	if (!list_exported_properties (object, iface, &props))
+		return NULL;
+
+	reply = dbus_message_new_method_return (message);
+	dbus_message_iter_init_append (reply, &iter);
+	dbus_message_iter_open_container (&iter, DBUS_TYPE_ARRAY, "{sv}", &dict);
+
+	for (piter = props; success && piter; piter = piter->next) {
+		GParamSpec *pspec = piter->data;
+		GValue value = { 0, };
+		const char *name;
+		char *sig;
+
+		sig = get_signature (pspec->value_type);
+		if (!sig) {
+			success = FALSE;
+			break;
+		}
+
+		g_value_init (&value, pspec->value_type);
+		g_object_get_property (object, pspec->name, &value);
+
+		name = get_dbus_name (pspec);
+		dbus_message_iter_open_container (&dict, DBUS_TYPE_DICT_ENTRY, NULL, &entry);
+		dbus_message_iter_append_basic (&entry, DBUS_TYPE_STRING, &name);
+		dbus_message_iter_open_container (&entry, DBUS_TYPE_VARIANT, sig, &variant);
+		success = append_value (&variant, &value);
+		dbus_message_iter_close_container (&entry, &variant);
+		dbus_message_iter_close_container (&dict, &entry);
+
+		g_value_unset (&value);
+		g_free (sig);
+	}
+	g_slist_free (props);
+
+	dbus_message_iter_close_container (&iter, &dict);
+
+	if (!success) {
+		/* Leave this one to dbus-glib */
+		dbus_message_unref (reply);
+		return NULL;
+	}
+	return reply;
+}
+
+static const char *
+get_cached_interface (GType type)
+{
+	const char *iface = NULL;
+
+	for (; type && !iface; type = g_type_parent (type))
+		iface = g_type_get_qdata (type, get_all_iface_quark);
+	return iface;
+}
+
+static DBusHandlerResult
+get_all_filter (DBusConnection *connection,
+                DBusMessage *message,
+                void *user_data)
+{
+	DBusGConnection *bus = user_data;
+	const char *path, *iface = NULL, *cached_iface;
+	GObject *object;
+	DBusMessage *cached, *reply;
+
+	if (!dbus_message_is_method_call (message, DBUS_INTERFACE_PROPERTIES, "GetAll"))
+		return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+
+	path = dbus_message_get_path (message);
+	if (!path)
+		return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+
+	object = dbus_g_connection_lookup_g_object (bus, path);
+	if (!object)
+		return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+
+	cached_iface = get_cached_interface (G_OBJECT_TYPE (object));
+	if (!cached_iface)
+		return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+
+	if (   !dbus_message_get_args (message, NULL, DBUS_TYPE_STRING, &iface, DBUS_TYPE_INVALID)
+	    || strcmp (iface, cached_iface))
+		return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+
+	cached = g_object_get_data (object, NM_DBUS_GET_ALL_REPLY);
+	if (!cached) {
+		cached = build_get_all_reply (object, message, iface);
+		if (!cached)
+			return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+		g_object_set_data_full (object, NM_DBUS_GET_ALL_REPLY, cached,
+		                        (GDestroyNotify) dbus_message_unref);
+	}
+
+	/* The copy shares nothing with the cached message but its body */
+	reply = dbus_message_copy (cached);
+	dbus_message_set_reply_serial (reply, dbus_message_get_serial (message));
+	dbus_message_set_destination (reply, dbus_message_get_sender (message));
+	dbus_connection_send (connection, reply, NULL);
+	dbus_message_unref (reply);
+
+	return DBUS_HANDLER_RESULT_HANDLED;
+}
+
+/**
+ * nm_properties_changed_signal_cache_get_all:
+ * @object_class: the class
+ * @dbus_interface: the D-Bus interface that @object_class exports
+ *
+ * Answers Properties.GetAll for @dbus_interface on exported instances of
+ * @object_class from a cached, already marshalled reply.  The cache is
+ * dropped whenever an exported property is notified; classes that change
+ * their properties without notifying must call
+ * nm_properties_changed_signal_invalidate_get_all() themselves.
+ */
+void
+nm_properties_changed_signal_cache_get_all (GObjectClass *object_class,
+                                            const char *dbus_interface)
+{
+	init_quarks ();
+	g_type_set_qdata (G_OBJECT_CLASS_TYPE (object_class), get_all_iface_quark,
+	                  (gpointer) g_intern_string (dbus_interface));
+
+}
+
+void
+nm_properties_changed_signal_invalidate_get_all (GObject *object)
+{
+	if (g_object_get_data (object, NM_DBUS_GET_ALL_REPLY))
+		g_object_set_data (object, NM_DBUS_GET_ALL_REPLY, NULL);
+}
+
+gboolean
+nm_properties_changed_signal_add_get_all_filter (DBusGConnection *bus)
+{
+	return dbus_connection_add_filter (dbus_g_connection_get_connection (bus),
+	                                   get_all_filter, bus, NULL);
+}
+
+void
+nm_properties_changed_signal_remove_get_all_filter (DBusGConnection *bus)
+{
+	dbus_connection_remove_filter (dbus_g_connection_get_connection (bus),
+	                               get_all_filter, bus);
+}
+
+/*****************************************************************************/
+
 guint
 nm_properties_changed_signal_new (GObjectClass *object_class,
 						    guint class_offset)
 {
 	guint id;
 
+	init_quarks ();
 	object_class->notify = notify;
 
 	id = g_signal_new ("properties-changed",
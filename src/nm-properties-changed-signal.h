@@ -23,10 +23,29 @@
 #define _NM_PROPERTIES_CHANGED_SIGNAL_H_
 
 #include <glib-object.h>
+#include <dbus/dbus-glib.h>
 
 #define NM_PROPERTY_PARAM_NO_EXPORT    (1 << (0 + G_PARAM_USER_SHIFT))
 
 guint nm_properties_changed_signal_new (GObjectClass *object_class,
 								guint class_offset);
 
+void nm_properties_changed_signal_set_rate_limit (guint interval_ms);
+
+void nm_properties_changed_signal_set_threshold (GObjectClass *object_class,
+                                                 const char *property,
+                                                 guint threshold);
+
+void nm_properties_changed_signal_install_info (GObjectClass *object_class,
+                                                const DBusGObjectInfo *info);
+
+GHashTable *nm_properties_changed_signal_get_all (GObject *object);
+
+void nm_properties_changed_signal_cache_get_all (GObjectClass *object_class,
+                                                 const char *dbus_interface);
+void nm_properties_changed_signal_invalidate_get_all (GObject *object);
+
+gboolean nm_properties_changed_signal_add_get_all_filter    (DBusGConnection *bus);
+void     nm_properties_changed_signal_remove_get_all_filter (DBusGConnection *bus);
+
 #endif /* _NM_PROPERTIES_CHANGED_SIGNAL_H_ */
@@ -0,0 +1,539 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2012 Red Hat, Inc.
+ */
+
+#include <string.h>
+
+#include "nm-wifi-ap-table.h"
+
+typedef struct {
+	gpointer item;
+	GList *link;
+
+	/* Position in the list; smaller is closer to the front */
+	gint64 order;
+
+	char *dbus_path;
+	char *supplicant_path;
+	struct ether_addr bssid;
+	gboolean bssid_valid;
+
+	glong last_seen;
+	gboolean aging;               /* In the by_last_seen heap */
+	guint heap_idx;
+} Entry;
+
+struct _NMAPTable {
+	GQueue list;
+	gint64 front;
+
+	GHashTable *entries;          /* item -> Entry */
+	GHashTable *by_dbus_path;     /* path -> Entry */
+	GHashTable *by_supplicant_path;
+	GHashTable *by_bssid;         /* BSSID -> GSList of Entry */
+	GHashTable *no_bssid;         /* Entry -> Entry, entries without a valid BSSID */
+	GPtrArray *by_last_seen;      /* Binary min-heap of aging Entry */
+};
+
+static guint
+bssid_hash (gconstpointer key)
+{
+	const guint8 *addr = key;
+	guint h = 5381;
+	int i;
+
+	for (i = 0; i < ETH_ALEN; i++)
+		h = (h << 5) + h + addr[i];
+	return h;
+}
+
+static gboolean
+bssid_equal (gconstpointer a, gconstpointer b)
+{
+	return memcmp (a, b, ETH_ALEN) == 0;
+}
+
+NMAPTable *
+nm_ap_table_new (void)
+{
+	NMAPTable *table;
+
+	table = g_slice_new0 (NMAPTable);
+	g_queue_init (&table->list);
+	table->entries = g_hash_table_new (g_direct_hash, g_direct_equal);
+	table->by_dbus_path = g_hash_table_new (g_str_hash, g_str_equal);
+	table->by_supplicant_path = g_hash_table_new (g_str_hash, g_str_equal);
+	table->by_bssid = g_hash_table_new_full (bssid_hash, bssid_equal, g_free, NULL);
+	table->no_bssid = g_hash_table_new (g_direct_hash, g_direct_equal);
+	table->by_last_seen = g_ptr_array_new ();
+	return table;
+}
+
+/*******************************************************************/
+
+static void
+path_index_add (GHashTable *index, const char *path, Entry *entry)
+{
+	if (path)
+		g_hash_table_insert (index, (gpointer) path, entry);
+}
+
+static void
+path_index_remove (GHashTable *index, const char *path, Entry *entry)
+{
+	/* Another entry may have claimed the path in the meantime */
+	if (path && g_hash_table_lookup (index, path) == entry)
+		g_hash_table_remove (index, path);
+}
+
+static void
+bssid_index_add (NMAPTable *table, Entry *entry)
+{
+	GSList *bucket;
+
+	if (!entry->bssid_valid) {
+		g_hash_table_insert (table->no_bssid, entry, entry);
+		return;
+	}
+
+	bucket = g_hash_table_lookup (table->by_bssid, &entry->bssid);
+	if (bucket)
+		bucket->next = g_slist_prepend (bucket->next, entry);
+	else {
+		g_hash_table_insert (table->by_bssid,
+		                     g_memdup (&entry->bssid, ETH_ALEN),
+		                     g_slist_prepend (NULL, entry));
+	}
+}
+
+static void
+bssid_index_remove (NMAPTable *table, Entry *entry)
+{
+	GSList *bucket, *new_bucket;
+
+	if (!entry->bssid_valid) {
+		g_hash_table_remove (table->no_bssid, entry);
+		return;
+	}
+
+	bucket = g_hash_table_lookup (table->by_bssid, &entry->bssid);
+	new_bucket = g_slist_remove (bucket, entry);
+	if (!new_bucket)
+		g_hash_table_remove (table->by_bssid, &entry->bssid);
+	else if (new_bucket != bucket) {
+		/* Head changed; the hash holds the old head */
+		g_hash_table_insert (table->by_bssid,
+		                     g_memdup (&entry->bssid, ETH_ALEN),
+		                     new_bucket);
+	}
+}
+
+#define HEAP_ENTRY(table, i) ((Entry *) g_ptr_array_index ((table)->by_last_seen, (i)))
+
+static void
+heap_set (NMAPTable *table, guint i, Entry *entry)
+{
+	g_ptr_array_index (table->by_last_seen, i) = entry;
+	entry->heap_idx = i;
+}
+
+static void
+heap_sift_up (NMAPTable *table, guint i)
+{
+	Entry *entry = HEAP_ENTRY (table, i);
+
+	while (i > 0) {
+		guint parent = (i - 1) / 2;
+
+		if (HEAP_ENTRY (table, parent)->last_seen <= entry->last_seen)
+			break;
+		heap_set (table, i, HEAP_ENTRY (table, parent));
+		i = parent;
+	}
+	heap_set (table, i, entry);
+}
+
+static void
+heap_sift_down (NMAPTable *table, guint i)
+{
+	Entry *entry = HEAP_ENTRY (table, i);
+	guint len = table->by_last_seen->len;
+
+	while (2 * i + 1 < len) {
+		guint child = 2 * i + 1;
+
+		if (   child + 1 < len
+		    && HEAP_ENTRY (table, child + 1)->last_seen < HEAP_ENTRY (table, child)->last_seen)
+			child++;
+		if (entry->last_seen <= HEAP_ENTRY (table, child)->last_seen)
+			break;
+		heap_set (table, i, HEAP_ENTRY (table, child));
+		i = child;
+	}
+	heap_set (table, i, entry);
+}
+
+static void
+heap_add (NMAPTable *table, Entry *entry)
+{
+	g_ptr_array_add (table->by_last_seen, entry);
+	entry->heap_idx = table->by_last_seen->len - 1;
+	heap_sift_up (table, entry->heap_idx);
+}
+
+static void
+heap_remove (NMAPTable *table, Entry *entry)
+{
+	guint i = entry->heap_idx;
+	Entry *last;
+
+	last = g_ptr_array_remove_index (table->by_last_seen, table->by_last_seen->len - 1);
+	if (last == entry)
+		return;
+
+	heap_set (table, i, last);
+	heap_sift_up (table, i);
+	heap_sift_down (table, last->heap_idx);
+}
+
+static void
+entry_free (Entry *entry)
+{
+	g_free (entry->dbus_path);
+	g_free (entry->supplicant_path);
+	g_slice_free (Entry, entry);
+}
+
+/*******************************************************************/
+
+guint
+nm_ap_table_size (NMAPTable *table)
+{
+	g_return_val_if_fail (table != NULL, 0);
+
+	return table->list.length;
+}
+
+GList *
+nm_ap_table_get_list (NMAPTable *table)
+{
+	g_return_val_if_fail (table != NULL, NULL);
+
+	return table->list.head;
+}
+
+void
+nm_ap_table_prepend (NMAPTable *table,
+                     gpointer item,
+                     const char *dbus_path,
+                     const char *supplicant_path,
+                     const struct ether_addr *bssid,
+                     gboolean bssid_valid)
+{
+	Entry *entry;
+
+	g_return_if_fail (table != NULL);
+	g_return_if_fail (item != NULL);
+	g_return_if_fail (bssid != NULL);
+	g_return_if_fail (g_hash_table_lookup (table->entries, item) == NULL);
+
+	entry = g_slice_new0 (Entry);
+	entry->item = item;
+	entry->order = --table->front;
+	entry->dbus_path = g_strdup (dbus_path);
+	entry->supplicant_path = g_strdup (supplicant_path);
+	memcpy (&entry->bssid, bssid, sizeof (entry->bssid));
+	entry->bssid_valid = bssid_valid;
+
+	g_queue_push_head (&table->list, item);
+	entry->link = table->list.head;
+
+	g_hash_table_insert (table->entries, item, entry);
+	path_index_add (table->by_dbus_path, entry->dbus_path, entry);
+	path_index_add (table->by_supplicant_path, entry->supplicant_path, entry);
+	bssid_index_add (table, entry);
+	entry->aging = TRUE;
+	heap_add (table, entry);
+}
+
+gboolean
+nm_ap_table_remove (NMAPTable *table, gpointer item)
+{
+	Entry *entry;
+
+	g_return_val_if_fail (table != NULL, FALSE);
+
+	entry = g_hash_table_lookup (table->entries, item);
+	if (!entry)
+		return FALSE;
+
+	g_queue_delete_link (&table->list, entry->link);
+	g_hash_table_remove (table->entries, item);
+	path_index_remove (table->by_dbus_path, entry->dbus_path, entry);
+	path_index_remove (table->by_supplicant_path, entry->supplicant_path, entry);
+	bssid_index_remove (table, entry);
+	if (entry->aging)
+		heap_remove (table, entry);
+	entry_free (entry);
+	return TRUE;
+}
+
+void
+nm_ap_table_move_to_front (NMAPTable *table, gpointer item)
+{
+	Entry *entry;
+
+	g_return_if_fail (table != NULL);
+
+	entry = g_hash_table_lookup (table->entries, item);
+	if (!entry)
+		return;
+
+	g_queue_unlink (&table->list, entry->link);
+	g_queue_push_head_link (&table->list, entry->link);
+	entry->order = --table->front;
+}
+
+void
+nm_ap_table_set_supplicant_path (NMAPTable *table,
+                                 gpointer item,
+                                 const char *supplicant_path)
+{
+	Entry *entry;
+
+	g_return_if_fail (table != NULL);
+
+	entry = g_hash_table_lookup (table->entries, item);
+	if (!entry)
+		return;
+
+	if (g_strcmp0 (entry->supplicant_path, supplicant_path) == 0)
+		return;
+
+	path_index_remove (table->by_supplicant_path, entry->supplicant_path, entry);
+	g_free (entry->supplicant_path);
+	entry->supplicant_path = g_strdup (supplicant_path);
+	path_index_add (table->by_supplicant_path, entry->supplicant_path, entry);
+}
+
+void
+nm_ap_table_set_bssid (NMAPTable *table,
+                       gpointer item,
+                       const struct ether_addr *bssid,
+                       gboolean bssid_valid)
+{
+	Entry *entry;
+
+	g_return_if_fail (table != NULL);
+	g_return_if_fail (bssid != NULL);
+
+	entry = g_hash_table_lookup (table->entries, item);
+	if (!entry)
+		return;
+
+	if (   entry->bssid_valid == !!bssid_valid
+	    && memcmp (&entry->bssid, bssid, sizeof (entry->bssid)) == 0)
+		return;
+
+	bssid_index_remove (table, entry);
+	memcpy (&entry->bssid, bssid, sizeof (entry->bssid));
+	entry->bssid_valid = bssid_valid;
+	bssid_index_add (table, entry);
+}
+
+void
+nm_ap_table_set_last_seen (NMAPTable *table, gpointer item, glong last_seen)
+{
+	Entry *entry;
+
+	g_return_if_fail (table != NULL);
+
+	entry = g_hash_table_lookup (table->entries, item);
+	if (!entry || entry->last_seen == last_seen)
+		return;
+
+	entry->last_seen = last_seen;
+	if (entry->aging) {
+		heap_sift_up (table, entry->heap_idx);
+		heap_sift_down (table, entry->heap_idx);
+	}
+}
+
+void
+nm_ap_table_set_aging (NMAPTable *table, gpointer item, gboolean aging)
+{
+	Entry *entry;
+
+	g_return_if_fail (table != NULL);
+
+	entry = g_hash_table_lookup (table->entries, item);
+	if (!entry || entry->aging == !!aging)
+		return;
+
+	entry->aging = !!aging;
+	if (entry->aging)
+		heap_add (table, entry);
+	else
+		heap_remove (table, entry);
+}
+
+static void
+collect_older (NMAPTable *table, guint i, glong last_seen, GSList **entries)
+{
+	/* Children are never older than their parent, so whole subtrees of
+	 * recent entries are skipped.
+	 */
+	while (i < table->by_last_seen->len && HEAP_ENTRY (table, i)->last_seen < last_seen) {
+		*entries = g_slist_prepend (*entries, HEAP_ENTRY (table, i));
+		collect_older (table, 2 * i + 1, last_seen, entries);
+		i = 2 * i + 2;
+	}
+}
+
+static gint
+entry_cmp_last_seen (gconstpointer a, gconstpointer b)
+{
+	const Entry *ea = a, *eb = b;
+
+	if (ea->last_seen != eb->last_seen)
+		return ea->last_seen < eb->last_seen ? -1 : 1;
+	/* Same age; keep list order */
+	return ea->order < eb->order ? -1 : (ea->order > eb->order);
+}
+
+/*
+ * Returns the aging items last seen before @last_seen, oldest first.  Only
+ * the returned entries and their direct children in the heap are looked at.
+ * The caller frees the list.
+ */
+GSList *
+nm_ap_table_get_older_than (NMAPTable *table, glong last_seen)
+{
+	GSList *entries = NULL, *iter;
+
+	g_return_val_if_fail (table != NULL, NULL);
+
+	collect_older (table, 0, last_seen, &entries);
+	entries = g_slist_sort (entries, entry_cmp_last_seen);
+	for (iter = entries; iter; iter = g_slist_next (iter))
+		iter->data = ((Entry *) iter->data)->item;
+	return entries;
+}
+
+gpointer
+nm_ap_table_lookup_dbus_path (NMAPTable *table, const char *path)
+{
+	Entry *entry;
+
+	g_return_val_if_fail (table != NULL, NULL);
+
+	if (!path)
+		return NULL;
+	entry = g_hash_table_lookup (table->by_dbus_path, path);
+	return entry ? entry->item : NULL;
+}
+
+gpointer
+nm_ap_table_lookup_supplicant_path (NMAPTable *table, const char *path)
+{
+	Entry *entry;
+
+	g_return_val_if_fail (table != NULL, NULL);
+
+	if (!path)
+		return NULL;
+	entry = g_hash_table_lookup (table->by_supplicant_path, path);
+	return entry ? entry->item : NULL;
+}
+
+static Entry *
+match_first (Entry *best, Entry *candidate, NMAPTableMatchFunc func, gpointer user_data)
+{
+	if (best && best->order < candidate->order)
+		return best;
+	return func (candidate->item, user_data) ? candidate : best;
+}
+
+/*
+ * Returns the item closest to the front of the list for which @func returns
+ * TRUE, like walking the list would.  Entries whose BSSID cannot match are
+ * never passed to @func: an entry with a valid BSSID only matches an item
+ * with the same BSSID, or one without a valid BSSID when not matching
+ * strictly.  So only a fuzzy match for an item without a BSSID has to look
+ * at the whole list.
+ */
+gpointer
+nm_ap_table_find (NMAPTable *table,
+                  const struct ether_addr *bssid,
+                  gboolean bssid_valid,
+                  gboolean strict_match,
+                  NMAPTableMatchFunc func,
+                  gpointer user_data)
+{
+	GHashTableIter iter;
+	Entry *best = NULL, *entry;
+	GSList *bucket;
+	GList *elt;
+
+	g_return_val_if_fail (table != NULL, NULL);
+	g_return_val_if_fail (bssid != NULL, NULL);
+	g_return_val_if_fail (func != NULL, NULL);
+
+	if (!bssid_valid && !strict_match) {
+		for (elt = table->list.head; elt; elt = g_list_next (elt)) {
+			if (func (elt->data, user_data))
+				return elt->data;
+		}
+		return NULL;
+	}
+
+	if (bssid_valid) {
+		bucket = g_hash_table_lookup (table->by_bssid, bssid);
+		for (; bucket; bucket = g_slist_next (bucket))
+			best = match_first (best, bucket->data, func, user_data);
+	}
+
+	g_hash_table_iter_init (&iter, table->no_bssid);
+	while (g_hash_table_iter_next (&iter, (gpointer) &entry, NULL))
+		best = match_first (best, entry, func, user_data);
+
+	return best ? best->item : NULL;
+}
+
+void
+nm_ap_table_free (NMAPTable *table)
+{
+	GHashTableIter iter;
+	Entry *entry;
+
+	g_return_if_fail (table != NULL);
+
+	g_hash_table_iter_init (&iter, table->entries);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer) &entry))
+		entry_free (entry);
+
+	g_queue_clear (&table->list);
+	g_hash_table_destroy (table->entries);
+	g_hash_table_destroy (table->by_dbus_path);
+	g_hash_table_destroy (table->by_supplicant_path);
+	g_hash_table_destroy (table->by_bssid);
+	g_hash_table_destroy (table->no_bssid);
+	g_ptr_array_free (table->by_last_seen, TRUE);
+	g_slice_free (NMAPTable, table);
+}
@@ -0,0 +1,88 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2012 Red Hat, Inc.
+ */
+
+#ifndef NM_WIFI_AP_TABLE_H
+#define NM_WIFI_AP_TABLE_H
+
+#include <glib.h>
+#include <net/ethernet.h>
+
+/* An ordered list of access points, indexed by D-Bus path, supplicant path,
+ * BSSID and the time they were last seen.  The table does not reference the
+ * items; the keys are handed in by the owner, who must tell the table when
+ * they change.  New items count as last seen at time 0 until then, and are
+ * aging; only aging items are returned by age.  Updating an item that is not
+ * in the table is a no-op.
+ */
+typedef struct _NMAPTable NMAPTable;
+
+typedef gboolean (*NMAPTableMatchFunc) (gpointer item, gpointer user_data);
+
+NMAPTable *nm_ap_table_new              (void);
+void       nm_ap_table_free             (NMAPTable *table);
+
+guint      nm_ap_table_size             (NMAPTable *table);
+
+/* Items in list order; owned by the table */
+GList *    nm_ap_table_get_list         (NMAPTable *table);
+
+void       nm_ap_table_prepend          (NMAPTable *table,
+                                         gpointer item,
+                                         const char *dbus_path,
+                                         const char *supplicant_path,
+                                         const struct ether_addr *bssid,
+                                         gboolean bssid_valid);
+
+gboolean   nm_ap_table_remove           (NMAPTable *table, gpointer item);
+
+void       nm_ap_table_move_to_front    (NMAPTable *table, gpointer item);
+
+void       nm_ap_table_set_supplicant_path (NMAPTable *table,
+                                            gpointer item,
+                                            const char *supplicant_path);
+
+void       nm_ap_table_set_bssid        (NMAPTable *table,
+                                         gpointer item,
+                                         const struct ether_addr *bssid,
+                                         gboolean bssid_valid);
+
+void       nm_ap_table_set_last_seen    (NMAPTable *table,
+                                         gpointer item,
+                                         glong last_seen);
+
+void       nm_ap_table_set_aging        (NMAPTable *table,
+                                         gpointer item,
+                                         gboolean aging);
+
+/* Aging items last seen before @last_seen, oldest first; free the list only */
+GSList *   nm_ap_table_get_older_than   (NMAPTable *table, glong last_seen);
+
+gpointer   nm_ap_table_lookup_dbus_path (NMAPTable *table, const char *path);
+
+gpointer   nm_ap_table_lookup_supplicant_path (NMAPTable *table, const char *path);
+
+gpointer   nm_ap_table_find             (NMAPTable *table,
+                                         const struct ether_addr *bssid,
+                                         gboolean bssid_valid,
+                                         gboolean strict_match,
+                                         NMAPTableMatchFunc func,
+                                         gpointer user_data);
+
+#endif /* NM_WIFI_AP_TABLE_H */
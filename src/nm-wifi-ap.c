@@ -309,8 +309,12 @@ nm_ap_class_init (NMAccessPointClass *ap_class)
 		nm_properties_changed_signal_new (object_class,
 								    G_STRUCT_OFFSET (NMAccessPointClass, properties_changed));
 
-	dbus_g_object_type_install_info (G_TYPE_FROM_CLASS (ap_class),
-							   &dbus_glib_nm_access_point_object_info);
+	/* Strength changes with every scan; don't flood the bus with them */
+	nm_properties_changed_signal_set_threshold (object_class, NM_AP_STRENGTH, 3);
+	nm_properties_changed_signal_cache_get_all (object_class, NM_DBUS_INTERFACE_ACCESS_POINT);
+
+	nm_properties_changed_signal_install_info (G_OBJECT_CLASS (ap_class),
+	                                           &dbus_glib_nm_access_point_object_info);
 }
 
 void
@@ -1247,73 +1251,95 @@ capabilities_compatible (NM80211ApSecurityFlags a_flags, NM80211ApSecurityFlags
 	return TRUE;
 }
 
-NMAccessPoint *
-nm_ap_match_in_list (NMAccessPoint *find_ap,
-                     GSList *ap_list,
-                     gboolean strict_match)
+typedef struct {
+	NMAccessPoint *find_ap;
+	gboolean strict_match;
+} MatchInfo;
+
+static gboolean
+ap_matches (gpointer item, gpointer user_data)
 {
-	GSList *iter;
+	MatchInfo *info = user_data;
+	NMAccessPoint *list_ap = NM_AP (item);
+	NMAccessPoint *find_ap = info->find_ap;
+	const GByteArray * list_ssid = nm_ap_get_ssid (list_ap);
+	const struct ether_addr * list_addr = nm_ap_get_address (list_ap);
+
+	const GByteArray * find_ssid = nm_ap_get_ssid (find_ap);
+	const struct ether_addr * find_addr = nm_ap_get_address (find_ap);
+
+	/* SSID match; if both APs are hiding their SSIDs,
+	 * let matching continue on BSSID and other properties
+	 */
+	if (   (!list_ssid && find_ssid)
+	    || (list_ssid && !find_ssid)
+	    || !nm_utils_same_ssid (list_ssid, find_ssid, TRUE))
+		return FALSE;
 
-	g_return_val_if_fail (find_ap != NULL, NULL);
+	/* BSSID match */
+	if (   (info->strict_match || nm_ethernet_address_is_valid (find_addr))
+	    && nm_ethernet_address_is_valid (list_addr)
+	    && memcmp (list_addr->ether_addr_octet, 
+	               find_addr->ether_addr_octet,
+	               ETH_ALEN) != 0) {
+		return FALSE;
+	}
 
-	for (iter = ap_list; iter; iter = g_slist_next (iter)) {
-		NMAccessPoint * list_ap = NM_AP (iter->data);
-		const GByteArray * list_ssid = nm_ap_get_ssid (list_ap);
-		const struct ether_addr * list_addr = nm_ap_get_address (list_ap);
+	/* mode match */
+	if (nm_ap_get_mode (list_ap) != nm_ap_get_mode (find_ap))
+		return FALSE;
 
-		const GByteArray * find_ssid = nm_ap_get_ssid (find_ap);
-		const struct ether_addr * find_addr = nm_ap_get_address (find_ap);
+	/* Frequency match */
+	if (nm_ap_get_freq (list_ap) != nm_ap_get_freq (find_ap))
+		return FALSE;
 
-		/* SSID match; if both APs are hiding their SSIDs,
-		 * let matching continue on BSSID and other properties
-		 */
-		if (   (!list_ssid && find_ssid)
-		    || (list_ssid && !find_ssid)
-		    || !nm_utils_same_ssid (list_ssid, find_ssid, TRUE))
-			continue;
-
-		/* BSSID match */
-		if (   (strict_match || nm_ethernet_address_is_valid (find_addr))
-		    && nm_ethernet_address_is_valid (list_addr)
-		    && memcmp (list_addr->ether_addr_octet, 
-		               find_addr->ether_addr_octet,
-		               ETH_ALEN) != 0) {
-			continue;
-		}
+	/* AP flags */
+	if (nm_ap_get_flags (list_ap) != nm_ap_get_flags (find_ap))
+		return FALSE;
 
-		/* mode match */
-		if (nm_ap_get_mode (list_ap) != nm_ap_get_mode (find_ap))
-			continue;
-
-		/* Frequency match */
-		if (nm_ap_get_freq (list_ap) != nm_ap_get_freq (find_ap))
-			continue;
-
-		/* AP flags */
-		if (nm_ap_get_flags (list_ap) != nm_ap_get_flags (find_ap))
-			continue;
-
-		if (strict_match) {
-			if (nm_ap_get_wpa_flags (list_ap) != nm_ap_get_wpa_flags (find_ap))
-				continue;
-
-			if (nm_ap_get_rsn_flags (list_ap) != nm_ap_get_rsn_flags (find_ap))
-				continue;
-		} else {
-			NM80211ApSecurityFlags list_wpa_flags = nm_ap_get_wpa_flags (list_ap);
-			NM80211ApSecurityFlags find_wpa_flags = nm_ap_get_wpa_flags (find_ap);
-			NM80211ApSecurityFlags list_rsn_flags = nm_ap_get_rsn_flags (list_ap);
-			NM80211ApSecurityFlags find_rsn_flags = nm_ap_get_rsn_flags (find_ap);
-
-			/* Just ensure that there is overlap in the capabilities */
-			if (   !capabilities_compatible (list_wpa_flags, find_wpa_flags)
-			    && !capabilities_compatible (list_rsn_flags, find_rsn_flags))
-				continue;
-		}
+	if (info->strict_match) {
+		if (nm_ap_get_wpa_flags (list_ap) != nm_ap_get_wpa_flags (find_ap))
+			return FALSE;
 
-		return list_ap;
+		if (nm_ap_get_rsn_flags (list_ap) != nm_ap_get_rsn_flags (find_ap))
+			return FALSE;
+	} else {
+		NM80211ApSecurityFlags list_wpa_flags = nm_ap_get_wpa_flags (list_ap);
+		NM80211ApSecurityFlags find_wpa_flags = nm_ap_get_wpa_flags (find_ap);
+		NM80211ApSecurityFlags list_rsn_flags = nm_ap_get_rsn_flags (list_ap);
+		NM80211ApSecurityFlags find_rsn_flags = nm_ap_get_rsn_flags (find_ap);
+
+		/* Just ensure that there is overlap in the capabilities */
+		if (   !capabilities_compatible (list_wpa_flags, find_wpa_flags)
+		    && !capabilities_compatible (list_rsn_flags, find_rsn_flags))
+			return FALSE;
 	}
 
-	return NULL;
+	return TRUE;
 }
 
+/* Returns the first AP in @table that matches @find_ap; only APs whose BSSID
+ * can match are compared, see nm_ap_table_find().
+ */
+NMAccessPoint *
+nm_ap_match_in_table (NMAccessPoint *find_ap,
+                      NMAPTable *table,
+                      gboolean strict_match)
+{
+	const struct ether_addr *find_addr;
+	MatchInfo info;
+
+	g_return_val_if_fail (find_ap != NULL, NULL);
+	g_return_val_if_fail (table != NULL, NULL);
+
+	info.find_ap = find_ap;
+	info.strict_match = strict_match;
+
+	find_addr = nm_ap_get_address (find_ap);
+	return nm_ap_table_find (table,
+	                         find_addr,
+	                         nm_ethernet_address_is_valid (find_addr),
+	                         strict_match,
+	                         ap_matches,
+	                         &info);
+}
@@ -26,6 +26,7 @@
 #include <glib-object.h>
 #include "NetworkManager.h"
 #include "nm-connection.h"
+#include "nm-wifi-ap-table.h"
 
 #define NM_TYPE_AP            (nm_ap_get_type ())
 #define NM_AP(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), NM_TYPE_AP, NMAccessPoint))
@@ -114,9 +115,9 @@ gboolean            nm_ap_complete_connection (NMAccessPoint *self,
                                                gboolean lock_bssid,
                                                GError **error);
 
-NMAccessPoint *     nm_ap_match_in_list (NMAccessPoint *find_ap,
-                                         GSList *ap_list,
-                                         gboolean strict_match);
+NMAccessPoint *     nm_ap_match_in_table (NMAccessPoint *find_ap,
+                                          NMAPTable *table,
+                                          gboolean strict_match);
 
 void				nm_ap_dump (NMAccessPoint *ap, const char *prefix);
 
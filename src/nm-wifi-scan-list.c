@@ -0,0 +1,137 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2012 Red Hat, Inc.
+ */
+
+#include "nm-wifi-scan-list.h"
+
+/* APs the supplicant still knows about and the ones the owner keeps are
+ * never culled, so they stay out of the table's age index until that changes.
+ */
+static gboolean
+is_aging (gpointer item,
+          const NMWifiScanListKeys *keys,
+          const NMWifiScanListFuncs *funcs,
+          gpointer user_data)
+{
+	if (keys->in_supplicant)
+		return FALSE;
+	return !(funcs->keep && funcs->keep (item, user_data));
+}
+
+void
+nm_wifi_scan_list_add (NMAPTable *table,
+                       gpointer item,
+                       const NMWifiScanListFuncs *funcs,
+                       gpointer user_data)
+{
+	NMWifiScanListKeys keys;
+
+	g_return_if_fail (table != NULL);
+	g_return_if_fail (funcs != NULL);
+
+	funcs->get_keys (item, &keys);
+	nm_ap_table_prepend (table,
+	                     item,
+	                     keys.dbus_path,
+	                     keys.supplicant_path,
+	                     keys.bssid,
+	                     keys.bssid_valid);
+	nm_ap_table_set_last_seen (table, item, keys.last_seen);
+	nm_ap_table_set_aging (table, item, is_aging (item, &keys, funcs, user_data));
+}
+
+void
+nm_wifi_scan_list_sync (NMAPTable *table,
+                        gpointer item,
+                        const NMWifiScanListFuncs *funcs,
+                        gpointer user_data)
+{
+	NMWifiScanListKeys keys;
+
+	g_return_if_fail (table != NULL);
+	g_return_if_fail (funcs != NULL);
+
+	funcs->get_keys (item, &keys);
+	nm_ap_table_set_supplicant_path (table, item, keys.supplicant_path);
+	nm_ap_table_set_bssid (table, item, keys.bssid, keys.bssid_valid);
+	nm_ap_table_set_last_seen (table, item, keys.last_seen);
+	nm_ap_table_set_aging (table, item, is_aging (item, &keys, funcs, user_data));
+}
+
+gpointer
+nm_wifi_scan_list_merge (NMAPTable *table,
+                         gpointer scanned,
+                         gboolean strict_match,
+                         const NMWifiScanListFuncs *funcs,
+                         gpointer user_data)
+{
+	NMWifiScanListKeys keys;
+	gpointer found;
+
+	g_return_val_if_fail (table != NULL, NULL);
+	g_return_val_if_fail (funcs != NULL, NULL);
+
+	funcs->get_keys (scanned, &keys);
+	found = nm_ap_table_lookup_supplicant_path (table, keys.supplicant_path);
+	if (!found)
+		found = funcs->find (table, scanned, strict_match);
+	if (!found)
+		return NULL;
+
+	funcs->update (found, scanned, user_data);
+	nm_wifi_scan_list_sync (table, found, funcs, user_data);
+	return found;
+}
+
+guint
+nm_wifi_scan_list_cull (NMAPTable *table,
+                        glong last_seen,
+                        const NMWifiScanListFuncs *funcs,
+                        gpointer user_data)
+{
+	NMWifiScanListKeys keys;
+	GSList *outdated, *iter;
+	guint removed = 0;
+
+	g_return_val_if_fail (table != NULL, 0);
+	g_return_val_if_fail (funcs != NULL, 0);
+
+	/* Only look at the access points not seen since @last_seen */
+	outdated = nm_ap_table_get_older_than (table, last_seen);
+	for (iter = outdated; iter; iter = g_slist_next (iter)) {
+		/* Since the supplicant doesn't yet emit property updates for "last
+		 * seen" we have to rely on changing signal strength for updating it.
+		 * But if the AP's strength doesn't change we won't get any updates
+		 * for the AP, even if the supplicant found it in the last scan.
+		 * Such APs, and kept ones, are not aging and shouldn't be here; if
+		 * the owner didn't sync them, take them out now.
+		 */
+		funcs->get_keys (iter->data, &keys);
+		if (!is_aging (iter->data, &keys, funcs, user_data)) {
+			nm_ap_table_set_aging (table, iter->data, FALSE);
+			continue;
+		}
+
+		funcs->remove (iter->data, user_data);
+		removed++;
+	}
+	g_slist_free (outdated);
+
+	return removed;
+}
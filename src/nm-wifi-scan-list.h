@@ -0,0 +1,93 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/* NetworkManager -- Network link manager
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2012 Red Hat, Inc.
+ */
+
+#ifndef NM_WIFI_SCAN_LIST_H
+#define NM_WIFI_SCAN_LIST_H
+
+#include <glib.h>
+
+#include "nm-wifi-ap-table.h"
+
+/* Merging scan results into, and culling outdated access points from, a
+ * scan list kept in an NMAPTable.  The items are the owner's access points;
+ * the owner describes them through NMWifiScanListFuncs, and the table's keys
+ * are kept in sync with what get_keys() returns.
+ */
+
+typedef struct {
+	const char *dbus_path;
+	const char *supplicant_path;
+	const struct ether_addr *bssid;
+	gboolean bssid_valid;
+	glong last_seen;
+
+	/* Known to the supplicant and not removed by it; never culled */
+	gboolean in_supplicant;
+} NMWifiScanListKeys;
+
+typedef struct {
+	/* Strings and the BSSID are owned by @item */
+	void     (*get_keys) (gpointer item, NMWifiScanListKeys *keys);
+
+	/* The item in @table that @scanned matches, if any; called when no item
+	 * has the scan result's supplicant path.
+	 */
+	gpointer (*find)     (NMAPTable *table, gpointer scanned, gboolean strict_match);
+
+	/* Copies the scan result @scanned into the known @item */
+	void     (*update)   (gpointer item, gpointer scanned, gpointer user_data);
+
+	/* Whether @item must never be culled, like the current AP; may be
+	 * NULL.  Kept items are left out of the table's age index, so the
+	 * owner must sync an item when this changes for it.
+	 */
+	gboolean (*keep)     (gpointer item, gpointer user_data);
+
+	/* Removes an outdated @item from the table and drops it */
+	void     (*remove)   (gpointer item, gpointer user_data);
+} NMWifiScanListFuncs;
+
+void     nm_wifi_scan_list_add   (NMAPTable *table,
+                                  gpointer item,
+                                  const NMWifiScanListFuncs *funcs,
+                                  gpointer user_data);
+
+/* Call after changing any of @item's keys, or whether it is kept */
+void     nm_wifi_scan_list_sync  (NMAPTable *table,
+                                  gpointer item,
+                                  const NMWifiScanListFuncs *funcs,
+                                  gpointer user_data);
+
+/* Returns the known item @scanned was merged into, or NULL if it is new and
+ * has to be added by the caller.
+ */
+gpointer nm_wifi_scan_list_merge (NMAPTable *table,
+                                  gpointer scanned,
+                                  gboolean strict_match,
+                                  const NMWifiScanListFuncs *funcs,
+                                  gpointer user_data);
+
+/* Removes the items last seen before @last_seen; returns how many */
+guint    nm_wifi_scan_list_cull  (NMAPTable *table,
+                                  glong last_seen,
+                                  const NMWifiScanListFuncs *funcs,
+                                  gpointer user_data);
+
+#endif /* NM_WIFI_SCAN_LIST_H */
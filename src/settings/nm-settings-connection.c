@@ -76,6 +76,7 @@ enum {
 	UPDATED,
 	REMOVED,
 	UNREGISTER,
+	SEEN_BSSID_ADDED,
 	LAST_SIGNAL
 };
 static guint signals[LAST_SIGNAL] = { 0 };
@@ -1048,6 +1049,64 @@ check_writable (NMConnection *connection, GError **error)
 	return TRUE;
 }
 
+/**
+ * nm_settings_connection_get_settings_hash:
+ * @self: the #NMSettingsConnection
+ *
+ * Returns the connection's settings as they are sent to D-Bus clients by
+ * GetSettings, with the real timestamp and seen BSSIDs filled in and without
+ * any secrets.
+ *
+ * Returns: a new settings hash; free with g_hash_table_destroy()
+ **/
+GHashTable *
+nm_settings_connection_get_settings_hash (NMSettingsConnection *self)
+{
+	GHashTable *settings;
+	NMConnection *dupl_con;
+	NMSettingConnection *s_con;
+	NMSettingWireless *s_wifi;
+	guint64 timestamp = 0;
+	GSList *bssid_list;
+
+	g_return_val_if_fail (NM_IS_SETTINGS_CONNECTION (self), NULL);
+
+	dupl_con = nm_connection_duplicate (NM_CONNECTION (self));
+	g_assert (dupl_con);
+
+	/* Timestamp is not updated in connection's 'timestamp' property,
+	 * because it would force updating the connection and in turn
+	 * writing to /etc periodically, which we want to avoid. Rather real
+	 * timestamps are kept track of in a private variable. So, substitute
+	 * timestamp property with the real one here before returning the settings.
+	 */
+	nm_settings_connection_get_timestamp (self, &timestamp);
+	if (timestamp) {
+		s_con = nm_connection_get_setting_connection (NM_CONNECTION (dupl_con));
+		g_assert (s_con);
+		g_object_set (s_con, NM_SETTING_CONNECTION_TIMESTAMP, timestamp, NULL);
+	}
+	/* Seen BSSIDs are not updated in 802-11-wireless 'seen-bssids' property
+	 * from the same reason as timestamp. Thus we put it here to GetSettings()
+	 * return settings too.
+	 */
+	bssid_list = nm_settings_connection_get_seen_bssids (self);
+	s_wifi = nm_connection_get_setting_wireless (NM_CONNECTION (dupl_con));
+	if (bssid_list && s_wifi) {
+		g_object_set (s_wifi, NM_SETTING_WIRELESS_SEEN_BSSIDS, bssid_list, NULL);
+		nm_utils_slist_free (bssid_list, g_free);
+	}
+
+	/* Secrets should *never* be returned by the GetSettings method, they
+	 * get returned by the GetSecrets method which can be better
+	 * protected against leakage of secrets to unprivileged callers.
+	 */
+	settings = nm_connection_to_hash (NM_CONNECTION (dupl_con), NM_SETTING_HASH_FLAG_NO_SECRETS);
+	g_assert (settings);
+	g_object_unref (dupl_con);
+	return settings;
+}
+
 static void
 get_settings_auth_cb (NMSettingsConnection *self, 
                       DBusGMethodInvocation *context,
@@ -1059,47 +1118,10 @@ get_settings_auth_cb (NMSettingsConnection *self,
 		dbus_g_method_return_error (context, error);
 	else {
 		GHashTable *settings;
-		NMConnection *dupl_con;
-		NMSettingConnection *s_con;
-		NMSettingWireless *s_wifi;
-		guint64 timestamp = 0;
-		GSList *bssid_list;
-
-		dupl_con = nm_connection_duplicate (NM_CONNECTION (self));
-		g_assert (dupl_con);
-
-		/* Timestamp is not updated in connection's 'timestamp' property,
-		 * because it would force updating the connection and in turn
-		 * writing to /etc periodically, which we want to avoid. Rather real
-		 * timestamps are kept track of in a private variable. So, substitute
-		 * timestamp property with the real one here before returning the settings.
-		 */
-		nm_settings_connection_get_timestamp (self, &timestamp);
-		if (timestamp) {
-			s_con = nm_connection_get_setting_connection (NM_CONNECTION (dupl_con));
-			g_assert (s_con);
-			g_object_set (s_con, NM_SETTING_CONNECTION_TIMESTAMP, timestamp, NULL);
-		}
-		/* Seen BSSIDs are not updated in 802-11-wireless 'seen-bssids' property
-		 * from the same reason as timestamp. Thus we put it here to GetSettings()
-		 * return settings too.
-		 */
-		bssid_list = nm_settings_connection_get_seen_bssids (self);
-		s_wifi = nm_connection_get_setting_wireless (NM_CONNECTION (dupl_con));
-		if (bssid_list && s_wifi) {
-			g_object_set (s_wifi, NM_SETTING_WIRELESS_SEEN_BSSIDS, bssid_list, NULL);
-			nm_utils_slist_free (bssid_list, g_free);
-		}
 
-		/* Secrets should *never* be returned by the GetSettings method, they
-		 * get returned by the GetSecrets method which can be better
-		 * protected against leakage of secrets to unprivileged callers.
-		 */
-		settings = nm_connection_to_hash (NM_CONNECTION (dupl_con), NM_SETTING_HASH_FLAG_NO_SECRETS);
-		g_assert (settings);
+		settings = nm_settings_connection_get_settings_hash (self);
 		dbus_g_method_return (context, settings);
 		g_hash_table_destroy (settings);
-		g_object_unref (dupl_con);
 	}
 }
 
@@ -1631,6 +1653,7 @@ nm_settings_connection_add_seen_bssid (NMSettingsConnection *connection,
 	bssid_str = nm_utils_hwaddr_ntoa (seen_bssid, ARPHRD_ETHER);
 	g_return_if_fail (bssid_str != NULL);
 	g_hash_table_insert (priv->seen_bssids, mac_dup (seen_bssid), bssid_str);
+	g_signal_emit (connection, signals[SEEN_BSSID_ADDED], 0, seen_bssid);
 
 	/* Build up a list of all the BSSIDs in string form */
 	n = 0;
@@ -1873,6 +1896,16 @@ nm_settings_connection_class_init (NMSettingsConnectionClass *class)
 		              g_cclosure_marshal_VOID__VOID,
 		              G_TYPE_NONE, 0);
 
+	/* Not exported */
+	signals[SEEN_BSSID_ADDED] =
+		g_signal_new (NM_SETTINGS_CONNECTION_SEEN_BSSID_ADDED,
+		              G_TYPE_FROM_CLASS (class),
+		              G_SIGNAL_RUN_FIRST,
+		              0,
+		              NULL, NULL,
+		              g_cclosure_marshal_VOID__POINTER,
+		              G_TYPE_NONE, 1, G_TYPE_POINTER);
+
 	dbus_g_object_type_install_info (G_TYPE_FROM_CLASS (class),
 	                                 &dbus_glib_nm_settings_connection_object_info);
 }
@@ -37,6 +37,7 @@ G_BEGIN_DECLS
 
 #define NM_SETTINGS_CONNECTION_UPDATED "updated"
 #define NM_SETTINGS_CONNECTION_REMOVED "removed"
+#define NM_SETTINGS_CONNECTION_SEEN_BSSID_ADDED "seen-bssid-added"
 #define NM_SETTINGS_CONNECTION_GET_SECRETS "get-secrets"
 #define NM_SETTINGS_CONNECTION_CANCEL_SECRETS "cancel-secrets"
 
@@ -113,6 +114,8 @@ guint32 nm_settings_connection_get_secrets (NMSettingsConnection *connection,
 void nm_settings_connection_cancel_secrets (NMSettingsConnection *connection,
                                             guint32 call_id);
 
+GHashTable *nm_settings_connection_get_settings_hash (NMSettingsConnection *self);
+
 gboolean nm_settings_connection_is_visible (NMSettingsConnection *self);
 
 void nm_settings_connection_recheck_visibility (NMSettingsConnection *self);
@@ -29,6 +29,7 @@
 #include <string.h>
 #include <gmodule.h>
 #include <net/if_arp.h>
+#include <netinet/ether.h>
 #include <pwd.h>
 #include <dbus/dbus.h>
 #include <dbus/dbus-glib-lowlevel.h>
@@ -94,6 +95,11 @@ static gboolean impl_settings_list_connections (NMSettings *self,
                                                 GPtrArray **connections,
                                                 GError **error);
 
+static void impl_settings_get_all_settings (NMSettings *self,
+                                            const char *after,
+                                            guint limit,
+                                            DBusGMethodInvocation *context);
+
 static gboolean impl_settings_get_connection_by_uuid (NMSettings *self,
                                                       const char *uuid,
                                                       char **out_object_path,
@@ -132,6 +138,9 @@ typedef struct {
 	gboolean connections_loaded;
 	GHashTable *connections;
 	GSList *unmanaged_specs;
+
+	/* BSSID -> NMSettingsConnection that saw it; not referenced */
+	GHashTable *seen_bssids;
 } NMSettingsPrivate;
 
 #define NM_SETTINGS_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), NM_TYPE_SETTINGS, NMSettingsPrivate))
@@ -234,6 +243,95 @@ impl_settings_list_connections (NMSettings *self,
 	return TRUE;
 }
 
+/* Connection paths only differ in their counter suffix; ordering by length
+ * first sorts them numerically, so new connections come after all others.
+ */
+static int
+path_cmp (const char *a, const char *b)
+{
+	size_t la = strlen (a), lb = strlen (b);
+
+	if (la != lb)
+		return la < lb ? -1 : 1;
+	return strcmp (a, b);
+}
+
+static int
+path_sort (gconstpointer a, gconstpointer b)
+{
+	return path_cmp (*(const char **) a, *(const char **) b);
+}
+
+static void
+impl_settings_get_all_settings (NMSettings *self,
+                                const char *after,
+                                guint limit,
+                                DBusGMethodInvocation *context)
+{
+	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
+	GHashTable *all_settings;
+	GPtrArray *paths;
+	GHashTableIter iter;
+	gpointer key;
+	gulong sender_uid = G_MAXULONG;
+	char *error_desc = NULL;
+	GError *error;
+	const char *cursor = "";
+	guint i, n = 0;
+
+	if (!nm_auth_get_caller_uid (context, priv->dbus_mgr, &sender_uid, &error_desc)) {
+		error = g_error_new_literal (NM_SETTINGS_ERROR,
+		                             NM_SETTINGS_ERROR_PERMISSION_DENIED,
+		                             error_desc);
+		dbus_g_method_return_error (context, error);
+		g_error_free (error);
+		g_free (error_desc);
+		return;
+	}
+
+	load_connections (self);
+
+	/* Page through the connections after the cursor in path order, which
+	 * is unaffected by connections coming and going between calls.
+	 */
+	paths = g_ptr_array_sized_new (g_hash_table_size (priv->connections));
+	g_hash_table_iter_init (&iter, priv->connections);
+	while (g_hash_table_iter_next (&iter, &key, NULL)) {
+		if (!after || !*after || path_cmp (key, after) > 0)
+			g_ptr_array_add (paths, key);
+	}
+	g_ptr_array_sort (paths, path_sort);
+
+	n = paths->len;
+	if (limit && limit < n) {
+		n = limit;
+		cursor = g_ptr_array_index (paths, n - 1);
+	}
+
+	all_settings = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+	                                      (GDestroyNotify) g_hash_table_destroy);
+	for (i = 0; i < n; i++) {
+		const char *path = g_ptr_array_index (paths, i);
+		NMSettingsConnection *connection = g_hash_table_lookup (priv->connections, path);
+		GHashTable *settings;
+
+		/* Same visibility rules as GetSettings; connections the caller can't
+		 * see are returned empty.
+		 */
+		if (   sender_uid == 0
+		    || nm_auth_uid_in_acl (NM_CONNECTION (connection), priv->session_monitor, sender_uid, NULL))
+			settings = nm_settings_connection_get_settings_hash (connection);
+		else
+			settings = g_hash_table_new (g_str_hash, g_str_equal);
+		g_hash_table_insert (all_settings, (gpointer) path, settings);
+	}
+
+	dbus_g_method_return (context, all_settings, cursor);
+
+	g_hash_table_destroy (all_settings);
+	g_ptr_array_free (paths, TRUE);
+}
+
 NMSettingsConnection *
 nm_settings_get_connection_by_uuid (NMSettings *self, const char *uuid)
 {
@@ -258,6 +356,19 @@ nm_settings_get_connection_by_uuid (NMSettings *self, const char *uuid)
 	return NULL;
 }
 
+NMSettingsConnection *
+nm_settings_get_connection_by_seen_bssid (NMSettings *self,
+                                          const struct ether_addr *bssid)
+{
+	g_return_val_if_fail (self != NULL, NULL);
+	g_return_val_if_fail (NM_IS_SETTINGS (self), NULL);
+	g_return_val_if_fail (bssid != NULL, NULL);
+
+	load_connections (self);
+
+	return g_hash_table_lookup (NM_SETTINGS_GET_PRIVATE (self)->seen_bssids, bssid);
+}
+
 static gboolean
 impl_settings_get_connection_by_uuid (NMSettings *self,
                                       const char *uuid,
@@ -669,6 +780,90 @@ load_plugins (NMSettings *self, const char **plugins, GError **error)
 #define UPDATED_ID_TAG "updated-id-tag"
 #define VISIBLE_ID_TAG "visible-id-tag"
 #define UNREG_ID_TAG "unreg-id-tag"
+#define SEEN_BSSID_ID_TAG "seen-bssid-id-tag"
+
+static guint
+bssid_hash (gconstpointer v)
+{
+	const guint8 *p = v;
+	guint32 i, h = 5381;
+
+	for (i = 0; i < ETH_ALEN; i++)
+		h = (h << 5) + h + p[i];
+	return h;
+}
+
+static gboolean
+bssid_equal (gconstpointer a, gconstpointer b)
+{
+	return memcmp (a, b, ETH_ALEN) == 0;
+}
+
+static void
+index_seen_bssid (NMSettings *self,
+                  NMSettingsConnection *connection,
+                  const struct ether_addr *bssid)
+{
+	/* The connection that saw the BSSID last wins */
+	g_hash_table_insert (NM_SETTINGS_GET_PRIVATE (self)->seen_bssids,
+	                     g_memdup (bssid, ETH_ALEN),
+	                     connection);
+}
+
+static void
+index_connection_seen_bssids (NMSettings *self, NMSettingsConnection *connection)
+{
+	GSList *bssids, *iter;
+	struct ether_addr bssid;
+
+	bssids = nm_settings_connection_get_seen_bssids (connection);
+	for (iter = bssids; iter; iter = g_slist_next (iter)) {
+		if (ether_aton_r (iter->data, &bssid))
+			index_seen_bssid (self, connection, &bssid);
+	}
+	g_slist_foreach (bssids, (GFunc) g_free, NULL);
+	g_slist_free (bssids);
+}
+
+static void
+unindex_connection_seen_bssids (NMSettings *self, NMSettingsConnection *connection)
+{
+	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
+	GSList *bssids, *iter;
+	struct ether_addr bssid;
+	GHashTableIter citer;
+	NMSettingsConnection *candidate;
+
+	bssids = nm_settings_connection_get_seen_bssids (connection);
+	for (iter = bssids; iter; iter = g_slist_next (iter)) {
+		if (!ether_aton_r (iter->data, &bssid))
+			continue;
+		if (g_hash_table_lookup (priv->seen_bssids, &bssid) != connection)
+			continue;
+
+		g_hash_table_remove (priv->seen_bssids, &bssid);
+
+		/* Hand the BSSID over to any other connection that saw it too */
+		g_hash_table_iter_init (&citer, priv->connections);
+		while (g_hash_table_iter_next (&citer, NULL, (gpointer) &candidate)) {
+			if (   candidate != connection
+			    && nm_settings_connection_has_seen_bssid (candidate, &bssid)) {
+				index_seen_bssid (self, candidate, &bssid);
+				break;
+			}
+		}
+	}
+	g_slist_foreach (bssids, (GFunc) g_free, NULL);
+	g_slist_free (bssids);
+}
+
+static void
+connection_seen_bssid_added (NMSettingsConnection *connection,
+                             const struct ether_addr *bssid,
+                             gpointer user_data)
+{
+	index_seen_bssid (NM_SETTINGS (user_data), connection, bssid);
+}
 
 static void
 connection_removed (NMSettingsConnection *obj, gpointer user_data)
@@ -695,9 +890,14 @@ connection_removed (NMSettingsConnection *obj, gpointer user_data)
 	if (id)
 		g_signal_handler_disconnect (connection, id);
 
+	id = GPOINTER_TO_UINT (g_object_get_data (connection, SEEN_BSSID_ID_TAG));
+	if (id)
+		g_signal_handler_disconnect (connection, id);
+
 	/* Forget about the connection internally */
 	g_hash_table_remove (NM_SETTINGS_GET_PRIVATE (user_data)->connections,
 	                     (gpointer) nm_connection_get_path (NM_CONNECTION (connection)));
+	unindex_connection_seen_bssids (NM_SETTINGS (user_data), obj);
 
 	/* Re-emit for listeners like NMPolicy */
 	g_signal_emit (NM_SETTINGS (user_data), signals[CONNECTION_REMOVED], 0, connection);
@@ -859,6 +1059,12 @@ claim_connection (NMSettings *self,
 	                       self);
 	g_object_set_data (G_OBJECT (connection), VISIBLE_ID_TAG, GUINT_TO_POINTER (id));
 
+	id = g_signal_connect (connection, NM_SETTINGS_CONNECTION_SEEN_BSSID_ADDED,
+	                       G_CALLBACK (connection_seen_bssid_added),
+	                       self);
+	g_object_set_data (G_OBJECT (connection), SEEN_BSSID_ID_TAG, GUINT_TO_POINTER (id));
+	index_connection_seen_bssids (self, connection);
+
 	/* Export the connection over D-Bus */
 	g_warn_if_fail (nm_connection_get_path (NM_CONNECTION (connection)) == NULL);
 	path = g_strdup_printf ("%s/%u", NM_DBUS_PATH_SETTINGS, ec_counter++);
@@ -1795,6 +2001,7 @@ nm_settings_init (NMSettings *self)
 	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
 
 	priv->connections = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_object_unref);
+	priv->seen_bssids = g_hash_table_new_full (bssid_hash, bssid_equal, g_free, NULL);
 
 	priv->session_monitor = nm_session_monitor_get ();
 
@@ -1834,6 +2041,7 @@ finalize (GObject *object)
 	NMSettingsPrivate *priv = NM_SETTINGS_GET_PRIVATE (self);
 
 	g_hash_table_destroy (priv->connections);
+	g_hash_table_destroy (priv->seen_bssids);
 
 	clear_unmanaged_specs (self);
 
@@ -111,6 +111,10 @@ NMSettingsConnection *nm_settings_get_connection_by_path (NMSettings *settings,
 NMSettingsConnection *nm_settings_get_connection_by_uuid (NMSettings *settings,
                                                           const char *uuid);
 
+/* Returns the connection that last saw @bssid, if any */
+NMSettingsConnection *nm_settings_get_connection_by_seen_bssid (NMSettings *settings,
+                                                                const struct ether_addr *bssid);
+
 const GSList *nm_settings_get_unmanaged_specs (NMSettings *self);
 
 char *nm_settings_get_hostname (NMSettings *self);
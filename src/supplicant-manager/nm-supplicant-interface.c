@@ -39,6 +39,14 @@
 #define WPAS_DBUS_IFACE_NETWORK	    WPAS_DBUS_INTERFACE ".Network"
 #define WPAS_ERROR_INVALID_IFACE    WPAS_DBUS_INTERFACE ".InvalidInterface"
 #define WPAS_ERROR_EXISTS_ERROR     WPAS_DBUS_INTERFACE ".InterfaceExists"
+#define WPAS_ERROR_INVALID_ARGS     WPAS_DBUS_INTERFACE ".InvalidArgs"
+
+/* Scan "Channels" argument: array of (center frequency, width) in MHz */
+#define DBUS_TYPE_G_UINT_STRUCT          (dbus_g_type_get_struct ("GValueArray", G_TYPE_UINT, G_TYPE_UINT, G_TYPE_INVALID))
+#define DBUS_TYPE_G_ARRAY_OF_UINT_STRUCT (dbus_g_type_get_collection ("GPtrArray", DBUS_TYPE_G_UINT_STRUCT))
+
+/* Maximum number of BSS property requests in flight per interface */
+#define BSS_FETCH_MAX_PENDING 16
 
 G_DEFINE_TYPE (NMSupplicantInterface, nm_supplicant_interface, G_TYPE_OBJECT)
 
@@ -52,6 +60,10 @@ static void wpas_iface_scan_done (DBusGProxy *proxy,
 
 static void wpas_iface_get_props (NMSupplicantInterface *self);
 
+static DBusHandlerResult bss_signal_filter (DBusConnection *connection,
+                                            DBusMessage *message,
+                                            void *user_data);
+
 #define NM_SUPPLICANT_INTERFACE_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), \
                                                  NM_TYPE_SUPPLICANT_INTERFACE, \
                                                  NMSupplicantInterfacePrivate))
@@ -89,6 +101,7 @@ typedef struct {
 	ApSupport             ap_support;   /* Lightweight AP mode support */
 	gboolean              fast_supported;
 	guint32               max_scan_ssids;
+	gboolean              scan_channels_unsupported;
 	guint32               ready_count;
 
 	char *                object_path;
@@ -104,7 +117,16 @@ typedef struct {
 	DBusGProxy *          props_proxy;
 	char *                net_path;
 	guint32               blobs_left;
-	GHashTable *          bss_proxies;
+
+	/* All BSS signals are received through one connection filter and match
+	 * rule per interface instead of a pair of proxies per BSS.
+	 */
+	GHashTable *          bss_paths;          /* Known BSS object paths */
+	gboolean              bss_filter_added;
+	GSList *              bss_match_rules;
+	GQueue                bss_fetch_queue;    /* Paths of BSSes without properties yet */
+	GHashTable *          bss_fetch_pending;  /* DBusPendingCall -> NULL */
+	guint                 bss_fetch_id;
 
 	time_t                last_scan;
 
@@ -113,28 +135,6 @@ typedef struct {
 	gboolean              disposed;
 } NMSupplicantInterfacePrivate;
 
-/* FIXME: remove this and just store the standard D-Bus properties
- * proxy object in bss_proxies when we drop support for wpa_supplicant
- * 0.7.x.
- */
-typedef struct {
-	/* Proxy for standard D-Bus Properties interface */
-	DBusGProxy *props;
-	/* Proxy for old wpa_supplicant-specific PropertiesChanged signal */
-	DBusGProxy *old_props;
-} BssProxies;
-
-static void
-bss_proxies_free (gpointer data)
-{
-	BssProxies *proxies = data;
-
-	g_object_unref (proxies->props);
-	g_object_unref (proxies->old_props);
-	memset (proxies, 0, sizeof (*proxies));
-	g_free (proxies);
-}
-
 static gboolean
 cancel_all_cb (GObject *object, gpointer call_id, gpointer user_data)
 {
@@ -150,12 +150,42 @@ cancel_all_callbacks (NMCallStore *store)
 	nm_call_store_clear (store);
 }
 
+static GPtrArray *
+ssids_copy (const GPtrArray *ssids)
+{
+	GPtrArray *copy;
+	guint i;
+
+	copy = g_ptr_array_sized_new (ssids->len);
+	for (i = 0; i < ssids->len; i++) {
+		const GByteArray *ssid = g_ptr_array_index (ssids, i);
+		GByteArray *dup = g_byte_array_sized_new (ssid->len);
+
+		g_byte_array_append (dup, ssid->data, ssid->len);
+		g_ptr_array_add (copy, dup);
+	}
+	return copy;
+}
+
+static void
+ssids_free (GPtrArray *ssids)
+{
+	if (ssids) {
+		g_ptr_array_foreach (ssids, (GFunc) g_byte_array_unref, NULL);
+		g_ptr_array_free (ssids, TRUE);
+	}
+}
+
 typedef struct {
 	NMSupplicantInterface *interface;
 	DBusGProxy *proxy;
 	NMCallStore *store;
 	DBusGProxyCall *call;
 	gboolean disposing;
+
+	/* Scan calls: whether restricted to channels, and the SSIDs for a retry */
+	gboolean scan_channels;
+	GPtrArray *scan_ssids;
 } NMSupplicantInfo;
 
 static NMSupplicantInfo *
@@ -208,6 +238,7 @@ nm_supplicant_info_destroy (gpointer user_data)
 		info->proxy = NULL;
 		g_object_unref (info->interface);
 		info->interface = NULL;
+		ssids_free (info->scan_ssids);
 
 		memset (info, 0, sizeof (NMSupplicantInfo));
 		g_slice_free (NMSupplicantInfo, info);
@@ -234,56 +265,481 @@ signal_new_bss (NMSupplicantInterface *self,
 	g_signal_emit (self, signals[NEW_BSS], 0, object_path, props);
 }
 
+/*******************************************************************/
+
 static void
-bssid_properties_cb  (DBusGProxy *proxy, DBusGProxyCall *call_id, gpointer user_data)
+bss_value_destroy (gpointer data)
 {
-	NMSupplicantInfo *info = (NMSupplicantInfo *) user_data;
-	GError *error = NULL;
-	GHashTable *props = NULL;
+	GValue *value = data;
 
-	if (dbus_g_proxy_end_call (proxy, call_id, &error,
-	                           DBUS_TYPE_G_MAP_OF_VARIANT, &props,
-	                           G_TYPE_INVALID)) {
-		signal_new_bss (info->interface, dbus_g_proxy_get_path (proxy), props);
-		g_hash_table_destroy (props);
-	} else {
-		if (!strstr (error->message, "The BSSID requested was invalid")) {
-			nm_log_warn (LOGD_SUPPLICANT, "Couldn't retrieve BSSID properties: %s.",
-			             error->message);
+	g_value_unset (value);
+	g_slice_free (GValue, value);
+}
+
+static GHashTable *demarshal_dict (DBusMessageIter *iter);
+
+/* Converts a D-Bus value to the GValue dbus-glib would have produced for
+ * it.  Only handles the types wpa_supplicant uses for BSS properties.
+ */
+static gboolean
+demarshal_value (DBusMessageIter *iter, GValue *value)
+{
+	DBusMessageIter sub;
+	int type = dbus_message_iter_get_arg_type (iter);
+
+	switch (type) {
+	case DBUS_TYPE_VARIANT:
+		dbus_message_iter_recurse (iter, &sub);
+		return demarshal_value (&sub, value);
+	case DBUS_TYPE_BOOLEAN: {
+		dbus_bool_t v;
+
+		dbus_message_iter_get_basic (iter, &v);
+		g_value_init (value, G_TYPE_BOOLEAN);
+		g_value_set_boolean (value, v);
+		return TRUE;
+	}
+	case DBUS_TYPE_BYTE: {
+		guchar v;
+
+		dbus_message_iter_get_basic (iter, &v);
+		g_value_init (value, G_TYPE_UCHAR);
+		g_value_set_uchar (value, v);
+		return TRUE;
+	}
+	case DBUS_TYPE_INT16: {
+		dbus_int16_t v;
+
+		dbus_message_iter_get_basic (iter, &v);
+		g_value_init (value, G_TYPE_INT);
+		g_value_set_int (value, v);
+		return TRUE;
+	}
+	case DBUS_TYPE_INT32: {
+		dbus_int32_t v;
+
+		dbus_message_iter_get_basic (iter, &v);
+		g_value_init (value, G_TYPE_INT);
+		g_value_set_int (value, v);
+		return TRUE;
+	}
+	case DBUS_TYPE_UINT16: {
+		dbus_uint16_t v;
+
+		dbus_message_iter_get_basic (iter, &v);
+		g_value_init (value, G_TYPE_UINT);
+		g_value_set_uint (value, v);
+		return TRUE;
+	}
+	case DBUS_TYPE_UINT32: {
+		dbus_uint32_t v;
+
+		dbus_message_iter_get_basic (iter, &v);
+		g_value_init (value, G_TYPE_UINT);
+		g_value_set_uint (value, v);
+		return TRUE;
+	}
+	case DBUS_TYPE_STRING: {
+		const char *v;
+
+		dbus_message_iter_get_basic (iter, &v);
+		g_value_init (value, G_TYPE_STRING);
+		g_value_set_string (value, v);
+		return TRUE;
+	}
+	case DBUS_TYPE_OBJECT_PATH: {
+		const char *v;
+
+		dbus_message_iter_get_basic (iter, &v);
+		g_value_init (value, DBUS_TYPE_G_OBJECT_PATH);
+		g_value_set_boxed (value, v);
+		return TRUE;
+	}
+	case DBUS_TYPE_ARRAY:
+		break;
+	default:
+		return FALSE;
+	}
+
+	switch (dbus_message_iter_get_element_type (iter)) {
+	case DBUS_TYPE_BYTE: {
+		const guchar *data = NULL;
+		int len = 0;
+		GArray *array;
+
+		dbus_message_iter_recurse (iter, &sub);
+		dbus_message_iter_get_fixed_array (&sub, &data, &len);
+		array = g_array_sized_new (FALSE, FALSE, 1, len);
+		g_array_append_vals (array, data, len);
+		g_value_init (value, DBUS_TYPE_G_UCHAR_ARRAY);
+		g_value_take_boxed (value, array);
+		return TRUE;
+	}
+	case DBUS_TYPE_UINT16:
+	case DBUS_TYPE_UINT32: {
+		GArray *array = g_array_new (FALSE, FALSE, sizeof (guint));
+
+		dbus_message_iter_recurse (iter, &sub);
+		while (dbus_message_iter_get_arg_type (&sub) != DBUS_TYPE_INVALID) {
+			dbus_uint32_t v32 = 0;
+			dbus_uint16_t v16 = 0;
+			guint v;
+
+			if (dbus_message_iter_get_arg_type (&sub) == DBUS_TYPE_UINT16) {
+				dbus_message_iter_get_basic (&sub, &v16);
+				v = v16;
+			} else {
+				dbus_message_iter_get_basic (&sub, &v32);
+				v = v32;
+			}
+			g_array_append_val (array, v);
+			dbus_message_iter_next (&sub);
 		}
-		g_error_free (error);
+		g_value_init (value, DBUS_TYPE_G_ARRAY_OF_UINT);
+		g_value_take_boxed (value, array);
+		return TRUE;
+	}
+	case DBUS_TYPE_STRING: {
+		GPtrArray *strv = g_ptr_array_new ();
+
+		dbus_message_iter_recurse (iter, &sub);
+		while (dbus_message_iter_get_arg_type (&sub) == DBUS_TYPE_STRING) {
+			const char *v;
+
+			dbus_message_iter_get_basic (&sub, &v);
+			g_ptr_array_add (strv, g_strdup (v));
+			dbus_message_iter_next (&sub);
+		}
+		g_ptr_array_add (strv, NULL);
+		g_value_init (value, G_TYPE_STRV);
+		g_value_take_boxed (value, (char **) g_ptr_array_free (strv, FALSE));
+		return TRUE;
+	}
+	case DBUS_TYPE_OBJECT_PATH: {
+		GPtrArray *paths = g_ptr_array_new ();
+
+		dbus_message_iter_recurse (iter, &sub);
+		while (dbus_message_iter_get_arg_type (&sub) == DBUS_TYPE_OBJECT_PATH) {
+			const char *v;
+
+			dbus_message_iter_get_basic (&sub, &v);
+			g_ptr_array_add (paths, g_strdup (v));
+			dbus_message_iter_next (&sub);
+		}
+		g_value_init (value, DBUS_TYPE_G_ARRAY_OF_OBJECT_PATH);
+		g_value_take_boxed (value, paths);
+		return TRUE;
+	}
+	case DBUS_TYPE_DICT_ENTRY: {
+		GHashTable *dict = demarshal_dict (iter);
+
+		if (!dict)
+			return FALSE;
+		g_value_init (value, DBUS_TYPE_G_MAP_OF_VARIANT);
+		g_value_take_boxed (value, dict);
+		return TRUE;
+	}
+	default:
+		return FALSE;
 	}
 }
 
+/* Demarshals an a{sv} into a string -> GValue hash, skipping values of
+ * unknown types.
+ */
+static GHashTable *
+demarshal_dict (DBusMessageIter *iter)
+{
+	DBusMessageIter array, entry;
+	GHashTable *dict;
+
+	if (   dbus_message_iter_get_arg_type (iter) != DBUS_TYPE_ARRAY
+	    || dbus_message_iter_get_element_type (iter) != DBUS_TYPE_DICT_ENTRY)
+		return NULL;
+
+	dict = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, bss_value_destroy);
+
+	dbus_message_iter_recurse (iter, &array);
+	while (dbus_message_iter_get_arg_type (&array) == DBUS_TYPE_DICT_ENTRY) {
+		const char *key;
+		GValue *value;
+
+		dbus_message_iter_recurse (&array, &entry);
+		if (dbus_message_iter_get_arg_type (&entry) == DBUS_TYPE_STRING) {
+			dbus_message_iter_get_basic (&entry, &key);
+			dbus_message_iter_next (&entry);
+
+			value = g_slice_new0 (GValue);
+			if (demarshal_value (&entry, value))
+				g_hash_table_insert (dict, g_strdup (key), value);
+			else
+				g_slice_free (GValue, value);
+		}
+		dbus_message_iter_next (&array);
+	}
+
+	return dict;
+}
+
+/*******************************************************************/
+
 static void
-bss_properties_changed (DBusGProxy *proxy,
-                        const char *interface,
-                        GHashTable *props,
-                        const char **unused,
-                        gpointer user_data)
+bss_signals_add (NMSupplicantInterface *self)
+{
+	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
+	DBusConnection *connection;
+	DBusError error;
+	char *rule;
+
+	connection = nm_dbus_manager_get_dbus_connection (priv->dbus_mgr);
+	g_return_if_fail (connection != NULL);
+	g_return_if_fail (priv->bss_filter_added == FALSE);
+
+	if (!dbus_connection_add_filter (connection, bss_signal_filter, self, NULL)) {
+		nm_log_err (LOGD_SUPPLICANT, "(%s): could not add BSS signal filter", priv->dev);
+		return;
+	}
+	priv->bss_filter_added = TRUE;
+
+	/* All BSS objects live below the interface object */
+	dbus_error_init (&error);
+	rule = g_strdup_printf ("type='signal',sender='" WPAS_DBUS_SERVICE "',path_namespace='%s'",
+	                        priv->object_path);
+	dbus_bus_add_match (connection, rule, &error);
+	if (!dbus_error_is_set (&error)) {
+		priv->bss_match_rules = g_slist_prepend (priv->bss_match_rules, rule);
+		return;
+	}
+	g_free (rule);
+
+	/* D-Bus daemons older than 1.5 don't know path_namespace; fall back to
+	 * matching the PropertiesChanged signals of all supplicant objects.
+	 */
+	nm_log_dbg (LOGD_SUPPLICANT, "(%s): path_namespace match failed (%s), using sender match",
+	            priv->dev, error.message);
+	dbus_error_free (&error);
+
+	rule = g_strdup ("type='signal',sender='" WPAS_DBUS_SERVICE "',"
+	                 "interface='" DBUS_INTERFACE_PROPERTIES "',member='PropertiesChanged'");
+	dbus_bus_add_match (connection, rule, NULL);
+	priv->bss_match_rules = g_slist_prepend (priv->bss_match_rules, rule);
+
+	rule = g_strdup ("type='signal',sender='" WPAS_DBUS_SERVICE "',"
+	                 "interface='" WPAS_DBUS_IFACE_BSS "',member='PropertiesChanged'");
+	dbus_bus_add_match (connection, rule, NULL);
+	priv->bss_match_rules = g_slist_prepend (priv->bss_match_rules, rule);
+}
+
+static void
+bss_signals_remove (NMSupplicantInterface *self)
+{
+	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
+	DBusConnection *connection;
+	GSList *iter;
+
+	connection = nm_dbus_manager_get_dbus_connection (priv->dbus_mgr);
+
+	for (iter = priv->bss_match_rules; iter; iter = g_slist_next (iter)) {
+		if (connection)
+			dbus_bus_remove_match (connection, iter->data, NULL);
+		g_free (iter->data);
+	}
+	g_slist_free (priv->bss_match_rules);
+	priv->bss_match_rules = NULL;
+
+	if (priv->bss_filter_added) {
+		if (connection)
+			dbus_connection_remove_filter (connection, bss_signal_filter, self);
+		priv->bss_filter_added = FALSE;
+	}
+}
+
+/* Demultiplexes BSS PropertiesChanged signals by object path */
+static DBusHandlerResult
+bss_signal_filter (DBusConnection *connection, DBusMessage *message, void *user_data)
 {
 	NMSupplicantInterface *self = NM_SUPPLICANT_INTERFACE (user_data);
 	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
+	DBusMessageIter iter;
+	const char *path, *interface;
+	GHashTable *props;
+
+	if (dbus_message_get_type (message) != DBUS_MESSAGE_TYPE_SIGNAL)
+		return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+
+	path = dbus_message_get_path (message);
+	if (!path || !g_hash_table_lookup_extended (priv->bss_paths, path, NULL, NULL))
+		return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+
+	dbus_message_iter_init (message, &iter);
+	if (dbus_message_is_signal (message, DBUS_INTERFACE_PROPERTIES, "PropertiesChanged")) {
+		/* Standard D-Bus PropertiesChanged signal */
+		if (dbus_message_iter_get_arg_type (&iter) != DBUS_TYPE_STRING)
+			return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+		dbus_message_iter_get_basic (&iter, &interface);
+		if (g_strcmp0 (interface, WPAS_DBUS_IFACE_BSS) != 0)
+			return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+		dbus_message_iter_next (&iter);
+	} else if (!dbus_message_is_signal (message, WPAS_DBUS_IFACE_BSS, "PropertiesChanged")) {
+		/* Not the old wpa_supplicant-specific PropertiesChanged signal either */
+		return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+	}
 
-	if (priv->scanning)
-		priv->last_scan = time (NULL);
+	props = demarshal_dict (&iter);
+	if (props) {
+		if (priv->scanning)
+			priv->last_scan = time (NULL);
 
-	if (g_strcmp0 (interface, WPAS_DBUS_IFACE_BSS) == 0)
-		g_signal_emit (self, signals[BSS_UPDATED], 0, dbus_g_proxy_get_path (proxy), props);
+		g_signal_emit (self, signals[BSS_UPDATED], 0, path, props);
+		g_hash_table_destroy (props);
+	}
+
+	return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
 }
 
+/*******************************************************************/
+
+typedef struct {
+	NMSupplicantInterface *self;
+	char *path;
+} BssFetch;
+
 static void
-old_bss_properties_changed (DBusGProxy *proxy,
-                            GHashTable *props,
-                            gpointer user_data)
+bss_fetch_free (gpointer data)
+{
+	BssFetch *fetch = data;
+
+	g_free (fetch->path);
+	g_slice_free (BssFetch, fetch);
+}
+
+static void bss_fetch_schedule (NMSupplicantInterface *self);
+
+static void
+bss_fetch_done (DBusPendingCall *pending, void *user_data)
+{
+	BssFetch *fetch = user_data;
+	NMSupplicantInterface *self = fetch->self;
+	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
+	DBusMessage *reply;
+	DBusMessageIter iter;
+	GHashTable *props = NULL;
+
+	reply = dbus_pending_call_steal_reply (pending);
+	if (reply) {
+		if (dbus_message_get_type (reply) == DBUS_MESSAGE_TYPE_ERROR) {
+			DBusError error;
+
+			dbus_error_init (&error);
+			dbus_set_error_from_message (&error, reply);
+			if (!error.message || !strstr (error.message, "The BSSID requested was invalid")) {
+				nm_log_warn (LOGD_SUPPLICANT, "Couldn't retrieve BSSID properties: %s.",
+				             error.message);
+			}
+			dbus_error_free (&error);
+		} else if (dbus_message_iter_init (reply, &iter))
+			props = demarshal_dict (&iter);
+		dbus_message_unref (reply);
+	}
+
+	/* The BSS may have been removed while waiting */
+	if (props) {
+		if (g_hash_table_lookup_extended (priv->bss_paths, fetch->path, NULL, NULL))
+			signal_new_bss (self, fetch->path, props);
+		g_hash_table_destroy (props);
+	}
+
+	/* Drops the last reference to the call, which frees 'fetch' */
+	g_hash_table_remove (priv->bss_fetch_pending, pending);
+	bss_fetch_schedule (self);
+}
+
+/* Requests properties of queued BSSes, keeping a bounded number of requests
+ * in flight so a full scan list doesn't flood the bus at once.
+ */
+static gboolean
+bss_fetch_next (gpointer user_data)
 {
 	NMSupplicantInterface *self = NM_SUPPLICANT_INTERFACE (user_data);
 	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
+	DBusConnection *connection;
+	const char *bss_iface = WPAS_DBUS_IFACE_BSS;
 
-	if (priv->scanning)
-		priv->last_scan = time (NULL);
+	priv->bss_fetch_id = 0;
+
+	connection = nm_dbus_manager_get_dbus_connection (priv->dbus_mgr);
+	g_return_val_if_fail (connection != NULL, FALSE);
+
+	while (   g_hash_table_size (priv->bss_fetch_pending) < BSS_FETCH_MAX_PENDING
+	       && !g_queue_is_empty (&priv->bss_fetch_queue)) {
+		char *path = g_queue_pop_head (&priv->bss_fetch_queue);
+		DBusMessage *message;
+		DBusPendingCall *pending = NULL;
+		BssFetch *fetch;
+
+		if (!g_hash_table_lookup_extended (priv->bss_paths, path, NULL, NULL)) {
+			g_free (path);
+			continue;
+		}
+
+		message = dbus_message_new_method_call (WPAS_DBUS_SERVICE,
+		                                        path,
+		                                        DBUS_INTERFACE_PROPERTIES,
+		                                        "GetAll");
+		dbus_message_append_args (message,
+		                          DBUS_TYPE_STRING, &bss_iface,
+		                          DBUS_TYPE_INVALID);
+		if (!dbus_connection_send_with_reply (connection, message, &pending, -1) || !pending) {
+			nm_log_warn (LOGD_SUPPLICANT, "(%s): couldn't request BSS %s properties",
+			             priv->dev, path);
+			dbus_message_unref (message);
+			g_free (path);
+			continue;
+		}
+		dbus_message_unref (message);
+
+		fetch = g_slice_new0 (BssFetch);
+		fetch->self = self;
+		fetch->path = path;
+		g_hash_table_insert (priv->bss_fetch_pending, pending, NULL);
+		dbus_pending_call_set_notify (pending, bss_fetch_done, fetch, bss_fetch_free);
+	}
+
+	return FALSE;
+}
+
+static void
+bss_fetch_schedule (NMSupplicantInterface *self)
+{
+	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
+
+	if (   !priv->bss_fetch_id
+	    && !g_queue_is_empty (&priv->bss_fetch_queue)
+	    && g_hash_table_size (priv->bss_fetch_pending) < BSS_FETCH_MAX_PENDING)
+		priv->bss_fetch_id = g_idle_add (bss_fetch_next, self);
+}
+
+static void
+bss_fetch_cancel_all (NMSupplicantInterface *self)
+{
+	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
+	GHashTableIter iter;
+	DBusPendingCall *pending;
+	char *path;
+
+	if (priv->bss_fetch_id) {
+		g_source_remove (priv->bss_fetch_id);
+		priv->bss_fetch_id = 0;
+	}
 
-	g_signal_emit (self, signals[BSS_UPDATED], 0, dbus_g_proxy_get_path (proxy), props);
+	while ((path = g_queue_pop_head (&priv->bss_fetch_queue)))
+		g_free (path);
+
+	g_hash_table_iter_init (&iter, priv->bss_fetch_pending);
+	while (g_hash_table_iter_next (&iter, (gpointer) &pending, NULL)) {
+		dbus_pending_call_cancel (pending);
+		g_hash_table_iter_remove (&iter);
+	}
 }
 
 static void
@@ -292,65 +748,19 @@ handle_new_bss (NMSupplicantInterface *self,
                 GHashTable *props)
 {
 	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
-	NMSupplicantInfo *info;
-	DBusGProxyCall *call;
-	BssProxies *proxies;
 
 	g_return_if_fail (object_path != NULL);
 
-	if (g_hash_table_lookup (priv->bss_proxies, object_path))
+	if (g_hash_table_lookup_extended (priv->bss_paths, object_path, NULL, NULL))
 		return;
 
-	proxies = g_malloc0 (sizeof (*proxies));
-	proxies->props = dbus_g_proxy_new_for_name (nm_dbus_manager_get_connection (priv->dbus_mgr),
-	                                            WPAS_DBUS_SERVICE,
-	                                            object_path,
-	                                            DBUS_INTERFACE_PROPERTIES);
-	proxies->old_props = dbus_g_proxy_new_for_name (nm_dbus_manager_get_connection (priv->dbus_mgr),
-	                                                WPAS_DBUS_SERVICE,
-	                                                object_path,
-	                                                WPAS_DBUS_IFACE_BSS);
-	g_hash_table_insert (priv->bss_proxies,
-	                     (gpointer) dbus_g_proxy_get_path (proxies->props),
-	                     proxies);
-
-	/* Standard D-Bus PropertiesChanged signal */
-	dbus_g_object_register_marshaller (_nm_marshal_VOID__STRING_BOXED_BOXED,
-	                                   G_TYPE_NONE,
-	                                   G_TYPE_STRING, DBUS_TYPE_G_MAP_OF_VARIANT, G_TYPE_STRV,
-	                                   G_TYPE_INVALID);
-	dbus_g_proxy_add_signal (proxies->props, "PropertiesChanged",
-	                         G_TYPE_STRING, DBUS_TYPE_G_MAP_OF_VARIANT, G_TYPE_STRV,
-	                         G_TYPE_INVALID);
-	dbus_g_proxy_connect_signal (proxies->props, "PropertiesChanged",
-	                             G_CALLBACK (bss_properties_changed),
-	                             self, NULL);
+	g_hash_table_insert (priv->bss_paths, g_strdup (object_path), NULL);
 
-	/* Old wpa_supplicant-specific PropertiesChanged signal; since it's using
-	 * a different interface, we have to use a different DBusGProxy
-	 */
-	dbus_g_object_register_marshaller (g_cclosure_marshal_VOID__BOXED,
-	                                   G_TYPE_NONE,
-	                                   DBUS_TYPE_G_MAP_OF_VARIANT,
-	                                   G_TYPE_INVALID);
-	dbus_g_proxy_add_signal (proxies->old_props, "PropertiesChanged",
-	                         DBUS_TYPE_G_MAP_OF_VARIANT,
-	                         G_TYPE_INVALID);
-	dbus_g_proxy_connect_signal (proxies->old_props, "PropertiesChanged",
-	                             G_CALLBACK (old_bss_properties_changed),
-	                             self, NULL);
-
-	if (props) {
+	if (props)
 		signal_new_bss (self, object_path, props);
-	} else {
-		info = nm_supplicant_info_new (self, proxies->props, priv->other_pcalls);
-		call = dbus_g_proxy_begin_call (proxies->props, "GetAll",
-		                                bssid_properties_cb,
-		                                info,
-		                                nm_supplicant_info_destroy,
-		                                G_TYPE_STRING, WPAS_DBUS_IFACE_BSS,
-		                                G_TYPE_INVALID);
-		nm_supplicant_info_set_call (info, call);
+	else {
+		g_queue_push_tail (&priv->bss_fetch_queue, g_strdup (object_path));
+		bss_fetch_schedule (self);
 	}
 }
 
@@ -379,7 +789,7 @@ wpas_iface_bss_removed (DBusGProxy *proxy,
 
 	g_signal_emit (self, signals[BSS_REMOVED], 0, object_path);
 
-	g_hash_table_remove (priv->bss_proxies, object_path);
+	g_hash_table_remove (priv->bss_paths, object_path);
 }
 
 static int
@@ -437,6 +847,8 @@ set_state (NMSupplicantInterface *self, guint32 new_state)
 		/* Cancel all pending calls when going down */
 		cancel_all_callbacks (priv->other_pcalls);
 		cancel_all_callbacks (priv->assoc_pcalls);
+		bss_fetch_cancel_all (self);
+		bss_signals_remove (self);
 
 		/* Disconnect supplicant manager state listeners since we're done */
 		if (priv->smgr_avail_id) {
@@ -912,6 +1324,9 @@ interface_add_done (NMSupplicantInterface *self, char *path)
 	                                               WPAS_DBUS_SERVICE,
 	                                               path,
 	                                               DBUS_INTERFACE_PROPERTIES);
+
+	bss_signals_add (self);
+
 	/* Get initial properties and check whether NetworkReply is supported */
 	priv->ready_count = 1;
 	wpas_iface_get_props (self);
@@ -1320,15 +1735,40 @@ nm_supplicant_interface_set_config (NMSupplicantInterface * self,
 	return call != NULL;
 }
 
+static gboolean request_scan (NMSupplicantInterface *self,
+                              const GPtrArray *ssids,
+                              const GArray *freqs);
+
 static void
 scan_request_cb (DBusGProxy *proxy, DBusGProxyCall *call_id, gpointer user_data)
 {
 	NMSupplicantInfo *info = (NMSupplicantInfo *) user_data;
 	GError *err = NULL;
 
+	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (info->interface);
+
 	if (!dbus_g_proxy_end_call (proxy, call_id, &err, G_TYPE_INVALID)) {
 		nm_log_warn (LOGD_SUPPLICANT, "Could not get scan request result: %s", err->message);
-	} 
+
+		/* Older supplicants reject the unknown Channels argument; only do
+		 * full scans from now on, starting with this one.  Other errors
+		 * (eg, busy) say nothing about channel support.  dbus-glib maps the
+		 * standard InvalidArgs error to its own code rather than a remote
+		 * exception.
+		 */
+		if (   info->scan_channels
+		    && (   dbus_g_error_has_name (err, WPAS_ERROR_INVALID_ARGS)
+		        || g_error_matches (err, DBUS_GERROR, DBUS_GERROR_INVALID_ARGS))) {
+			nm_log_info (LOGD_SUPPLICANT, "(%s): disabling scans restricted to channels",
+			             priv->dev);
+			priv->scan_channels_unsupported = TRUE;
+
+			if (request_scan (info->interface, info->scan_ssids, NULL)) {
+				g_error_free (err);
+				return;
+			}
+		}
+	}
 	g_signal_emit (info->interface, signals[SCAN_DONE], 0, err ? FALSE : TRUE);
 	g_clear_error (&err);
 }
@@ -1362,18 +1802,43 @@ byte_array_array_to_gvalue (const GPtrArray *array)
 	return val;
 }
 
-gboolean
-nm_supplicant_interface_request_scan (NMSupplicantInterface *self, const GPtrArray *ssids)
+static GValue *
+channels_to_gvalue (const GArray *freqs)
 {
-	NMSupplicantInterfacePrivate *priv;
+	GValue *val = g_slice_new0 (GValue);
+	GPtrArray *channels;
+	guint i;
+
+	channels = g_ptr_array_sized_new (freqs->len);
+	for (i = 0; i < freqs->len; i++) {
+		GValueArray *channel = g_value_array_new (2);
+		GValue item = { 0, };
+
+		g_value_init (&item, G_TYPE_UINT);
+		g_value_set_uint (&item, g_array_index (freqs, guint32, i));
+		g_value_array_append (channel, &item);
+		g_value_set_uint (&item, 20);
+		g_value_array_append (channel, &item);
+		g_value_unset (&item);
+
+		g_ptr_array_add (channels, channel);
+	}
+
+	g_value_init (val, DBUS_TYPE_G_ARRAY_OF_UINT_STRUCT);
+	g_value_take_boxed (val, channels);
+	return val;
+}
+
+static gboolean
+request_scan (NMSupplicantInterface *self,
+              const GPtrArray *ssids,
+              const GArray *freqs)
+{
+	NMSupplicantInterfacePrivate *priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
 	NMSupplicantInfo *info;
 	DBusGProxyCall *call;
 	GHashTable *hash;
 
-	g_return_val_if_fail (NM_IS_SUPPLICANT_INTERFACE (self), FALSE);
-
-	priv = NM_SUPPLICANT_INTERFACE_GET_PRIVATE (self);
-
 	/* Scan parameters */
 	hash = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, destroy_gvalue);
 	g_hash_table_insert (hash, "Type", string_to_gvalue ("active"));
@@ -1381,6 +1846,13 @@ nm_supplicant_interface_request_scan (NMSupplicantInterface *self, const GPtrArr
 		g_hash_table_insert (hash, "SSIDs", byte_array_array_to_gvalue (ssids));
 
 	info = nm_supplicant_info_new (self, priv->iface_proxy, priv->other_pcalls);
+	if (freqs && freqs->len && !priv->scan_channels_unsupported) {
+		g_hash_table_insert (hash, "Channels", channels_to_gvalue (freqs));
+		info->scan_channels = TRUE;
+		if (ssids)
+			info->scan_ssids = ssids_copy (ssids);
+	}
+
 	call = dbus_g_proxy_begin_call (priv->iface_proxy, "Scan",
 	                                scan_request_cb,
 	                                info,
@@ -1393,6 +1865,21 @@ nm_supplicant_interface_request_scan (NMSupplicantInterface *self, const GPtrArr
 	return call != NULL;
 }
 
+/* Requests an active scan probing for @ssids (GByteArray elements) on the
+ * frequencies in @freqs (guint32 MHz).  All supported channels are scanned
+ * if @freqs is NULL or empty, or the supplicant rejected channel lists
+ * before.
+ */
+gboolean
+nm_supplicant_interface_request_scan (NMSupplicantInterface *self,
+                                      const GPtrArray *ssids,
+                                      const GArray *freqs)
+{
+	g_return_val_if_fail (NM_IS_SUPPLICANT_INTERFACE (self), FALSE);
+
+	return request_scan (self, ssids, freqs);
+}
+
 guint32
 nm_supplicant_interface_get_state (NMSupplicantInterface * self)
 {
@@ -1532,7 +2019,11 @@ nm_supplicant_interface_init (NMSupplicantInterface * self)
 	                                              WPAS_DBUS_PATH,
 	                                              WPAS_DBUS_INTERFACE);
 
-	priv->bss_proxies = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, bss_proxies_free);
+	priv->bss_paths = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	g_queue_init (&priv->bss_fetch_queue);
+	priv->bss_fetch_pending = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+	                                                 (GDestroyNotify) dbus_pending_call_unref,
+	                                                 NULL);
 }
 
 static void
@@ -1582,6 +2073,10 @@ dispose (GObject *object)
 	cancel_all_callbacks (priv->assoc_pcalls);
 	nm_call_store_destroy (priv->assoc_pcalls);
 
+	bss_fetch_cancel_all (NM_SUPPLICANT_INTERFACE (object));
+	g_hash_table_destroy (priv->bss_fetch_pending);
+	bss_signals_remove (NM_SUPPLICANT_INTERFACE (object));
+
 	if (priv->props_proxy)
 		g_object_unref (priv->props_proxy);
 
@@ -1593,7 +2088,7 @@ dispose (GObject *object)
 	if (priv->wpas_proxy)
 		g_object_unref (priv->wpas_proxy);
 
-	g_hash_table_destroy (priv->bss_proxies);
+	g_hash_table_destroy (priv->bss_paths);
 
 	if (priv->smgr) {
 		if (priv->smgr_avail_id)
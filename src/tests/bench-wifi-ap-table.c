@@ -0,0 +1,213 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2012 Red Hat, Inc.
+ *
+ */
+
+/* Scan merge lookups over synthetic scan lists, comparing the access point
+ * table against the linear list walk it replaced.  Every lookup does what
+ * merge_scanned_ap() does per BSS: a supplicant path lookup followed by a
+ * strict match.  The results of both are checked to be identical.  Also
+ * compares finding the outdated APs for a scan list cull.  Not run by 'make
+ * check'; use 'make bench' in this directory.
+ *
+ * Usage: bench-wifi-ap-table [BSSES...]
+ */
+
+#include <glib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "wifi-bench-fixture.h"
+
+#define ROUNDS 5
+
+/* Conference hall: a few SSIDs on many BSSIDs and channels */
+static FakeAP *
+bench_ap_new (guint i)
+{
+	FakeAP *ap = fake_ap_new (i, 8);
+
+	/* The odd manually created AP without a BSSID */
+	ap->bssid_valid = (i % 100) != 99;
+	ap->dbus_path = g_strdup_printf ("/org/freedesktop/NetworkManager/AccessPoint/%u", i);
+	return ap;
+}
+
+static FakeAP *
+list_find (GSList *list, FakeAP *find)
+{
+	GSList *iter;
+
+	for (iter = list; iter; iter = g_slist_next (iter)) {
+		if (g_strcmp0 (find->supplicant_path, ((FakeAP *) iter->data)->supplicant_path) == 0)
+			return iter->data;
+	}
+	for (iter = list; iter; iter = g_slist_next (iter)) {
+		if (fake_ap_matches (iter->data, find, TRUE))
+			return iter->data;
+	}
+	return NULL;
+}
+
+static FakeAP *
+table_find (NMAPTable *table, FakeAP *find)
+{
+	FakeAP *found;
+
+	found = nm_ap_table_lookup_supplicant_path (table, find->supplicant_path);
+	if (!found)
+		found = fake_ap_find (table, find, TRUE);
+	return found;
+}
+
+static void
+bench_merge (guint n_bss)
+{
+	GPtrArray *known, *scan;
+	GSList *list = NULL;
+	NMAPTable *table;
+	GTimer *timer;
+	double list_time = 0, table_time = 0;
+	guint i, round;
+
+	/* The device already knows every BSS; the scan results carry a new
+	 * supplicant path for half of them (eg, after a supplicant restart), so
+	 * those have to go through the full match.
+	 */
+	known = g_ptr_array_new_with_free_func ((GDestroyNotify) fake_ap_free);
+	scan = g_ptr_array_new_with_free_func ((GDestroyNotify) fake_ap_free);
+	table = nm_ap_table_new ();
+	for (i = 0; i < n_bss; i++) {
+		FakeAP *ap = bench_ap_new (i);
+		FakeAP *seen = bench_ap_new (i);
+
+		g_ptr_array_add (known, ap);
+		list = g_slist_prepend (list, ap);
+		nm_ap_table_prepend (table, ap, ap->dbus_path, ap->supplicant_path,
+		                     &ap->bssid, ap->bssid_valid);
+
+		if (i % 2) {
+			g_free (seen->supplicant_path);
+			seen->supplicant_path = g_strdup_printf ("/fi/w1/wpa_supplicant1/Interfaces/1/BSSs/%u", i);
+		}
+		g_ptr_array_add (scan, seen);
+	}
+
+	for (round = 0; round < ROUNDS; round++) {
+		timer = g_timer_new ();
+		for (i = 0; i < scan->len; i++)
+			list_find (list, g_ptr_array_index (scan, i));
+		list_time += g_timer_elapsed (timer, NULL);
+
+		g_timer_start (timer);
+		for (i = 0; i < scan->len; i++)
+			table_find (table, g_ptr_array_index (scan, i));
+		table_time += g_timer_elapsed (timer, NULL);
+		g_timer_destroy (timer);
+	}
+
+	for (i = 0; i < scan->len; i++) {
+		FakeAP *find = g_ptr_array_index (scan, i);
+
+		g_assert (list_find (list, find) == table_find (table, find));
+		g_assert (list_find (list, find) != NULL);
+	}
+
+	printf ("%5u BSSes: list %8.2f ms, table %6.2f ms per scan merge\n",
+	        n_bss, list_time * 1000 / ROUNDS, table_time * 1000 / ROUNDS);
+
+	nm_ap_table_free (table);
+	g_slist_free (list);
+	g_ptr_array_free (scan, TRUE);
+	g_ptr_array_free (known, TRUE);
+}
+
+static void
+bench_cull (guint n_bss)
+{
+	GPtrArray *known;
+	GSList *list = NULL, *outdated, *iter;
+	NMAPTable *table;
+	GTimer *timer;
+	double list_time = 0, table_time = 0;
+	guint i, round, n_list = 0, n_table = 0;
+	const glong now = 1000, prune = 360;
+
+	/* Most APs were seen in the last scan; a few dropped out long ago */
+	known = g_ptr_array_new_with_free_func ((GDestroyNotify) fake_ap_free);
+	table = nm_ap_table_new ();
+	for (i = 0; i < n_bss; i++) {
+		FakeAP *ap = bench_ap_new (i);
+
+		ap->last_seen = (i % 20) ? now - (i % 7) : now - prune - 1 - (i % 5);
+		g_ptr_array_add (known, ap);
+		list = g_slist_prepend (list, ap);
+		nm_ap_table_prepend (table, ap, ap->dbus_path, ap->supplicant_path,
+		                     &ap->bssid, ap->bssid_valid);
+		nm_ap_table_set_last_seen (table, ap, ap->last_seen);
+	}
+
+	for (round = 0; round < ROUNDS; round++) {
+		timer = g_timer_new ();
+		outdated = NULL;
+		for (iter = list; iter; iter = g_slist_next (iter)) {
+			if (((FakeAP *) iter->data)->last_seen + prune < now)
+				outdated = g_slist_prepend (outdated, iter->data);
+		}
+		n_list = g_slist_length (outdated);
+		g_slist_free (outdated);
+		list_time += g_timer_elapsed (timer, NULL);
+
+		g_timer_start (timer);
+		outdated = nm_ap_table_get_older_than (table, now - prune);
+		n_table = g_slist_length (outdated);
+		g_slist_free (outdated);
+		table_time += g_timer_elapsed (timer, NULL);
+		g_timer_destroy (timer);
+	}
+
+	g_assert_cmpint (n_list, ==, n_table);
+
+	printf ("%5u BSSes: list %8.2f ms, table %6.2f ms per cull (%u outdated)\n",
+	        n_bss, list_time * 1000 / ROUNDS, table_time * 1000 / ROUNDS, n_table);
+
+	nm_ap_table_free (table);
+	g_slist_free (list);
+	g_ptr_array_free (known, TRUE);
+}
+
+int
+main (int argc, char **argv)
+{
+	static const guint defaults[] = { 50, 200, 500, 1500, 5000 };
+	guint i;
+
+	if (argc > 1) {
+		for (i = 1; i < argc; i++)
+			bench_merge (strtoul (argv[i], NULL, 10));
+		for (i = 1; i < argc; i++)
+			bench_cull (strtoul (argv[i], NULL, 10));
+	} else {
+		for (i = 0; i < G_N_ELEMENTS (defaults); i++)
+			bench_merge (defaults[i]);
+		for (i = 0; i < G_N_ELEMENTS (defaults); i++)
+			bench_cull (defaults[i]);
+	}
+	return 0;
+}
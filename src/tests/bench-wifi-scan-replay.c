@@ -0,0 +1,376 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2012 Red Hat, Inc.
+ *
+ */
+
+/* Replays generated wpa_supplicant BSS event sequences through the scan list
+ * handling of NMDeviceWifi: BSSAdded results are batched and merged once per
+ * scan, PropertiesChanged updates the last-seen time, BSSRemoved marks the AP
+ * and the scan list is culled after every scan.  The device itself needs the
+ * whole daemon around it, so the handlers are mirrored here; merging and
+ * culling go through the same scan list code as the device's.
+ *
+ * Reports merge and cull time per scan, GLib allocations per scan, the
+ * AccessPointAdded/Removed signals the device would emit and how often the
+ * available connections would be rechecked.  Allocations only include
+ * GSlice ones when run with G_SLICE=always-malloc, which 'make bench' does.
+ * Not run by 'make check'; use 'make bench' in this directory.
+ *
+ * Usage: bench-wifi-scan-replay [BSSES...]
+ */
+
+#include <glib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "wifi-bench-fixture.h"
+
+#define SCANS         30
+#define SCAN_INTERVAL 20
+#define PRUNE         (SCAN_INTERVAL * 3)
+#define CULL_DELAY    4
+#define N_SSIDS       32
+#define N_CONNECTIONS 16
+
+typedef enum {
+	BSS_ADDED,
+	BSS_UPDATED,
+	BSS_REMOVED
+} EventType;
+
+typedef struct {
+	EventType type;
+	guint bss;
+} Event;
+
+typedef struct {
+	NMAPTable *aps;
+	GSList *batch;
+	GPtrArray *paths;
+	guint exported;
+	GHashTable *changed_ssids;
+
+	guint signals;
+	guint rechecks;
+	guint rechecked;
+} FakeDevice;
+
+/*******************************************************************/
+
+static gsize n_allocs = 0;
+
+static gpointer
+counting_malloc (gsize n_bytes)
+{
+	n_allocs++;
+	return malloc (n_bytes);
+}
+
+static gpointer
+counting_realloc (gpointer mem, gsize n_bytes)
+{
+	n_allocs++;
+	return realloc (mem, n_bytes);
+}
+
+static gpointer
+counting_calloc (gsize n_blocks, gsize n_block_bytes)
+{
+	n_allocs++;
+	return calloc (n_blocks, n_block_bytes);
+}
+
+static GMemVTable counting_vtable = {
+	counting_malloc,
+	counting_realloc,
+	free,
+	counting_calloc,
+	NULL,
+	NULL
+};
+
+/*******************************************************************/
+
+/* One event list per scan.  BSS numbers index the path array; BSSes that go
+ * out of range are replaced by new ones and removed by the supplicant right
+ * away, most of those staying in range report a new signal strength.
+ */
+static GPtrArray *
+generate_scans (guint n_bss, guint churn, GPtrArray *paths)
+{
+	GPtrArray *scans;
+	GArray *in_range;
+	GRand *rand;
+	guint scan, i, next = 0;
+
+	rand = g_rand_new_with_seed (n_bss * 100 + churn);
+	scans = g_ptr_array_new ();
+	in_range = g_array_new (FALSE, FALSE, sizeof (guint));
+
+	for (scan = 0; scan < SCANS; scan++) {
+		GArray *events = g_array_new (FALSE, FALSE, sizeof (Event));
+		guint leaving = scan ? n_bss * churn / 100 : 0;
+		guint staying;
+		Event event;
+
+		for (i = 0; i < leaving; i++) {
+			guint idx = g_rand_int_range (rand, 0, in_range->len);
+
+			event.type = BSS_REMOVED;
+			event.bss = g_array_index (in_range, guint, idx);
+			g_array_append_val (events, event);
+			g_array_remove_index_fast (in_range, idx);
+		}
+
+		staying = in_range->len;
+		for (i = 0; i < staying; i++) {
+			if (g_rand_int_range (rand, 0, 4) == 0)
+				continue;
+			event.type = BSS_UPDATED;
+			event.bss = g_array_index (in_range, guint, i);
+			g_array_append_val (events, event);
+		}
+
+		while (in_range->len < n_bss) {
+			g_ptr_array_add (paths, fake_bss_path (next));
+			event.type = BSS_ADDED;
+			event.bss = next++;
+			g_array_append_val (events, event);
+			g_array_append_val (in_range, event.bss);
+		}
+
+		g_ptr_array_add (scans, events);
+	}
+
+	g_array_free (in_range, TRUE);
+	g_rand_free (rand);
+	return scans;
+}
+
+/*******************************************************************/
+
+static void
+recheck_available_connections (FakeDevice *device, GHashTable *ssids)
+{
+	guint i;
+
+	if (!g_hash_table_size (ssids))
+		return;
+
+	/* One connection per SSID, for the first few SSIDs */
+	device->rechecks++;
+	for (i = 0; i < N_CONNECTIONS; i++) {
+		if (g_hash_table_lookup_extended (ssids, GUINT_TO_POINTER (i + 1), NULL, NULL))
+			device->rechecked++;
+	}
+}
+
+static void
+update_ap (gpointer item, gpointer scanned, gpointer user_data)
+{
+	FakeAP *found = item, *merge_ap = scanned;
+
+	g_free (found->supplicant_path);
+	found->supplicant_path = g_strdup (merge_ap->supplicant_path);
+	found->last_seen = merge_ap->last_seen;
+	found->removed = merge_ap->removed;
+}
+
+static void
+remove_access_point (gpointer item, gpointer user_data)
+{
+	FakeDevice *device = user_data;
+	FakeAP *ap = item;
+
+	g_hash_table_insert (device->changed_ssids, GUINT_TO_POINTER (ap->ssid + 1), NULL);
+	device->signals++;
+	nm_ap_table_remove (device->aps, ap);
+	fake_ap_free (ap);
+}
+
+/* No current or manually created APs to keep */
+static const NMWifiScanListFuncs scan_list_funcs = {
+	fake_ap_get_keys,
+	fake_ap_find,
+	update_ap,
+	NULL,
+	remove_access_point
+};
+
+static void
+merge_scanned_ap (FakeDevice *device, FakeAP *merge_ap)
+{
+	if (nm_wifi_scan_list_merge (device->aps, merge_ap, TRUE, &scan_list_funcs, device)) {
+		fake_ap_free (merge_ap);
+		return;
+	}
+
+	merge_ap->dbus_path = g_strdup_printf ("/org/freedesktop/NetworkManager/AccessPoint/%u",
+	                                       device->exported++);
+	nm_wifi_scan_list_add (device->aps, merge_ap, &scan_list_funcs, device);
+	device->signals++;
+	g_hash_table_insert (device->changed_ssids, GUINT_TO_POINTER (merge_ap->ssid + 1), NULL);
+}
+
+static void
+scan_batch_flush (FakeDevice *device)
+{
+	GSList *batch, *iter;
+
+	batch = g_slist_reverse (device->batch);
+	device->batch = NULL;
+
+	device->changed_ssids = g_hash_table_new (g_direct_hash, g_direct_equal);
+	for (iter = batch; iter; iter = g_slist_next (iter))
+		merge_scanned_ap (device, iter->data);
+	g_slist_free (batch);
+
+	recheck_available_connections (device, device->changed_ssids);
+	g_hash_table_destroy (device->changed_ssids);
+	device->changed_ssids = NULL;
+}
+
+static void
+handle_event (FakeDevice *device, const Event *event, glong now)
+{
+	const char *path = g_ptr_array_index (device->paths, event->bss);
+	FakeAP *ap;
+	GSList *iter;
+
+	switch (event->type) {
+	case BSS_ADDED:
+		ap = fake_ap_new (event->bss, N_SSIDS);
+		ap->last_seen = now;
+		device->batch = g_slist_prepend (device->batch, ap);
+		break;
+	case BSS_UPDATED:
+		ap = nm_ap_table_lookup_supplicant_path (device->aps, path);
+		if (ap) {
+			ap->last_seen = now;
+			nm_wifi_scan_list_sync (device->aps, ap, &scan_list_funcs, device);
+		}
+		break;
+	case BSS_REMOVED:
+		ap = nm_ap_table_lookup_supplicant_path (device->aps, path);
+		for (iter = device->batch; !ap && iter; iter = g_slist_next (iter)) {
+			if (strcmp (path, ((FakeAP *) iter->data)->supplicant_path) == 0)
+				ap = iter->data;
+		}
+		if (ap) {
+			ap->removed = TRUE;
+			nm_wifi_scan_list_sync (device->aps, ap, &scan_list_funcs, device);
+		}
+		break;
+	}
+}
+
+static void
+cull_scan_list (FakeDevice *device, glong now)
+{
+	device->changed_ssids = g_hash_table_new (g_direct_hash, g_direct_equal);
+	nm_wifi_scan_list_cull (device->aps, now - PRUNE, &scan_list_funcs, device);
+
+	recheck_available_connections (device, device->changed_ssids);
+	g_hash_table_destroy (device->changed_ssids);
+	device->changed_ssids = NULL;
+}
+
+/*******************************************************************/
+
+static void
+bench_replay (guint n_bss, guint churn)
+{
+	FakeDevice device;
+	GPtrArray *scans;
+	GTimer *timer;
+	GList *list;
+	double merge_time = 0, cull_time = 0;
+	gsize allocs;
+	guint scan, i, n_events = 0;
+
+	memset (&device, 0, sizeof (device));
+	device.paths = g_ptr_array_new ();
+	scans = generate_scans (n_bss, churn, device.paths);
+	device.aps = nm_ap_table_new ();
+
+	timer = g_timer_new ();
+	allocs = n_allocs;
+	for (scan = 0; scan < scans->len; scan++) {
+		GArray *events = g_ptr_array_index (scans, scan);
+		glong now = 1000 + scan * SCAN_INTERVAL;
+
+		g_timer_start (timer);
+		for (i = 0; i < events->len; i++)
+			handle_event (&device, &g_array_index (events, Event, i), now);
+		scan_batch_flush (&device);
+		merge_time += g_timer_elapsed (timer, NULL);
+
+		g_timer_start (timer);
+		cull_scan_list (&device, now + CULL_DELAY);
+		cull_time += g_timer_elapsed (timer, NULL);
+
+		n_events += events->len;
+	}
+	allocs = n_allocs - allocs;
+	g_timer_destroy (timer);
+
+	/* Everything in range is known, plus what left in the last few scans */
+	g_assert_cmpint (nm_ap_table_size (device.aps), >=, n_bss);
+	g_assert_cmpint (nm_ap_table_size (device.aps), <=, n_bss + (n_bss * churn / 100) * (PRUNE / SCAN_INTERVAL + 1));
+
+	printf ("%5u BSSes, %2u%% churn: merge %7.3f ms, cull %6.3f ms, %6.0f allocs per scan; "
+	        "%5.0f events, %4u AP signals, %3u rechecks (%u connections)\n",
+	        n_bss, churn,
+	        merge_time * 1000 / SCANS, cull_time * 1000 / SCANS,
+	        (double) allocs / SCANS, (double) n_events / SCANS,
+	        device.signals, device.rechecks, device.rechecked);
+
+	for (list = nm_ap_table_get_list (device.aps); list; list = list->next)
+		fake_ap_free (list->data);
+	nm_ap_table_free (device.aps);
+	for (i = 0; i < scans->len; i++)
+		g_array_free (g_ptr_array_index (scans, i), TRUE);
+	g_ptr_array_free (scans, TRUE);
+	g_ptr_array_foreach (device.paths, (GFunc) g_free, NULL);
+	g_ptr_array_free (device.paths, TRUE);
+}
+
+int
+main (int argc, char **argv)
+{
+	static const guint defaults[] = { 200, 1000, 3000 };
+	static const guint churns[] = { 0, 5, 20 };
+	guint i, j;
+
+	/* Must come before anything allocates through GLib */
+	g_mem_set_vtable (&counting_vtable);
+
+	if (argc > 1) {
+		for (i = 1; i < argc; i++) {
+			for (j = 0; j < G_N_ELEMENTS (churns); j++)
+				bench_replay (strtoul (argv[i], NULL, 10), churns[j]);
+		}
+	} else {
+		for (i = 0; i < G_N_ELEMENTS (defaults); i++) {
+			for (j = 0; j < G_N_ELEMENTS (churns); j++)
+				bench_replay (defaults[i], churns[j]);
+		}
+	}
+	return 0;
+}
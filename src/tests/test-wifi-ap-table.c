@@ -0,0 +1,322 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2012 Red Hat, Inc.
+ *
+ */
+
+#include <glib.h>
+#include <string.h>
+
+#include "nm-wifi-ap-table.h"
+#include "nm-wifi-scan-list.h"
+
+/* Items are plain strings; matching is done on a tag after the '/' */
+
+static const struct ether_addr bssid_a = { { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55 } };
+static const struct ether_addr bssid_b = { { 0x00, 0x11, 0x22, 0x33, 0x44, 0x66 } };
+static const struct ether_addr bssid_none = { { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } };
+
+static gboolean
+match_tag (gpointer item, gpointer user_data)
+{
+	return g_str_has_suffix (item, user_data);
+}
+
+static void
+test_lookup_paths (void)
+{
+	NMAPTable *table = nm_ap_table_new ();
+	char *a = "a/x", *b = "b/x";
+
+	nm_ap_table_prepend (table, a, "/ap/1", "/bss/1", &bssid_a, TRUE);
+	nm_ap_table_prepend (table, b, "/ap/2", NULL, &bssid_b, TRUE);
+
+	g_assert (nm_ap_table_lookup_dbus_path (table, "/ap/1") == a);
+	g_assert (nm_ap_table_lookup_dbus_path (table, "/ap/2") == b);
+	g_assert (nm_ap_table_lookup_dbus_path (table, NULL) == NULL);
+	g_assert (nm_ap_table_lookup_supplicant_path (table, "/bss/1") == a);
+	g_assert (nm_ap_table_lookup_supplicant_path (table, NULL) == NULL);
+
+	/* The supplicant may hand a BSS path over to a different AP */
+	nm_ap_table_set_supplicant_path (table, b, "/bss/1");
+	g_assert (nm_ap_table_lookup_supplicant_path (table, "/bss/1") == b);
+	nm_ap_table_remove (table, a);
+	g_assert (nm_ap_table_lookup_supplicant_path (table, "/bss/1") == b);
+	g_assert (nm_ap_table_lookup_dbus_path (table, "/ap/1") == NULL);
+	g_assert_cmpint (nm_ap_table_size (table), ==, 1);
+
+	nm_ap_table_free (table);
+}
+
+static void
+test_find_order (void)
+{
+	NMAPTable *table = nm_ap_table_new ();
+	char *a = "a/x", *b = "b/x", *c = "c/x";
+
+	/* List order after this is c, b, a; b has no BSSID */
+	nm_ap_table_prepend (table, a, "/ap/1", NULL, &bssid_a, TRUE);
+	nm_ap_table_prepend (table, b, "/ap/2", NULL, &bssid_none, FALSE);
+	nm_ap_table_prepend (table, c, "/ap/3", NULL, &bssid_a, TRUE);
+	g_assert (nm_ap_table_get_list (table)->data == c);
+
+	g_assert (nm_ap_table_find (table, &bssid_a, TRUE, TRUE, match_tag, "/x") == c);
+	g_assert (nm_ap_table_find (table, &bssid_a, TRUE, TRUE, match_tag, "a/x") == a);
+
+	nm_ap_table_move_to_front (table, b);
+	g_assert (nm_ap_table_get_list (table)->data == b);
+	g_assert (nm_ap_table_find (table, &bssid_a, TRUE, TRUE, match_tag, "/x") == b);
+
+	/* Strict matching without a BSSID only finds APs without one */
+	g_assert (nm_ap_table_find (table, &bssid_none, FALSE, TRUE, match_tag, "c/x") == NULL);
+	g_assert (nm_ap_table_find (table, &bssid_none, FALSE, TRUE, match_tag, "b/x") == b);
+
+	/* Fuzzy matching without a BSSID finds any of them */
+	g_assert (nm_ap_table_find (table, &bssid_none, FALSE, FALSE, match_tag, "c/x") == c);
+
+	/* Other BSSIDs never get compared */
+	g_assert (nm_ap_table_find (table, &bssid_b, TRUE, FALSE, match_tag, "a/x") == NULL);
+
+	nm_ap_table_free (table);
+}
+
+static void
+test_reindex (void)
+{
+	NMAPTable *table = nm_ap_table_new ();
+	char *a = "a/x", *b = "b/x";
+
+	nm_ap_table_prepend (table, a, "/ap/1", NULL, &bssid_none, FALSE);
+	nm_ap_table_prepend (table, b, "/ap/2", NULL, &bssid_a, TRUE);
+
+	/* A fake AP learns its BSSID after association */
+	nm_ap_table_set_bssid (table, a, &bssid_b, TRUE);
+	g_assert (nm_ap_table_find (table, &bssid_none, FALSE, TRUE, match_tag, "a/x") == NULL);
+	g_assert (nm_ap_table_find (table, &bssid_b, TRUE, TRUE, match_tag, "a/x") == a);
+
+	/* Buckets shared by several APs */
+	nm_ap_table_set_bssid (table, a, &bssid_a, TRUE);
+	g_assert (nm_ap_table_find (table, &bssid_a, TRUE, TRUE, match_tag, "a/x") == a);
+	nm_ap_table_remove (table, b);
+	g_assert (nm_ap_table_find (table, &bssid_a, TRUE, TRUE, match_tag, "/x") == a);
+	nm_ap_table_remove (table, a);
+	g_assert (nm_ap_table_find (table, &bssid_a, TRUE, TRUE, match_tag, "/x") == NULL);
+	g_assert (nm_ap_table_get_list (table) == NULL);
+
+	nm_ap_table_free (table);
+}
+
+static void
+test_last_seen (void)
+{
+	NMAPTable *table = nm_ap_table_new ();
+	char *items[] = { "a/x", "b/x", "c/x", "d/x", "e/x", "f/x" };
+	glong seen[] = { 50, 10, 40, 20, 60, 30 };
+	GSList *older;
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS (items); i++) {
+		nm_ap_table_prepend (table, items[i], NULL, NULL, &bssid_none, FALSE);
+		nm_ap_table_set_last_seen (table, items[i], seen[i]);
+	}
+
+	g_assert (nm_ap_table_get_older_than (table, 10) == NULL);
+
+	/* Oldest first */
+	older = nm_ap_table_get_older_than (table, 45);
+	g_assert_cmpint (g_slist_length (older), ==, 4);
+	g_assert (g_slist_nth_data (older, 0) == items[1]);
+	g_assert (g_slist_nth_data (older, 1) == items[3]);
+	g_assert (g_slist_nth_data (older, 2) == items[5]);
+	g_assert (g_slist_nth_data (older, 3) == items[2]);
+	g_slist_free (older);
+
+	/* Seen again, and removed */
+	nm_ap_table_set_last_seen (table, items[1], 100);
+	nm_ap_table_remove (table, items[3]);
+	older = nm_ap_table_get_older_than (table, 45);
+	g_assert_cmpint (g_slist_length (older), ==, 2);
+	g_assert (older->data == items[5]);
+	g_assert (older->next->data == items[2]);
+	g_slist_free (older);
+
+	older = nm_ap_table_get_older_than (table, 1000);
+	g_assert_cmpint (g_slist_length (older), ==, 5);
+	g_assert (g_slist_last (older)->data == items[1]);
+	g_slist_free (older);
+
+	/* Items that are not aging never show up, whatever their age */
+	nm_ap_table_set_aging (table, items[5], FALSE);
+	nm_ap_table_set_last_seen (table, items[5], 5);
+	older = nm_ap_table_get_older_than (table, 45);
+	g_assert_cmpint (g_slist_length (older), ==, 1);
+	g_assert (older->data == items[2]);
+	g_slist_free (older);
+
+	nm_ap_table_set_aging (table, items[5], TRUE);
+	older = nm_ap_table_get_older_than (table, 45);
+	g_assert_cmpint (g_slist_length (older), ==, 2);
+	g_assert (older->data == items[5]);
+	g_slist_free (older);
+
+	nm_ap_table_set_aging (table, items[0], FALSE);
+	nm_ap_table_remove (table, items[0]);
+	older = nm_ap_table_get_older_than (table, 1000);
+	g_assert_cmpint (g_slist_length (older), ==, 4);
+	g_slist_free (older);
+
+	nm_ap_table_free (table);
+}
+
+/* Scan list items; matching is on the tag, like match_tag() */
+typedef struct {
+	const char *tag;
+	char *supplicant_path;
+	struct ether_addr bssid;
+	glong last_seen;
+	gboolean removed;
+} ScanItem;
+
+static void
+scan_item_get_keys (gpointer item, NMWifiScanListKeys *keys)
+{
+	ScanItem *si = item;
+
+	keys->dbus_path = NULL;
+	keys->supplicant_path = si->supplicant_path;
+	keys->bssid = &si->bssid;
+	keys->bssid_valid = TRUE;
+	keys->last_seen = si->last_seen;
+	keys->in_supplicant = si->supplicant_path && !si->removed;
+}
+
+static gboolean
+scan_item_match (gpointer item, gpointer user_data)
+{
+	return strcmp (((ScanItem *) item)->tag, ((ScanItem *) user_data)->tag) == 0;
+}
+
+static gpointer
+scan_item_find (NMAPTable *table, gpointer scanned, gboolean strict_match)
+{
+	return nm_ap_table_find (table, &((ScanItem *) scanned)->bssid, TRUE, strict_match,
+	                         scan_item_match, scanned);
+}
+
+static void
+scan_item_update (gpointer item, gpointer scanned, gpointer user_data)
+{
+	ScanItem *found = item, *merge = scanned;
+
+	found->supplicant_path = merge->supplicant_path;
+	found->last_seen = merge->last_seen;
+	found->removed = merge->removed;
+}
+
+static gboolean
+scan_item_keep (gpointer item, gpointer user_data)
+{
+	return strcmp (((ScanItem *) item)->tag, "a") == 0;
+}
+
+static void
+scan_item_remove (gpointer item, gpointer user_data)
+{
+	nm_ap_table_remove (user_data, item);
+}
+
+static const NMWifiScanListFuncs scan_funcs = {
+	scan_item_get_keys,
+	scan_item_find,
+	scan_item_update,
+	scan_item_keep,
+	scan_item_remove
+};
+
+static void
+test_scan_list (void)
+{
+	NMAPTable *table = nm_ap_table_new ();
+	ScanItem a = { "a", "/bss/1", { { 0, 1, 2, 3, 4, 5 } }, 10, FALSE };
+	ScanItem b = { "b", NULL, { { 0, 1, 2, 3, 4, 6 } }, 10, FALSE };
+	ScanItem c = { "c", "/bss/3", { { 0, 1, 2, 3, 4, 7 } }, 10, FALSE };
+	ScanItem scanned;
+	GSList *older;
+
+	nm_wifi_scan_list_add (table, &a, &scan_funcs, table);
+	nm_wifi_scan_list_add (table, &b, &scan_funcs, table);
+	nm_wifi_scan_list_add (table, &c, &scan_funcs, table);
+
+	/* Found by supplicant path, whatever it matches */
+	scanned = a;
+	scanned.tag = "x";
+	scanned.last_seen = 20;
+	g_assert (nm_wifi_scan_list_merge (table, &scanned, TRUE, &scan_funcs, NULL) == &a);
+	g_assert_cmpint (a.last_seen, ==, 20);
+
+	/* Found by matching, and takes over the new supplicant path */
+	scanned = b;
+	scanned.supplicant_path = "/bss/2";
+	scanned.last_seen = 20;
+	g_assert (nm_wifi_scan_list_merge (table, &scanned, TRUE, &scan_funcs, NULL) == &b);
+	g_assert (nm_ap_table_lookup_supplicant_path (table, "/bss/2") == &b);
+
+	/* New */
+	scanned.tag = "d";
+	scanned.supplicant_path = "/bss/4";
+	g_assert (nm_wifi_scan_list_merge (table, &scanned, TRUE, &scan_funcs, NULL) == NULL);
+
+	/* APs known to the supplicant are not aging */
+	g_assert (nm_ap_table_get_older_than (table, 1000) == NULL);
+
+	/* Once the supplicant drops them they are culled, unless kept; kept
+	 * items don't even age.
+	 */
+	a.removed = TRUE;
+	nm_wifi_scan_list_sync (table, &a, &scan_funcs, table);
+	b.removed = TRUE;
+	nm_wifi_scan_list_sync (table, &b, &scan_funcs, table);
+	older = nm_ap_table_get_older_than (table, 1000);
+	g_assert (older && older->data == &b && !older->next);
+	g_slist_free (older);
+	g_assert_cmpint (nm_wifi_scan_list_cull (table, 15, &scan_funcs, table), ==, 0);
+	g_assert_cmpint (nm_wifi_scan_list_cull (table, 1000, &scan_funcs, table), ==, 1);
+	g_assert (nm_ap_table_lookup_supplicant_path (table, "/bss/2") == NULL);
+	g_assert_cmpint (nm_ap_table_size (table), ==, 2);
+
+	/* No longer kept, so it ages again */
+	a.tag = "y";
+	nm_wifi_scan_list_sync (table, &a, &scan_funcs, table);
+	g_assert_cmpint (nm_wifi_scan_list_cull (table, 1000, &scan_funcs, table), ==, 1);
+	g_assert_cmpint (nm_ap_table_size (table), ==, 1);
+
+	nm_ap_table_free (table);
+}
+
+int
+main (int argc, char **argv)
+{
+	g_test_init (&argc, &argv, NULL);
+
+	g_test_add_func ("/wifi-ap-table/lookup-paths", test_lookup_paths);
+	g_test_add_func ("/wifi-ap-table/find-order", test_find_order);
+	g_test_add_func ("/wifi-ap-table/reindex", test_reindex);
+	g_test_add_func ("/wifi-ap-table/last-seen", test_last_seen);
+	g_test_add_func ("/wifi-ap-table/scan-list", test_scan_list);
+
+	return g_test_run ();
+}
@@ -0,0 +1,103 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2012 Red Hat, Inc.
+ *
+ */
+
+#include <string.h>
+
+#include "wifi-bench-fixture.h"
+
+char *
+fake_bss_path (guint bss)
+{
+	return g_strdup_printf ("/fi/w1/wpa_supplicant1/Interfaces/0/BSSs/%u", bss);
+}
+
+FakeAP *
+fake_ap_new (guint bss, guint n_ssids)
+{
+	FakeAP *ap = g_new0 (FakeAP, 1);
+
+	ap->ssid = bss % n_ssids;
+	ap->bssid.ether_addr_octet[0] = 0x00;
+	ap->bssid.ether_addr_octet[1] = 0x1b;
+	ap->bssid.ether_addr_octet[2] = 0x2c;
+	ap->bssid.ether_addr_octet[3] = (bss >> 16) & 0xFF;
+	ap->bssid.ether_addr_octet[4] = (bss >> 8) & 0xFF;
+	ap->bssid.ether_addr_octet[5] = bss & 0xFF;
+	ap->bssid_valid = TRUE;
+	ap->freq = (bss % 2) ? 2412 + 5 * (bss % 11) : 5180 + 20 * (bss % 8);
+	ap->supplicant_path = fake_bss_path (bss);
+	return ap;
+}
+
+void
+fake_ap_free (FakeAP *ap)
+{
+	g_free (ap->supplicant_path);
+	g_free (ap->dbus_path);
+	g_free (ap);
+}
+
+gboolean
+fake_ap_matches (FakeAP *list_ap, FakeAP *find_ap, gboolean strict_match)
+{
+	if (list_ap->ssid != find_ap->ssid)
+		return FALSE;
+	if (   (strict_match || find_ap->bssid_valid)
+	    && list_ap->bssid_valid
+	    && memcmp (&list_ap->bssid, &find_ap->bssid, ETH_ALEN) != 0)
+		return FALSE;
+	return list_ap->freq == find_ap->freq;
+}
+
+void
+fake_ap_get_keys (gpointer item, NMWifiScanListKeys *keys)
+{
+	FakeAP *ap = item;
+
+	keys->dbus_path = ap->dbus_path;
+	keys->supplicant_path = ap->supplicant_path;
+	keys->bssid = &ap->bssid;
+	keys->bssid_valid = ap->bssid_valid;
+	keys->last_seen = ap->last_seen;
+	keys->in_supplicant = ap->supplicant_path && !ap->removed;
+}
+
+typedef struct {
+	FakeAP *find;
+	gboolean strict;
+} MatchInfo;
+
+static gboolean
+match_func (gpointer item, gpointer user_data)
+{
+	MatchInfo *info = user_data;
+
+	return fake_ap_matches (item, info->find, info->strict);
+}
+
+gpointer
+fake_ap_find (NMAPTable *table, gpointer scanned, gboolean strict_match)
+{
+	FakeAP *find = scanned;
+	MatchInfo info = { find, strict_match };
+
+	return nm_ap_table_find (table, &find->bssid, find->bssid_valid, strict_match,
+	                         match_func, &info);
+}
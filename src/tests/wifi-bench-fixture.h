@@ -0,0 +1,59 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Copyright (C) 2012 Red Hat, Inc.
+ *
+ */
+
+#ifndef WIFI_BENCH_FIXTURE_H
+#define WIFI_BENCH_FIXTURE_H
+
+#include <glib.h>
+
+#include "nm-wifi-ap-table.h"
+#include "nm-wifi-scan-list.h"
+
+/* Stands in for NMAccessPoint in the wifi benchmarks */
+typedef struct {
+	guint ssid;
+	struct ether_addr bssid;
+	gboolean bssid_valid;
+	guint32 freq;
+	char *supplicant_path;
+	char *dbus_path;
+	glong last_seen;
+	gboolean removed;  /* WPAS_REMOVED_TAG */
+} FakeAP;
+
+/* The supplicant's object path for BSS number @bss */
+char *   fake_bss_path    (guint bss);
+
+/* Dense deployment: @n_ssids SSIDs spread over many BSSIDs, across both
+ * bands.  The AP has a valid BSSID and the supplicant path of @bss, but no
+ * D-Bus path.
+ */
+FakeAP * fake_ap_new      (guint bss, guint n_ssids);
+
+void     fake_ap_free     (FakeAP *ap);
+
+/* Mirrors the matching of nm_ap_match_in_table() */
+gboolean fake_ap_matches  (FakeAP *list_ap, FakeAP *find_ap, gboolean strict_match);
+
+/* For NMWifiScanListFuncs */
+void     fake_ap_get_keys (gpointer item, NMWifiScanListKeys *keys);
+gpointer fake_ap_find     (NMAPTable *table, gpointer scanned, gboolean strict_match);
+
+#endif /* WIFI_BENCH_FIXTURE_H */
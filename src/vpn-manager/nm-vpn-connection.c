@@ -1618,7 +1618,7 @@ nm_vpn_connection_class_init (NMVPNConnectionClass *connection_class)
 		              _nm_marshal_VOID__UINT_UINT_UINT,
 		              G_TYPE_NONE, 3, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT);
 
-	dbus_g_object_type_install_info (G_TYPE_FROM_CLASS (object_class),
-	                                 &dbus_glib_nm_vpn_connection_object_info);
+	nm_properties_changed_signal_install_info (G_OBJECT_CLASS (object_class),
+	                                           &dbus_glib_nm_vpn_connection_object_info);
 }
 
@@ -27,13 +27,13 @@
 #include <net/ethernet.h>
 #include <unistd.h>
 #include <math.h>
+#include <net/if.h>
 
 #include <glib.h>
 
 #include <netlink/genl/genl.h>
 #include <netlink/genl/family.h>
 #include <netlink/genl/ctrl.h>
-#include <netlink/route/link.h>
 
 #include <linux/nl80211.h>
 
@@ -42,13 +42,28 @@
 #include "nm-logging.h"
 #include "nm-utils.h"
 
+/* Connection quality monitor: report RSSI changes larger than this, in dB */
+#define CQM_RSSI_HYST_DB      4
+/* Threshold used when the current signal isn't known */
+#define CQM_RSSI_DEFAULT_DBM  -70
+
 typedef struct {
 	WifiData parent;
 	struct nl_sock *nl_sock;
 	int id;
 	struct nl_cb *nl_cb;
+	struct nl_msg *msg;   /* Reused for every request */
 	guint32 *freqs;
 	int num_freqs;
+
+	/* Link change monitoring */
+	struct nl_sock *nl_event;
+	GIOChannel *event_channel;
+	guint event_id;
+	gboolean cqm_event;
+	gboolean station_event;
+	WifiLinkChangedFunc link_changed;
+	gpointer link_changed_data;
 } WifiDataNl80211;
 
 static int ack_handler (struct nl_msg *msg, void *arg)
@@ -90,10 +105,37 @@ _nl80211_alloc_msg (int id, int ifindex, guint32 cmd, guint32 flags)
 	return NULL;
 }
 
+/* The generic netlink family id only changes if cfg80211 is reloaded */
+static int
+nl80211_family_id (struct nl_sock *nl_sock, gboolean refresh)
+{
+	static int id = -1;
+
+	if (id < 0 || refresh)
+		id = genl_ctrl_resolve (nl_sock, "nl80211");
+	return id;
+}
+
+/* Requests are strictly sequential, so one message buffer serves them all.
+ * The WifiData keeps its own reference; the one handed out is dropped when
+ * the message is consumed, as with a freshly allocated message.
+ */
 static struct nl_msg *
 nl80211_alloc_msg (WifiDataNl80211 *nl80211, guint32 cmd, guint32 flags)
 {
-	return _nl80211_alloc_msg (nl80211->id, nl80211->parent.ifindex, cmd, flags);
+	struct nl_msg *msg = nl80211->msg;
+
+	if (!msg)
+		return _nl80211_alloc_msg (nl80211->id, nl80211->parent.ifindex, cmd, flags);
+
+	nlmsg_hdr (msg)->nlmsg_len = NLMSG_HDRLEN;
+	if (!genlmsg_put (msg, 0, 0, nl80211->id, 0, flags, cmd, 0))
+		return NULL;
+	if (nla_put_u32 (msg, NL80211_ATTR_IFINDEX, nl80211->parent.ifindex) < 0)
+		return NULL;
+
+	nlmsg_get (msg);
+	return msg;
 }
 
 /* NOTE: this function consumes 'msg' */
@@ -104,27 +146,26 @@ _nl80211_send_and_recv (struct nl_sock *nl_sock,
                         int (*valid_handler)(struct nl_msg *, void *),
                         void *valid_data)
 {
-	struct nl_cb *cb;
+	struct nl_cb *cb = nl_cb;
 	int err, done;
 
 	g_return_val_if_fail (msg != NULL, -ENOMEM);
 
-	cb = nl_cb_clone (nl_cb);
-	if (!cb) {
-		err = -ENOMEM;
-		goto out;
-	}
-
 	err = nl_send_auto_complete (nl_sock, msg);
 	if (err < 0)
 		goto out;
 
+	/* The callbacks are private to the caller; set them up for this
+	 * request instead of cloning them.
+	 */
 	done = 0;
 	nl_cb_err (cb, NL_CB_CUSTOM, error_handler, &done);
 	nl_cb_set (cb, NL_CB_FINISH, NL_CB_CUSTOM, finish_handler, &done);
 	nl_cb_set (cb, NL_CB_ACK, NL_CB_CUSTOM, ack_handler, &done);
 	if (valid_handler)
 		nl_cb_set (cb, NL_CB_VALID, NL_CB_CUSTOM, valid_handler, valid_data);
+	else
+		nl_cb_set (cb, NL_CB_VALID, NL_CB_DEFAULT, NULL, NULL);
 
 	/* Loop until one of our NL callbacks says we're done; on success
 	 * done will be 1, on error it will be < 0.
@@ -141,7 +182,6 @@ _nl80211_send_and_recv (struct nl_sock *nl_sock,
 		err = done;
 
  out:
-	nl_cb_put (cb);
 	nlmsg_free (msg);
 	return err;
 }
@@ -155,11 +195,16 @@ nl80211_send_and_recv (WifiDataNl80211 *nl80211,
 	return _nl80211_send_and_recv (nl80211->nl_sock, nl80211->nl_cb, msg, valid_handler, valid_data);
 }
 
+static void wifi_nl80211_unmonitor_link (WifiData *data);
+
 static void
 wifi_nl80211_deinit (WifiData *parent)
 {
 	WifiDataNl80211 *nl80211 = (WifiDataNl80211 *) parent;
 
+	wifi_nl80211_unmonitor_link (parent);
+	if (nl80211->msg)
+		nlmsg_free (nl80211->msg);
 	if (nl80211->nl_sock)
 		nl_socket_free (nl80211->nl_sock);
 	if (nl80211->nl_cb)
@@ -435,9 +480,11 @@ wifi_nl80211_get_bssid (WifiData *data, struct ether_addr *out_bssid)
 }
 
 struct nl80211_station_info {
+	guint num_stations;
 	guint32 txrate;
 	gboolean txrate_valid;
 	guint8 signal;
+	gint32 signal_dbm;
 	gboolean signal_valid;
 };
 
@@ -480,6 +527,16 @@ static int nl80211_station_handler (struct nl_msg *msg, void *arg)
 			      stats_policy))
 		return NL_SKIP;
 
+	/* A dump returns one message per station */
+	if (info->num_stations++ > 0)
+		return NL_SKIP;
+
+	if (sinfo[NL80211_STA_INFO_SIGNAL] != NULL) {
+		info->signal_dbm = (gint8) nla_get_u8 (sinfo[NL80211_STA_INFO_SIGNAL]);
+		info->signal = nl80211_xbm_to_percent (info->signal_dbm, 1);
+		info->signal_valid = TRUE;
+	}
+
 	if (sinfo[NL80211_STA_INFO_TX_BITRATE] == NULL)
 		return NL_SKIP;
 
@@ -495,11 +552,6 @@ static int nl80211_station_handler (struct nl_msg *msg, void *arg)
 	info->txrate = nla_get_u16 (rinfo[NL80211_RATE_INFO_BITRATE]) * 100;
 	info->txrate_valid = TRUE;
 
-	if (sinfo[NL80211_STA_INFO_SIGNAL] != NULL) {
-		info->signal = nl80211_xbm_to_percent ((gint8) nla_get_u8 (sinfo[NL80211_STA_INFO_SIGNAL]), 1);
-		info->signal_valid = TRUE;
-	}
-
 	return NL_SKIP;
 }
 
@@ -511,6 +563,18 @@ static void nl80211_get_ap_info (WifiDataNl80211 *nl80211,
 
 	memset(sta_info, 0, sizeof(*sta_info));
 
+	/* A managed interface has exactly one station, the AP, so a station
+	 * dump answers in one request without going through the scan list.
+	 */
+	msg = nl80211_alloc_msg (nl80211, NL80211_CMD_GET_STATION, NLM_F_DUMP);
+	if (msg) {
+		nl80211_send_and_recv (nl80211, msg, nl80211_station_handler, sta_info);
+		if (sta_info->num_stations == 1 && sta_info->signal_valid)
+			return;
+	}
+
+	/* IBSS peers, or no signal from the driver: ask about the BSS */
+	memset(sta_info, 0, sizeof(*sta_info));
 	nl80211_get_bss_info (nl80211, &bss_info);
 	if (!bss_info.valid)
 		return;
@@ -554,6 +618,204 @@ wifi_nl80211_get_qual (WifiData *data)
 	return sta_info.signal;
 }
 
+static gboolean
+wifi_nl80211_get_link (WifiData *data, int *out_qual, guint32 *out_rate)
+{
+	WifiDataNl80211 *nl80211 = (WifiDataNl80211 *) data;
+	struct nl80211_station_info sta_info;
+
+	nl80211_get_ap_info (nl80211, &sta_info);
+	*out_qual = sta_info.signal;
+	*out_rate = sta_info.txrate;
+	return TRUE;
+}
+
+/* Link change monitoring.  The driver's connection quality monitor reports
+ * when the RSSI moves away from a threshold by more than the hysteresis;
+ * the threshold is moved to the current RSSI after every report, so each
+ * report means the signal changed by CQM_RSSI_HYST_DB or more.  Association
+ * changes come in on the same "mlme" multicast group.
+ */
+
+static gboolean
+nl80211_set_cqm (WifiDataNl80211 *nl80211, gint32 thold_dbm)
+{
+	struct nl_msg *msg;
+	struct nlattr *cqm;
+
+	msg = nl80211_alloc_msg (nl80211, NL80211_CMD_SET_CQM, 0);
+	if (!msg)
+		return FALSE;
+
+	cqm = nla_nest_start (msg, NL80211_ATTR_CQM);
+	if (!cqm)
+		goto nla_put_failure;
+	NLA_PUT_U32 (msg, NL80211_ATTR_CQM_RSSI_THOLD, (guint32) thold_dbm);
+	NLA_PUT_U32 (msg, NL80211_ATTR_CQM_RSSI_HYST, CQM_RSSI_HYST_DB);
+	nla_nest_end (msg, cqm);
+
+	return nl80211_send_and_recv (nl80211, msg, NULL, NULL) == 0;
+
+ nla_put_failure:
+	nlmsg_free (msg);
+	return FALSE;
+}
+
+static gboolean
+nl80211_rearm_cqm (WifiDataNl80211 *nl80211)
+{
+	struct nl80211_station_info sta_info;
+
+	nl80211_get_ap_info (nl80211, &sta_info);
+	return nl80211_set_cqm (nl80211,
+	                       sta_info.signal_valid ? sta_info.signal_dbm : CQM_RSSI_DEFAULT_DBM);
+}
+
+static int
+nl80211_event_handler (struct nl_msg *msg, void *arg)
+{
+	WifiDataNl80211 *nl80211 = arg;
+	struct genlmsghdr *gnlh = nlmsg_data (nlmsg_hdr (msg));
+	struct nlattr *tb[NL80211_ATTR_MAX + 1];
+
+	if (nla_parse (tb, NL80211_ATTR_MAX, genlmsg_attrdata (gnlh, 0),
+		       genlmsg_attrlen (gnlh, 0), NULL) < 0)
+		return NL_SKIP;
+
+	/* Events for all wifi interfaces arrive here */
+	if (   !tb[NL80211_ATTR_IFINDEX]
+	    || nla_get_u32 (tb[NL80211_ATTR_IFINDEX]) != nl80211->parent.ifindex)
+		return NL_SKIP;
+
+	switch (gnlh->cmd) {
+	case NL80211_CMD_NOTIFY_CQM:
+		nl80211->cqm_event = TRUE;
+		break;
+	case NL80211_CMD_CONNECT:
+	case NL80211_CMD_ROAM:
+	case NL80211_CMD_DISCONNECT:
+	case NL80211_CMD_NEW_STATION:
+	case NL80211_CMD_DEL_STATION:
+		nl80211->station_event = TRUE;
+		break;
+	default:
+		break;
+	}
+
+	return NL_SKIP;
+}
+
+static gboolean
+nl80211_event_cb (GIOChannel *channel, GIOCondition condition, gpointer user_data)
+{
+	WifiDataNl80211 *nl80211 = user_data;
+	int err;
+
+	if (condition & (G_IO_ERR | G_IO_HUP | G_IO_NVAL)) {
+		nm_log_warn (LOGD_WIFI, "(%s): lost nl80211 event socket; link changes are no longer monitored",
+		             nl80211->parent.iface);
+		nl80211->event_id = 0;
+		return FALSE;
+	}
+
+	nl80211->cqm_event = nl80211->station_event = FALSE;
+	err = nl_recvmsgs_default (nl80211->nl_event);
+	if (err < 0 && err != -NLE_AGAIN) {
+		nm_log_dbg (LOGD_WIFI, "(%s): error processing nl80211 events: (%d) %s",
+		            nl80211->parent.iface, err, nl_geterror (err));
+	}
+
+	if (nl80211->cqm_event || nl80211->station_event) {
+		/* Report again once the signal moves on from here */
+		nl80211_rearm_cqm (nl80211);
+		nl80211->link_changed (nl80211->link_changed_data);
+	}
+
+	return TRUE;
+}
+
+static gboolean
+wifi_nl80211_monitor_link (WifiData *data, WifiLinkChangedFunc callback, gpointer user_data)
+{
+	WifiDataNl80211 *nl80211 = (WifiDataNl80211 *) data;
+	int group, err;
+
+	g_return_val_if_fail (nl80211->nl_event == NULL, FALSE);
+
+	/* Fails if the driver has no connection quality monitor */
+	if (!nl80211_rearm_cqm (nl80211)) {
+		nm_log_dbg (LOGD_WIFI, "(%s): driver doesn't support connection quality monitoring",
+		            data->iface);
+		return FALSE;
+	}
+
+	nl80211->nl_event = nl_socket_alloc ();
+	if (!nl80211->nl_event)
+		goto error;
+
+	nl_socket_disable_seq_check (nl80211->nl_event);
+	nl_socket_modify_cb (nl80211->nl_event, NL_CB_VALID, NL_CB_CUSTOM,
+	                     nl80211_event_handler, nl80211);
+
+	if (genl_connect (nl80211->nl_event))
+		goto error;
+
+	group = genl_ctrl_resolve_grp (nl80211->nl_event, "nl80211", "mlme");
+	if (group < 0)
+		goto error;
+
+	err = nl_socket_add_membership (nl80211->nl_event, group);
+	if (err < 0)
+		goto error;
+
+	err = nl_socket_set_nonblocking (nl80211->nl_event);
+	if (err < 0)
+		goto error;
+
+	nl80211->link_changed = callback;
+	nl80211->link_changed_data = user_data;
+
+	nl80211->event_channel = g_io_channel_unix_new (nl_socket_get_fd (nl80211->nl_event));
+	g_io_channel_set_encoding (nl80211->event_channel, NULL, NULL);
+	nl80211->event_id = g_io_add_watch (nl80211->event_channel,
+	                                    G_IO_IN | G_IO_ERR | G_IO_HUP | G_IO_NVAL,
+	                                    nl80211_event_cb,
+	                                    nl80211);
+
+	nm_log_dbg (LOGD_WIFI, "(%s): monitoring link changes via nl80211",
+	            data->iface);
+	return TRUE;
+
+error:
+	nm_log_warn (LOGD_WIFI, "(%s): failed to set up nl80211 event socket", data->iface);
+	wifi_nl80211_unmonitor_link (data);
+	return FALSE;
+}
+
+static void
+wifi_nl80211_unmonitor_link (WifiData *data)
+{
+	WifiDataNl80211 *nl80211 = (WifiDataNl80211 *) data;
+
+	if (nl80211->event_id) {
+		g_source_remove (nl80211->event_id);
+		nl80211->event_id = 0;
+	}
+	if (nl80211->event_channel) {
+		g_io_channel_unref (nl80211->event_channel);
+		nl80211->event_channel = NULL;
+	}
+	if (nl80211->nl_event) {
+		nl_socket_free (nl80211->nl_event);
+		nl80211->nl_event = NULL;
+
+		/* Turn the connection quality monitor off again */
+		nl80211_set_cqm (nl80211, 0);
+	}
+	nl80211->link_changed = NULL;
+	nl80211->link_changed_data = NULL;
+}
+
 struct nl80211_device_info {
 	guint32 *freqs;
 	int num_freqs;
@@ -728,6 +990,9 @@ wifi_nl80211_init (const char *iface, int ifindex)
 	nl80211->parent.get_bssid = wifi_nl80211_get_bssid;
 	nl80211->parent.get_rate = wifi_nl80211_get_rate;
 	nl80211->parent.get_qual = wifi_nl80211_get_qual;
+	nl80211->parent.get_link = wifi_nl80211_get_link;
+	nl80211->parent.monitor_link = wifi_nl80211_monitor_link;
+	nl80211->parent.unmonitor_link = wifi_nl80211_unmonitor_link;
 	nl80211->parent.deinit = wifi_nl80211_deinit;
 
 	nl80211->nl_sock = nl_socket_alloc ();
@@ -737,7 +1002,7 @@ wifi_nl80211_init (const char *iface, int ifindex)
 	if (genl_connect (nl80211->nl_sock))
 		goto error;
 
-	nl80211->id = genl_ctrl_resolve (nl80211->nl_sock, "nl80211");
+	nl80211->id = nl80211_family_id (nl80211->nl_sock, TRUE);
 	if (nl80211->id < 0)
 		goto error;
 
@@ -745,6 +1010,10 @@ wifi_nl80211_init (const char *iface, int ifindex)
 	if (nl80211->nl_cb == NULL)
 		goto error;
 
+	nl80211->msg = nlmsg_alloc ();
+	if (nl80211->msg == NULL)
+		goto error;
+
 	msg = nl80211_alloc_msg (nl80211, NL80211_CMD_GET_WIPHY, 0);
 
 	if (nl80211_send_and_recv (nl80211, msg, nl80211_wiphy_info_handler,
@@ -806,34 +1075,13 @@ error:
 	return NULL;
 }
 
-static int
-iface_to_index (struct nl_sock *nl_sock, const char *iface)
-{
-	struct nl_cache *link_cache = NULL;
-	int err, ifindex;
-
-	/* name to index */
-	err = rtnl_link_alloc_cache (nl_sock, AF_UNSPEC, &link_cache);
-	if (err < 0) {
-		nm_log_warn (LOGD_HW, "failed to allocate link cache: (%d) %s",
-		             err, nl_geterror (err));
-		return -1;
-	}
-	nl_cache_mngt_provide (link_cache);
-	nl_cache_refill (nl_sock, link_cache);
-	ifindex = rtnl_link_name2i (link_cache, iface);
-	nl_cache_free (link_cache);
-
-	return ifindex;
-}
-
 gboolean
 wifi_nl80211_is_wifi (const char *iface)
 {
 	struct nl_sock *nl_sock;
 	struct nl_cb *nl_cb = NULL;
 	struct nl_msg *msg = NULL;
-	int id, ifindex;
+	int id, ifindex, err;
 	struct nl80211_iface_info iface_info = {
 		.mode = NM_802_11_MODE_UNKNOWN,
 	};
@@ -846,22 +1094,35 @@ wifi_nl80211_is_wifi (const char *iface)
 	if (genl_connect (nl_sock))
 		goto error;
 
-	ifindex = iface_to_index (nl_sock, iface);
-	if (ifindex < 0)
+	ifindex = if_nametoindex (iface);
+	if (ifindex <= 0)
 		goto error;
 
-	id = genl_ctrl_resolve (nl_sock, "nl80211");
+	id = nl80211_family_id (nl_sock, FALSE);
 	if (id < 0)
 		goto error;
 
 	nl_cb = nl_cb_alloc (NL_CB_DEFAULT);
 	if (nl_cb) {
 		msg = _nl80211_alloc_msg (id, ifindex, NL80211_CMD_GET_INTERFACE, 0);
-		if (_nl80211_send_and_recv (nl_sock,
-			                        nl_cb,
-			                        msg,
-			                        nl80211_iface_info_handler,
-			                        &iface_info) >= 0)
+		err = _nl80211_send_and_recv (nl_sock,
+		                              nl_cb,
+		                              msg,
+		                              nl80211_iface_info_handler,
+		                              &iface_info);
+		if (err == -NLE_OBJ_NOTFOUND || err == -EINVAL) {
+			/* Family id may be stale */
+			id = nl80211_family_id (nl_sock, TRUE);
+			if (id >= 0) {
+				msg = _nl80211_alloc_msg (id, ifindex, NL80211_CMD_GET_INTERFACE, 0);
+				err = _nl80211_send_and_recv (nl_sock,
+				                              nl_cb,
+				                              msg,
+				                              nl80211_iface_info_handler,
+				                              &iface_info);
+			}
+		}
+		if (err >= 0)
 			is_wifi = (iface_info.mode != NM_802_11_MODE_UNKNOWN);
 	}
 
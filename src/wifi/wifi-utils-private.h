@@ -55,6 +55,14 @@ struct WifiData {
 	 */
 	int (*get_qual) (WifiData *data);
 
+	/* Optional; quality and bitrate of the current BSS in one request */
+	gboolean (*get_link) (WifiData *data, int *out_qual, guint32 *out_rate);
+
+	/* Optional; return FALSE if link changes can't be monitored */
+	gboolean (*monitor_link) (WifiData *data, WifiLinkChangedFunc callback, gpointer user_data);
+
+	void (*unmonitor_link) (WifiData *data);
+
 	void (*deinit) (WifiData *data);
 
 	/* OLPC Mesh-only functions */
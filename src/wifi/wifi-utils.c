@@ -150,6 +150,38 @@ wifi_utils_get_qual (WifiData *data)
 	return data->get_qual (data);
 }
 
+void
+wifi_utils_get_link (WifiData *data, int *out_qual, guint32 *out_rate)
+{
+	g_return_if_fail (data != NULL);
+	g_return_if_fail (out_qual != NULL);
+	g_return_if_fail (out_rate != NULL);
+
+	if (data->get_link && data->get_link (data, out_qual, out_rate))
+		return;
+
+	*out_qual = data->get_qual (data);
+	*out_rate = data->get_rate (data);
+}
+
+gboolean
+wifi_utils_monitor_link (WifiData *data, WifiLinkChangedFunc callback, gpointer user_data)
+{
+	g_return_val_if_fail (data != NULL, FALSE);
+	g_return_val_if_fail (callback != NULL, FALSE);
+
+	return data->monitor_link ? data->monitor_link (data, callback, user_data) : FALSE;
+}
+
+void
+wifi_utils_unmonitor_link (WifiData *data)
+{
+	g_return_if_fail (data != NULL);
+
+	if (data->unmonitor_link)
+		data->unmonitor_link (data);
+}
+
 void
 wifi_utils_deinit (WifiData *data)
 {
@@ -61,6 +61,23 @@ guint32 wifi_utils_get_rate (WifiData *data);
 /* Returns quality 0 - 100% on succes, or -1 on error */
 int wifi_utils_get_qual (WifiData *data);
 
+/* Same as wifi_utils_get_qual() and wifi_utils_get_rate(), but in one
+ * request where the driver interface allows it.
+ */
+void wifi_utils_get_link (WifiData *data, int *out_qual, guint32 *out_rate);
+
+typedef void (*WifiLinkChangedFunc) (gpointer user_data);
+
+/* Calls @callback when the signal strength changes noticeably or the
+ * station associates, roams or disconnects.  Returns FALSE if the driver
+ * can't report these, in which case the caller has to poll.
+ */
+gboolean wifi_utils_monitor_link (WifiData *data,
+                                  WifiLinkChangedFunc callback,
+                                  gpointer user_data);
+
+void wifi_utils_unmonitor_link (WifiData *data);
+
 
 /* OLPC Mesh-only functions */
 guint32 wifi_utils_get_mesh_channel (WifiData *data);
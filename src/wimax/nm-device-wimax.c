@@ -37,6 +37,7 @@
 #include "nm-system.h"
 #include "NetworkManagerUtils.h"
 #include "nm-properties-changed-signal.h"
+#include "nm-dbus-glib-types.h"
 #include "nm-connection.h"
 #include "nm-setting-connection.h"
 #include "nm-setting-wimax.h"
@@ -182,6 +183,20 @@ impl_device_get_nsp_list (NMDeviceWimax *self, GPtrArray **nsps, GError **error)
 	return TRUE;
 }
 
+static void
+add_snapshot_properties (NMDevice *device, GHashTable *props)
+{
+	GValue *value;
+	GPtrArray *nsps = NULL;
+
+	impl_device_get_nsp_list (NM_DEVICE_WIMAX (device), &nsps, NULL);
+
+	value = g_slice_new0 (GValue);
+	g_value_init (value, DBUS_TYPE_G_ARRAY_OF_OBJECT_PATH);
+	g_value_take_boxed (value, nsps);
+	g_hash_table_insert (props, g_strdup ("NspList"), value);
+}
+
 static void
 set_current_nsp (NMDeviceWimax *self, NMWimaxNsp *new_nsp)
 {
@@ -1496,6 +1511,7 @@ nm_device_wimax_class_init (NMDeviceWimaxClass *klass)
 	device_class->act_stage1_prepare = act_stage1_prepare;
 	device_class->act_stage2_config = act_stage2_config;
 	device_class->deactivate = deactivate;
+	device_class->add_snapshot_properties = add_snapshot_properties;
 	device_class->set_enabled = set_enabled;
 	device_class->hwaddr_matches = hwaddr_matches;
 
@@ -1582,8 +1598,8 @@ nm_device_wimax_class_init (NMDeviceWimaxClass *klass)
 		nm_properties_changed_signal_new (object_class, G_STRUCT_OFFSET (NMDeviceWimaxClass, properties_changed));
 
 
-	dbus_g_object_type_install_info (G_TYPE_FROM_CLASS (klass),
-									 &dbus_glib_nm_device_wimax_object_info);
+	nm_properties_changed_signal_install_info (G_OBJECT_CLASS (klass),
+	                                           &dbus_glib_nm_device_wimax_object_info);
 
 	dbus_g_error_domain_register (NM_WIMAX_ERROR, NULL, NM_TYPE_WIMAX_ERROR);
 }
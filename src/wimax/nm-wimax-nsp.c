@@ -260,6 +260,6 @@ nm_wimax_nsp_class_init (NMWimaxNspClass *klass)
 		nm_properties_changed_signal_new (object_class,
 										  G_STRUCT_OFFSET (NMWimaxNspClass, properties_changed));
 
-	dbus_g_object_type_install_info (G_TYPE_FROM_CLASS (klass),
-							   &dbus_glib_nm_wimax_nsp_object_info);
+	nm_properties_changed_signal_install_info (G_OBJECT_CLASS (klass),
+	                                           &dbus_glib_nm_wimax_nsp_object_info);
 }